@@ -11,6 +11,7 @@
 #include "appinterface.hpp"
 #include "config.h"
 
+#include <algorithm>
 #include <iostream>
 
 
@@ -23,6 +24,7 @@ Interface::Interface(
     , core{nullptr}
     , scriptRunning{false}
     , stopRequested{false}
+    , dataQueue{nullptr}
 {
 }
 
@@ -45,6 +47,27 @@ Interface::setError(bool status)
 }
 
 
+/**
+ * @brief Set the queue that data to be written to the data file is pushed onto. The data manager
+ * drains it on its own thread, so the writes never go through the application thread's event loop.
+ * 
+ * @param queue 
+ */
+void
+Interface::setDataQueue(DataQueue* queue)
+{
+    this->dataQueue = queue;
+}
+
+
+void
+Interface::queueWrite(DataWrite&& data)
+{
+    if (this->dataQueue)
+        this->dataQueue->push(std::move(data));
+}
+
+
 #define CHECK_APP_ERROR \
 if (this->error) { \
     PyErr_SetString(PyExc_SystemError, "runtime application error"); \
@@ -90,7 +113,10 @@ Interface::init(
         Qt::QueuedConnection
     );
     emit this->module_init(params, plots);
+    // the script's other threads may run while the app sets up the plots
+    Py_BEGIN_ALLOW_THREADS
     waitLoop.exec();
+    Py_END_ALLOW_THREADS
 
     if (!plotArrangementIsValid) {
         PyErr_SetString(PyExc_ValueError, "invalid plot arrangement");
@@ -132,22 +158,83 @@ Interface::datafile(const exa::DatafileConfig& config, PyObject* path, bool prom
 }
 
 
+/**
+ * @brief Start the next segment of the data file. Queued with the data, so everything written
+ * before the call goes to the current segment.
+ * 
+ * @return PyObject* 
+ */
+PyObject*
+Interface::rotateDatafile()
+{
+    CHECK_RUN_ONLY
+
+    this->queueWrite(DataWrite{DataWrite::ROTATE});
+    Py_RETURN_NONE;
+}
+
+
 PyObject*
 Interface::plot2D(std::size_t plotID, double x, double y, bool write)
 {
     CHECK_RUN_ONLY
 
-    emit this->module_plot2D(plotID - 1, x, y, write);
+    if (write) {
+        DataWrite data{DataWrite::TWODIMEN, plotID - 1};
+        data.x = x;
+        data.y = y;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plot2D(plotID - 1, x, y);
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+Interface::plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write, bool sorted)
+{
+    CHECK_RUN_ONLY
+
+    if (write) {
+        DataWrite data{DataWrite::TWODIMEN_VEC, plotID - 1};
+        data.xs = x;
+        data.ys = y;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plot2DVec(plotID - 1, x, y, sorted);
     Py_RETURN_NONE;
 }
 
 
 PyObject*
-Interface::plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write)
+Interface::plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y, bool write, bool sorted)
 {
     CHECK_RUN_ONLY
 
-    emit this->module_plot2DVec(plotID - 1, x, y, write);
+    if (write) {
+        DataWrite data{DataWrite::TWODIMEN_MULTI, plotID - 1};
+        data.xs = x;
+        data.traces = y;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plot2DMulti(plotID - 1, x, y, sorted);
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+Interface::plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx, bool write)
+{
+    CHECK_RUN_ONLY
+
+    if (write) {
+        DataWrite data{DataWrite::TWODIMEN_STREAM, plotID - 1};
+        data.x = x0;
+        data.y = dx;
+        data.ys = y;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plot2DStream(plotID - 1, y, x0, dx);
     Py_RETURN_NONE;
 }
 
@@ -166,7 +253,14 @@ Interface::plotCM(std::size_t plotID, int col, int row, double value, bool write
         PyErr_SetString(PyExc_ValueError, EXA_PLOT "() 'row' argument out of bounds");
         return NULL;
     }
-    emit this->module_plotCM(plotID - 1, col, row, value, write);
+    if (write) {
+        DataWrite data{DataWrite::COLORMAP, plotID - 1};
+        data.col = col;
+        data.row = row;
+        data.x = value;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plotCM(plotID - 1, col, row, value);
     Py_RETURN_NONE;
 }
 
@@ -185,7 +279,13 @@ Interface::plotCMVec(std::size_t plotID, int row, const std::vector<double>& val
         PyErr_SetString(PyExc_ValueError, EXA_PLOT "() 'values' argument contains too many values");
         return NULL;
     }
-    emit this->module_plotCMVec(plotID - 1, row, values, write);
+    if (write) {
+        DataWrite data{DataWrite::COLORMAP_VEC, plotID - 1};
+        data.row = row;
+        data.ys = values;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plotCMVec(plotID - 1, row, values);
     Py_RETURN_NONE;
 }
 
@@ -208,7 +308,180 @@ Interface::plotCMFrame(std::size_t plotID, const std::vector<std::vector<double>
         }
         i += 1;
     }
-    emit this->module_plotCMFrame(plotID - 1, frame, write);
+    if (write) {
+        DataWrite data{DataWrite::COLORMAP_FRAME, plotID - 1};
+        data.traces = frame;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plotCMFrame(plotID - 1, frame);
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+Interface::plotCMPush(std::size_t plotID, const std::vector<double>& values, bool write)
+{
+    CHECK_RUN_ONLY
+
+    auto plot = this->plots.at(plotID - 1);
+    if (!plot.attributes.colorMap.waterfall) {
+        PyErr_SetString(PyExc_ValueError, EXA_PLOT "() pushing a row requires waterfall mode ('color_map.waterfall')");
+        return NULL;
+    }
+    if (values.size() > static_cast<std::size_t>(plot.attributes.colorMap.dataSize.x)) {
+        PyErr_SetString(PyExc_ValueError, EXA_PLOT "() 'values' argument contains too many values");
+        return NULL;
+    }
+    if (write) {
+        DataWrite data{DataWrite::COLORMAP_PUSH, plotID - 1};
+        data.ys = values;
+        this->queueWrite(std::move(data));
+    }
+    emit this->module_plotCMPush(plotID - 1, values);
+    Py_RETURN_NONE;
+}
+
+
+/**
+ * @brief Get the ID of a named data-only channel, creating the channel (in the data file) the first
+ * time it's used in a run. Channel 0 (the "hidden plot") always exists.
+ * 
+ * @param name 
+ * @return PyObject* 
+ */
+PyObject*
+Interface::channel(const std::string& name)
+{
+    CHECK_RUN_ONLY
+
+    auto it = this->channels.find(name);
+    if (it == this->channels.end()) {
+        it = this->channels.emplace(name, this->channels.size() + 1).first;
+        DataWrite data{DataWrite::CHANNEL, it->second, true};
+        data.name = name;
+        this->queueWrite(std::move(data));
+    }
+    return PyLong_FromSize_t(it->second);
+}
+
+
+#define CHECK_CHANNEL \
+if (channelID > this->channels.size()) { \
+    PyErr_SetString(PyExc_IndexError, "channel ID out of range"); \
+    return NULL; \
+}
+
+
+PyObject*
+Interface::write2D(std::size_t channelID, double x, double y)
+{
+    CHECK_RUN_ONLY
+    CHECK_CHANNEL
+
+    DataWrite data{DataWrite::TWODIMEN, channelID, true};
+    data.x = x;
+    data.y = y;
+    this->queueWrite(std::move(data));
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+Interface::write2DVec(std::size_t channelID, const std::vector<double>& x, const std::vector<double>& y)
+{
+    CHECK_RUN_ONLY
+    CHECK_CHANNEL
+
+    DataWrite data{DataWrite::TWODIMEN_VEC, channelID, true};
+    data.xs = x;
+    data.ys = y;
+    this->queueWrite(std::move(data));
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+Interface::write2DMulti(std::size_t channelID, const std::vector<double>& x, const std::vector<std::vector<double>>& y)
+{
+    CHECK_RUN_ONLY
+    CHECK_CHANNEL
+
+    DataWrite data{DataWrite::TWODIMEN_MULTI, channelID, true};
+    data.xs = x;
+    data.traces = y;
+    this->queueWrite(std::move(data));
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+Interface::write2DStream(std::size_t channelID, const std::vector<double>& y, double x0, double dx)
+{
+    CHECK_RUN_ONLY
+    CHECK_CHANNEL
+
+    DataWrite data{DataWrite::TWODIMEN_STREAM, channelID, true};
+    data.x = x0;
+    data.y = dx;
+    data.ys = y;
+    this->queueWrite(std::move(data));
+    Py_RETURN_NONE;
+}
+
+
+/**
+ * @brief Append rows to a record table. The table's schema (its columns and their types) is set by
+ * its first record of the run; later records must have the same columns ('int' values are accepted
+ * for 'float' columns).
+ * 
+ * @param table 
+ * @param columns 
+ * @return PyObject* 
+ */
+PyObject*
+Interface::record(const std::string& table, const std::vector<exa::RecordColumn>& columns)
+{
+    CHECK_RUN_ONLY
+
+    static constexpr const char* typeNames[] = {"float", "int", "bool"};
+
+    auto [it, created] = this->tables.try_emplace(table);
+    auto& schema = it->second;
+    if (created) {
+        for (const auto& column : columns)
+            schema.emplace_back(column.name, column.values.index());
+    }
+
+    DataWrite data{DataWrite::TABLE};
+    data.name = table;
+    data.columns.reserve(schema.size());
+    for (const auto& [name, type] : schema) {
+        auto column = std::find_if(columns.begin(), columns.end(), [&name = name](const auto& c) { return c.name == name; });
+        if (column == columns.end()) {
+            PyErr_Format(PyExc_ValueError, "record is missing column '%s' of table '%s'", name.c_str(), table.c_str());
+            return NULL;
+        }
+        if (column->values.index() == type) {
+            data.columns.push_back(*column);
+        } else if (type == exa::ColumnType::FLOAT && column->values.index() == exa::ColumnType::INT) {
+            const auto& values = std::get<exa::ColumnType::INT>(column->values);
+            data.columns.push_back({name, std::vector<double>(values.begin(), values.end())});
+        } else {
+            PyErr_Format(PyExc_TypeError, "column '%s' of table '%s' is type '%s', not '%s'",
+                         name.c_str(), table.c_str(), typeNames[type], typeNames[column->values.index()]);
+            return NULL;
+        }
+    }
+    if (columns.size() != schema.size()) {
+        for (const auto& column : columns) {
+            if (std::none_of(schema.begin(), schema.end(), [&](const auto& c) { return c.first == column.name; })) {
+                PyErr_Format(PyExc_ValueError, "table '%s' has no column '%s'", table.c_str(), column.name.c_str());
+                return NULL;
+            }
+        }
+    }
+
+    this->queueWrite(std::move(data));
     Py_RETURN_NONE;
 }
 
@@ -369,6 +642,21 @@ Interface::setPlotProperty(
         break;
     case PlotProperty::TWODIMEN_POINTS_SIZE: properties.twoDimen.points.size = std::get<double>(value); break;
     case PlotProperty::TWODIMEN_AUTORS_AXES: properties.twoDimen.autoRescaleAxes = std::get<bool>(value); break;
+    case PlotProperty::TWODIMEN_STORAGE:
+        {
+            auto storage = lowercase(std::get<std::string>(value));
+            if (storage.compare("full") == 0) {
+                properties.twoDimen.storage = GraphData::FULL;
+            } else if (storage.compare("compact") == 0) {
+                properties.twoDimen.storage = GraphData::COMPACT;
+            } else if (storage.compare("compact-float") == 0) {
+                properties.twoDimen.storage = GraphData::COMPACT_FLOAT;
+            } else {
+                PyErr_Format(PyExc_ValueError, "invalid storage: %s", std::get<std::string>(value).c_str());
+                return NULL;
+            }
+        }
+        break;
     case PlotProperty::COLORMAP_XRANGE_MIN: properties.colorMap.xRange.min = std::get<double>(value); break;
     case PlotProperty::COLORMAP_XRANGE_MAX: properties.colorMap.xRange.max = std::get<double>(value); break;
     case PlotProperty::COLORMAP_YRANGE_MIN: properties.colorMap.yRange.min = std::get<double>(value); break;
@@ -399,11 +687,20 @@ Interface::setPlotProperty(
         break;
     case PlotProperty::COLORMAP_AUTORS_AXES: properties.colorMap.autoRescaleAxes = std::get<bool>(value); break;
     case PlotProperty::COLORMAP_AUTORS_DATA: properties.colorMap.autoRescaleData = std::get<bool>(value); break;
+    case PlotProperty::COLORMAP_WATERFALL: properties.colorMap.waterfall = std::get<bool>(value); break;
     default:
         PyErr_Format(PyExc_KeyError, "invalid property '%s'", property.c_str());
         return NULL;
     }
-    emit this->module_setPlotProperty(plotIdx, property, properties);
+
+    auto edit = this->edits.find(plotIdx);
+    if (edit != this->edits.end()) {
+        auto& changed = edit->second.properties;
+        if (std::find(changed.begin(), changed.end(), property) == changed.end())
+            changed.push_back(property);
+        Py_RETURN_NONE;
+    }
+    emit this->module_setPlotProperties(plotIdx, std::vector<exa::PlotProperty::Type>{property}, properties);
     Py_RETURN_NONE;
 }
 
@@ -483,6 +780,14 @@ Interface::getPlotProperty(std::size_t plotID, const exa::PlotProperty& property
     case PlotProperty::TWODIMEN_POINTS_COLOR: pyOwned_value = PyUnicode_FromString(attributes.twoDimen.points.color.name().toStdString().c_str()); break;
     case PlotProperty::TWODIMEN_POINTS_SIZE: pyOwned_value = PyFloat_FromDouble(attributes.twoDimen.points.size); break;
     case PlotProperty::TWODIMEN_AUTORS_AXES: pyOwned_value = attributes.twoDimen.autoRescaleAxes ? Py_True : Py_False; break;
+    case PlotProperty::TWODIMEN_STORAGE:
+        switch (attributes.twoDimen.storage) {
+        case GraphData::FULL: pyOwned_value = PyUnicode_FromString("full"); break;
+        case GraphData::COMPACT: pyOwned_value = PyUnicode_FromString("compact"); break;
+        case GraphData::COMPACT_FLOAT: pyOwned_value = PyUnicode_FromString("compact-float"); break;
+        default: pyOwned_value = Py_None;
+        }
+        break;
     case PlotProperty::COLORMAP_XRANGE_MIN: pyOwned_value = PyFloat_FromDouble(attributes.colorMap.xRange.min); break;
     case PlotProperty::COLORMAP_XRANGE_MAX: pyOwned_value = PyFloat_FromDouble(attributes.colorMap.xRange.max); break;
     case PlotProperty::COLORMAP_YRANGE_MIN: pyOwned_value = PyFloat_FromDouble(attributes.colorMap.yRange.min); break;
@@ -495,6 +800,7 @@ Interface::getPlotProperty(std::size_t plotID, const exa::PlotProperty& property
     case PlotProperty::COLORMAP_COLOR_MAX: pyOwned_value = PyUnicode_FromString(attributes.colorMap.color.max.name().toStdString().c_str()); break;
     case PlotProperty::COLORMAP_AUTORS_AXES: pyOwned_value = attributes.colorMap.autoRescaleAxes ? Py_True : Py_False; break;
     case PlotProperty::COLORMAP_AUTORS_DATA: pyOwned_value = attributes.colorMap.autoRescaleData ? Py_True : Py_False; break;
+    case PlotProperty::COLORMAP_WATERFALL: pyOwned_value = attributes.colorMap.waterfall ? Py_True : Py_False; break;
     default:
         PyErr_Format(PyExc_KeyError, "invalid property '%s'", property.c_str());
         return NULL;
@@ -532,6 +838,67 @@ Interface::showPlot(std::size_t plotID, std::size_t plotType)
 }
 
 
+/**
+ * @brief Start (or nest) a property edit of a plot. Until the outermost edit ends, property
+ * changes only update the interface's copy of the plot attributes and the changed properties are
+ * collected so they can be sent to the application as a single update.
+ * 
+ * @param plotID 
+ * @return PyObject* 
+ */
+PyObject*
+Interface::beginPlotEdit(std::size_t plotID)
+{
+    CHECK_APP_ERROR
+
+    if (plotID == 0) {
+        PyErr_SetString(PyExc_IndexError, "invalid plot ID");
+        return NULL;
+    }
+    auto plotIdx = plotID - 1;
+    if (plotIdx >= this->plots.size()) {
+        PyErr_SetString(PyExc_IndexError, "plot ID out of range");
+        return NULL;
+    }
+    ++this->edits[plotIdx].depth;
+    Py_RETURN_NONE;
+}
+
+
+/**
+ * @brief End a property edit of a plot. Ending the outermost edit sends the changed properties
+ * (if any) along with the resulting plot attributes.
+ * 
+ * @param plotID 
+ * @return PyObject* 
+ */
+PyObject*
+Interface::endPlotEdit(std::size_t plotID)
+{
+    CHECK_APP_ERROR
+
+    if (plotID == 0) {
+        PyErr_SetString(PyExc_IndexError, "invalid plot ID");
+        return NULL;
+    }
+    auto plotIdx = plotID - 1;
+    auto edit = this->edits.find(plotIdx);
+    if (edit == this->edits.end()) {
+        PyErr_SetString(PyExc_RuntimeError, "plot is not being edited");
+        return NULL;
+    }
+    if (--edit->second.depth > 0)
+        Py_RETURN_NONE;
+
+    auto properties = std::move(edit->second.properties);
+    this->edits.erase(edit);
+    // the arrangement may have changed during the edit
+    if (!properties.empty() && plotIdx < this->plots.size())
+        emit this->module_setPlotProperties(plotIdx, properties, this->plots.at(plotIdx).attributes);
+    Py_RETURN_NONE;
+}
+
+
 Py_ssize_t
 Interface::currentPlotType(std::size_t plotID)
 {
@@ -591,6 +958,7 @@ Interface::loadScript(const QString& file)
     QMutexLocker locker{&this->mutex};
     std::cerr << "Loading: " << file.toStdString() << '\n';
     this->error = false;
+    this->edits.clear();
     auto status = this->core->load(std::filesystem::path{file.toStdString()}, this->module);
     if (status) {
         auto message = status.message();
@@ -619,6 +987,9 @@ Interface::runScript(const std::vector<std::string>& args)
 
     this->error = false;
     this->stopRequested = false;
+    this->edits.clear();
+    this->channels.clear();
+    this->tables.clear();
 
     this->scriptRunning = true;
     this->initDatafileAndRun(params);
@@ -676,7 +1047,10 @@ Interface::initDatafileAndRun(const std::vector<exa::RunParam> &args)
         Qt::QueuedConnection
     );
     emit this->initializeDatafile(datafile);
+    // the data file may take a while to open (e.g. when prompting for its path)
+    Py_BEGIN_ALLOW_THREADS
     waitLoop.exec();
+    Py_END_ALLOW_THREADS
 
     if (datafileInitializationError)
         return;
@@ -12,12 +12,15 @@
 #include <QObject>
 #include <QString>
 
+#include "dataqueue.hpp"
 #include "exaplot.hpp"
 #include "ploteditor.hpp"
 #include "qplot.hpp"
 #include "qplottab.hpp"
 
 #include <atomic>
+#include <map>
+#include <vector>
 
 
 class Interface : public QObject, public exa::Interface
@@ -28,20 +31,33 @@ public:
     Interface(const std::vector<std::filesystem::path>& searchPaths, QObject* parent = nullptr);
 
     void setError(bool);
+    void setDataQueue(DataQueue*);
 
     PyObject* init(const std::vector<exa::RunParam>& params, const std::vector<exa::GridPoint>& plots) override;
     PyObject* stop() override;
     PyObject* msg(const std::string& message, bool append) override;
     PyObject* datafile(const exa::DatafileConfig& config, PyObject* path, bool prompt) override;
+    PyObject* rotateDatafile() override;
     PyObject* plot2D(std::size_t plotID, double x, double y, bool write) override;
-    PyObject* plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write) override;
+    PyObject* plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write, bool sorted) override;
+    PyObject* plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y, bool write, bool sorted) override;
+    PyObject* plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx, bool write) override;
     PyObject* plotCM(std::size_t plotID, int col, int row, double value, bool write) override;
     PyObject* plotCMVec(std::size_t plotID, int row, const std::vector<double>& values, bool write) override;
     PyObject* plotCMFrame(std::size_t plotID, const std::vector<std::vector<double>>& frame, bool write) override;
+    PyObject* plotCMPush(std::size_t plotID, const std::vector<double>& values, bool write) override;
+    PyObject* channel(const std::string& name) override;
+    PyObject* write2D(std::size_t channelID, double x, double y) override;
+    PyObject* write2DVec(std::size_t channelID, const std::vector<double>& x, const std::vector<double>& y) override;
+    PyObject* write2DMulti(std::size_t channelID, const std::vector<double>& x, const std::vector<std::vector<double>>& y) override;
+    PyObject* write2DStream(std::size_t channelID, const std::vector<double>& y, double x0, double dx) override;
+    PyObject* record(const std::string& table, const std::vector<exa::RecordColumn>& columns) override;
     PyObject* clear(std::size_t plotID) override;
     PyObject* setPlotProperty(std::size_t plotID, const exa::PlotProperty& property, const exa::PlotProperty::Value& value) override;
     PyObject* getPlotProperty(std::size_t plotID, const exa::PlotProperty& property) override;
     PyObject* showPlot(std::size_t plotID, std::size_t plotType) override;
+    PyObject* beginPlotEdit(std::size_t plotID) override;
+    PyObject* endPlotEdit(std::size_t plotID) override;
     Py_ssize_t currentPlotType(std::size_t plotID) override;
 
 Q_SIGNALS:
@@ -55,13 +71,16 @@ Q_SIGNALS:
     void module_init(const std::vector<exa::RunParam>&, const std::vector<exa::GridPoint>&) const;
     void module_msg(const std::string&, bool) const;
     void module_datafile(const exa::DatafileConfig& config, bool prompt) const;
-    void module_plot2D(std::size_t plotIdx, double, double, bool) const;
+    void module_plot2D(std::size_t plotIdx, double, double) const;
     void module_plot2DVec(std::size_t plotIdx, const std::vector<double>&, const std::vector<double>&, bool) const;
-    void module_plotCM(std::size_t plotIdx, int, int, double, bool) const;
-    void module_plotCMVec(std::size_t plotIdx, int, const std::vector<double>&, bool) const;
-    void module_plotCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>&, bool) const;
+    void module_plot2DMulti(std::size_t plotIdx, const std::vector<double>&, const std::vector<std::vector<double>>&, bool) const;
+    void module_plot2DStream(std::size_t plotIdx, const std::vector<double>&, double, double) const;
+    void module_plotCM(std::size_t plotIdx, int, int, double) const;
+    void module_plotCMVec(std::size_t plotIdx, int, const std::vector<double>&) const;
+    void module_plotCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>&) const;
+    void module_plotCMPush(std::size_t plotIdx, const std::vector<double>&) const;
     void module_clear(std::size_t plotIdx) const;
-    void module_setPlotProperty(std::size_t plotIdx, const exa::PlotProperty&, const QPlotTab::Cache&) const;
+    void module_setPlotProperties(std::size_t plotIdx, const std::vector<exa::PlotProperty::Type>&, const QPlotTab::Cache&) const;
     void module_showPlot(std::size_t plotIdx, QPlot::Type);
 
 public Q_SLOTS:
@@ -73,7 +92,14 @@ public Q_SLOTS:
     void updatePlotProperties(const std::vector<PlotEditor::PlotInfo>&);
 
 private:
+    typedef struct
+    {
+        std::size_t depth;
+        std::vector<exa::PlotProperty::Type> properties;    // changed properties, in order of first change
+    } PlotEdit;
+
     void initDatafileAndRun(const std::vector<exa::RunParam> &args);
+    void queueWrite(DataWrite&&);
 
     std::atomic_bool error;
     QMutex mutex;
@@ -83,5 +109,9 @@ private:
     bool stopRequested;
     std::shared_ptr<exa::ScriptModule> module;
     std::vector<PlotEditor::PlotInfo> plots;
+    std::map<std::size_t, PlotEdit> edits;
+    std::map<std::string, std::size_t> channels;    // named data-only channels (by name) of the run
+    std::map<std::string, std::vector<std::pair<std::string, std::size_t>>> tables;   // record table -> (column, type)
+    DataQueue* dataQueue;
     std::vector<exa::RunParam> params;
 };
@@ -12,11 +12,33 @@
 #include "config.h"
 #include "toml.hpp"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
 
 
-Config::Config() {
+static std::optional<Plot::Renderer>
+parseRenderer(const toml::node& node)
+{
+    auto name = node.value<std::string>();
+    if (name == "raster")
+        return Plot::RASTER;
+    if (name == "opengl")
+        return Plot::OPENGL;
+    std::cerr << "Invalid plot renderer (" << node.source() << "): expected \"raster\" or \"opengl\"\n";
+    return std::nullopt;
+}
+
+
+Config::Config()
+    : m_searchPaths{}
+    , m_renderer{Plot::RASTER}
+    , m_plotRenderers{}
+    , m_antialiasMaxPoints{Plot2D::ANTIALIAS_MAX_POINTS}
+    , m_memoryBudget{0}
+{
     const char* configPath = std::getenv("EXACONFIG");
     if (configPath == NULL)
         return;
@@ -29,6 +51,36 @@ Config::Config() {
             for (auto&& entry : *config_searchPaths.as_array())
                 if (auto path = entry.value<std::string>()) this->m_searchPaths.push_back(*path);
         }
+
+        const auto& config_renderer = config.at_path("plot.renderer");
+        if (config_renderer) {
+            if (auto renderer = parseRenderer(*config_renderer.node())) this->m_renderer = *renderer;
+        }
+
+        // keyed by plot ID, e.g. `renderers = { 1 = "opengl" }`
+        const auto& config_renderers = config.at_path("plot.renderers");
+        if (config_renderers && config_renderers.is_table()) {
+            for (auto&& [key, value] : *config_renderers.as_table()) {
+                std::size_t plotID = 0;
+                try {
+                    plotID = std::stoul(std::string{key.str()});
+                } catch (const std::logic_error&) {}
+                if (plotID == 0) {
+                    std::cerr << "Invalid plot ID (" << key.source() << "): " << key.str() << '\n';
+                    continue;
+                }
+                if (auto renderer = parseRenderer(value)) this->m_plotRenderers[plotID - 1] = *renderer;
+            }
+        }
+
+        const auto& config_antialiasMaxPoints = config.at_path("plot.antialias_max_points");
+        if (auto points = config_antialiasMaxPoints.value<std::int64_t>(); points && *points >= 0)
+            this->m_antialiasMaxPoints = static_cast<std::size_t>(*points);
+
+        // in MiB
+        const auto& config_memoryBudget = config.at_path("plot.memory_budget");
+        if (auto budget = config_memoryBudget.value<std::int64_t>(); budget && *budget >= 0)
+            this->m_memoryBudget = static_cast<std::size_t>(*budget) << 20;
     } catch (const toml::parse_error& e) {
         std::cerr << "Failed to read config (" << configPath << "):\n" << e << '\n';
     }
@@ -41,16 +93,28 @@ AppMain::AppMain(int& argc, char* argv[], const Config& config)
     , iface{config.searchPaths()}
     , dmThread{}
     , dm{}
+    , reader{}
     , a{argc, argv}
     , ui{this}
     , promptBeforeRun{false}
     , scriptRunning{false}
+    , hasScript{false}
+    , replaying{false}
+    , replayRange{}
 {
     QObject::connect(&this->ifaceThread, &QThread::started, &this->iface, &Interface::pythonInit);
     QObject::connect(&this->ifaceThread, &QThread::finished, &this->iface, &Interface::pythonDeInit);
     this->iface.moveToThread(&this->ifaceThread);
+    // data bound for the data file goes straight from the script thread to the data manager
+    this->iface.setDataQueue(&this->dm.queue());
 
     this->dm.moveToThread(&this->dmThread);
+    // HDF5 isn't built thread-safe, so the reader shares the data manager's thread (the two
+    //   are never active at the same time anyway: a replay is stopped before any run starts)
+    this->reader.moveToThread(&this->dmThread);
+
+    this->ui.setRendering(config.renderer(), config.plotRenderers(), config.antialiasMaxPoints());
+    this->ui.setMemoryBudget(config.memoryBudget());
 
     QObject::connect(&this->a, &QApplication::aboutToQuit, [this] { this->shutdown(0); });
     QObject::connect(&this->dm, &DataManager::error, this, &AppMain::dmError);
@@ -58,6 +122,8 @@ AppMain::AppMain(int& argc, char* argv[], const Config& config)
     QObject::connect(&this->ui, &AppUI::scriptLoad, this, &AppMain::load);
     QObject::connect(&this->ui, &AppUI::scriptRun, this, &AppMain::run);
     QObject::connect(&this->ui, &AppUI::scriptStop, this, &AppMain::stop);
+    QObject::connect(&this->ui, &AppUI::datafileOpen, this, &AppMain::openDatafile);
+    QObject::connect(&this->ui, &AppUI::datafileSeek, this, &AppMain::seekDatafile);
     QObject::connect(&this->ui, &AppUI::plotsSet, &this->iface, &Interface::updatePlotProperties, Qt::QueuedConnection);
     QObject::connect(this, &AppMain::scriptLoaded, &this->iface, &Interface::loadScript, Qt::QueuedConnection);
     QObject::connect(this, &AppMain::scriptRan, &this->iface, &Interface::runScript, Qt::QueuedConnection);
@@ -66,12 +132,17 @@ AppMain::AppMain(int& argc, char* argv[], const Config& config)
     QObject::connect(this, &AppMain::dmConfigure, &this->dm, &DataManager::configure, Qt::QueuedConnection);
     QObject::connect(this, &AppMain::dmOpen, &this->dm, &DataManager::open, Qt::QueuedConnection);
     QObject::connect(this, &AppMain::dmClose, &this->dm, &DataManager::close, Qt::QueuedConnection);
-    QObject::connect(this, &AppMain::dmWrite2D, &this->dm, &DataManager::write2D, Qt::QueuedConnection);
-    QObject::connect(this, &AppMain::dmWrite2DVec, &this->dm, &DataManager::write2DVec, Qt::QueuedConnection);
-    QObject::connect(this, &AppMain::dmWriteCM, &this->dm, &DataManager::writeCM, Qt::QueuedConnection);
-    QObject::connect(this, &AppMain::dmWriteCMVec, &this->dm, &DataManager::writeCMVec, Qt::QueuedConnection);
-    QObject::connect(this, &AppMain::dmWriteCMFrame, &this->dm, &DataManager::writeCMFrame, Qt::QueuedConnection);
     QObject::connect(this, &AppMain::dmFlush, &this->dm, &DataManager::flush, Qt::QueuedConnection);
+    QObject::connect(this, &AppMain::drOpen, &this->reader, &DataReader::open, Qt::QueuedConnection);
+    QObject::connect(this, &AppMain::drSeek, &this->reader, &DataReader::seek, Qt::QueuedConnection);
+    QObject::connect(this, &AppMain::drClose, &this->reader, &DataReader::close, Qt::QueuedConnection);
+    QObject::connect(&this->reader, &DataReader::opened, this, &AppMain::reader_opened, Qt::QueuedConnection);
+    QObject::connect(&this->reader, &DataReader::loaded, this, &AppMain::reader_loaded, Qt::QueuedConnection);
+    QObject::connect(&this->reader, &DataReader::cleared, this, &AppMain::reader_cleared, Qt::QueuedConnection);
+    QObject::connect(&this->reader, &DataReader::data2D, this, &AppMain::reader_data2D, Qt::QueuedConnection);
+    QObject::connect(&this->reader, &DataReader::sizeCM, this, &AppMain::reader_sizeCM, Qt::QueuedConnection);
+    QObject::connect(&this->reader, &DataReader::dataCM, this, &AppMain::reader_dataCM, Qt::QueuedConnection);
+    QObject::connect(&this->reader, &DataReader::rowsWaterfall, this, &AppMain::reader_rowsWaterfall, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::fatalError, this, &AppMain::shutdown, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::initializeDatafile, this, &AppMain::initializeDatafile, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::scriptErrored, this, &AppMain::scriptError, Qt::QueuedConnection);
@@ -82,11 +153,14 @@ AppMain::AppMain(int& argc, char* argv[], const Config& config)
     QObject::connect(&this->iface, &Interface::module_datafile, this, &AppMain::module_datafile, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::module_plot2D, this, &AppMain::module_plot2D, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::module_plot2DVec, this, &AppMain::module_plot2DVec, Qt::QueuedConnection);
+    QObject::connect(&this->iface, &Interface::module_plot2DMulti, this, &AppMain::module_plot2DMulti, Qt::QueuedConnection);
+    QObject::connect(&this->iface, &Interface::module_plot2DStream, this, &AppMain::module_plot2DStream, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::module_plotCM, this, &AppMain::module_plotCM, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::module_plotCMVec, this, &AppMain::module_plotCMVec, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::module_plotCMFrame, this, &AppMain::module_plotCMFrame, Qt::QueuedConnection);
+    QObject::connect(&this->iface, &Interface::module_plotCMPush, this, &AppMain::module_plotCMPush, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::module_clear, this, &AppMain::module_clear, Qt::QueuedConnection);
-    QObject::connect(&this->iface, &Interface::module_setPlotProperty, this, &AppMain::module_setPlotProperty, Qt::QueuedConnection);
+    QObject::connect(&this->iface, &Interface::module_setPlotProperties, this, &AppMain::module_setPlotProperties, Qt::QueuedConnection);
     QObject::connect(&this->iface, &Interface::module_showPlot, this, &AppMain::module_showPlot, Qt::QueuedConnection);
 
     this->ifaceThread.start();
@@ -124,6 +198,7 @@ AppMain::shutdown(int status)
             case QMessageBox::Yes: terminate = true;
         }
     }
+    this->reader.cancel();
     this->dmThread.quit();
     if (this->scriptRunning && terminate) {
         this->ifaceThread.terminate();
@@ -157,6 +232,7 @@ AppMain::load(const QString& file)
         return;
     }
     this->reset();
+    this->hasScript = true;
     emit this->scriptLoaded(file);
 }
 
@@ -166,6 +242,7 @@ AppMain::run(const std::vector<std::string>& args)
 {
     if (this->scriptRunning)
         return;
+    this->stopReplay();
     this->ui.enableRun(false);
     this->ui.enableStop(true);
     this->ui.clear();
@@ -213,6 +290,56 @@ AppMain::initializeDatafile(std::filesystem::path datafile)
 }
 
 
+/**
+ * @brief Opens a data file for viewing. The plots are rearranged to match the file's datasets
+ * once the reader has opened the file (see `reader_opened`), so data files can't be opened once a
+ * script is loaded (its runs depend on its own plot arrangement).
+ * 
+ * @param file 
+ */
+void
+AppMain::openDatafile(const QString& file)
+{
+    if (this->scriptRunning) {
+        this->scriptError(
+            "Cannot open a data file while a script is running.",
+            "Data Error"
+        );
+        return;
+    }
+    if (this->hasScript) {
+        this->scriptError(
+            "Cannot open a data file while a script is loaded.",
+            "Data Error"
+        );
+        return;
+    }
+    this->reader.cancel();
+    this->replaying = true;
+    this->ui.setScriptStatus("Opening data file...");
+    emit this->drOpen(std::filesystem::path{file.toStdString()});
+}
+
+
+/**
+ * @brief Prompts for a key range and reloads the 2D datasets of the open data file restricted to
+ * that range (at a finer resolution than the overview).
+ * 
+ */
+void
+AppMain::seekDatafile()
+{
+    if (!this->replaying)
+        return;
+    auto range = this->ui.promptRange(this->replayRange);
+    if (!range)
+        return;
+    this->reader.cancel();
+    this->ui.setScriptStatus("Loading data file...");
+    emit this->drSeek(range->lower, range->upper);
+}
+
+
 void
 AppMain::updateScriptStatus(const QString& scriptStatus)
 {
@@ -280,40 +407,52 @@ AppMain::module_datafile(const exa::DatafileConfig& config, bool prompt)
 
 
 void
-AppMain::module_plot2D(std::size_t plotIdx, double x, double y, bool write)
+AppMain::module_plot2D(std::size_t plotIdx, double x, double y)
 {
     auto plot = this->ui.plot(plotIdx);
     plot->plot2D()->addData(x, y);
     plot->queue();
-    if (write)
-        emit this->dmWrite2D(plotIdx, x, y);
 }
 
 
 void
-AppMain::module_plot2DVec(std::size_t plotIdx, const std::vector<double>& x, const std::vector<double>& y, bool write)
+AppMain::module_plot2DVec(std::size_t plotIdx, const std::vector<double>& x, const std::vector<double>& y, bool sorted)
 {
     auto plot = this->ui.plot(plotIdx);
-    plot->plot2D()->addData({x.cbegin(), x.cend()}, {y.cbegin(), y.cend()});
+    plot->plot2D()->addData(x, y, sorted);
     plot->queue();
-    if (write)
-        emit this->dmWrite2DVec(plotIdx, x, y);
 }
 
 
 void
-AppMain::module_plotCM(std::size_t plotIdx, int x, int y, double value, bool write)
+AppMain::module_plot2DMulti(std::size_t plotIdx, const std::vector<double>& x, const std::vector<std::vector<double>>& y, bool sorted)
+{
+    auto plot = this->ui.plot(plotIdx);
+    plot->plot2D()->addData(x, y, sorted);
+    plot->queue();
+}
+
+
+void
+AppMain::module_plot2DStream(std::size_t plotIdx, const std::vector<double>& y, double x0, double dx)
+{
+    auto plot = this->ui.plot(plotIdx);
+    plot->plot2D()->addData(x0, dx, y);
+    plot->queue();
+}
+
+
+void
+AppMain::module_plotCM(std::size_t plotIdx, int x, int y, double value)
 {
     auto plot = this->ui.plot(plotIdx);
     plot->plotColorMap()->setCell(x, y, value);
     plot->queue();
-    if (write)
-        emit this->dmWriteCM(plotIdx, x, y, value);
 }
 
 
 void
-AppMain::module_plotCMVec(std::size_t plotIdx, int y, const std::vector<double>& values, bool write)
+AppMain::module_plotCMVec(std::size_t plotIdx, int y, const std::vector<double>& values)
 {
     auto plot = this->ui.plot(plotIdx);
     auto x_end = plot->plotColorMap()->getDataSizeX() < static_cast<int>(values.size())
@@ -322,13 +461,11 @@ AppMain::module_plotCMVec(std::size_t plotIdx, int y, const std::vector<double>&
     for (int x = 0; x < x_end; ++x)
         plot->plotColorMap()->setCell(x, y, values[x]);
     plot->queue();
-    if (write)
-        emit this->dmWriteCMVec(plotIdx, y, values);
 }
 
 
 void
-AppMain::module_plotCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>& frame, bool write)
+AppMain::module_plotCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>& frame)
 {
     auto plot = this->ui.plot(plotIdx);
     int y = 0;
@@ -341,8 +478,15 @@ AppMain::module_plotCMFrame(std::size_t plotIdx, const std::vector<std::vector<d
         y += 1;
     }
     plot->queue();
-    if (write)
-        emit this->dmWriteCMFrame(plotIdx, frame);
+}
+
+
+void
+AppMain::module_plotCMPush(std::size_t plotIdx, const std::vector<double>& values)
+{
+    auto plot = this->ui.plot(plotIdx);
+    plot->plotColorMap()->pushRow(values);
+    plot->queue();
 }
 
 
@@ -359,12 +503,12 @@ AppMain::module_clear(std::size_t plotIdx)
 
 
 void
-AppMain::module_setPlotProperty(
+AppMain::module_setPlotProperties(
     std::size_t plotIdx,
-    const exa::PlotProperty& property,
+    const std::vector<exa::PlotProperty::Type>& changed,
     const QPlotTab::Cache& properties)
 {
-    this->ui.setPlotProperty(plotIdx, property, properties);
+    this->ui.setPlotProperties(plotIdx, changed, properties);
 }
 
 
@@ -375,6 +519,134 @@ AppMain::module_showPlot(std::size_t plotIdx, QPlot::Type plotType)
 }
 
 
+void
+AppMain::reader_opened(
+    bool error,
+    const QString& message,
+    const std::vector<DataReader::DatasetInfo>& datasets)
+{
+    if (!this->replaying)
+        return;
+    if (error) {
+        this->stopReplay();
+        this->ui.setScriptStatus("");
+        this->scriptError(message, "Data Error");
+        return;
+    }
+
+    std::vector<exa::GridPoint> arrangement;
+    for (std::size_t i = 0; i < datasets.size(); ++i) {
+        arrangement.push_back({
+            .x = 0,
+            .dx = 0,
+            .y = static_cast<exa::GridPoint_t>(i),
+            .dy = 0,
+        });
+    }
+    if (!this->ui.setArrangement(arrangement)) {
+        this->stopReplay();
+        this->ui.setScriptStatus("");
+        this->scriptError("Data file contains too many datasets to display.", "Data Error");
+        return;
+    }
+    this->ui.clear();
+
+    bool hasKeys = false;
+    for (std::size_t i = 0; i < datasets.size(); ++i) {
+        const auto& dataset = datasets[i];
+        if (dataset.rows2D == 0 && (dataset.rowsCM > 0 || dataset.rowsWaterfall > 0)) {
+            this->ui.showPlot(i, QPlot::Type::COLORMAP);
+            this->ui.plot(i)->plotColorMap()->setWaterfall(dataset.rowsWaterfall > 0);
+            continue;
+        }
+        this->ui.showPlot(i, QPlot::Type::TWODIMEN);
+        if (dataset.rows2D == 0)
+            continue;
+        if (!hasKeys) {
+            this->replayRange = QCPRange{dataset.keyMin, dataset.keyMax};
+            hasKeys = true;
+        } else {
+            this->replayRange.expand(QCPRange{dataset.keyMin, dataset.keyMax});
+        }
+    }
+    this->ui.enableSeek(hasKeys);
+    this->ui.setScriptStatus("Loading data file...");
+}
+
+
+void
+AppMain::reader_loaded(bool error, const QString& message)
+{
+    if (!this->replaying)
+        return;
+    this->ui.setScriptStatus(error ? "" : "Data file loaded");
+    if (error)
+        this->scriptError(message, "Data Error");
+}
+
+
+void
+AppMain::reader_cleared()
+{
+    if (!this->replaying)
+        return;
+    for (std::size_t i = 0; i < this->ui.plotCount(); ++i) {
+        auto plot = this->ui.plot(i);
+        plot->plot2D()->clear();
+        plot->queue();
+    }
+}
+
+
+void
+AppMain::reader_data2D(std::size_t plotIdx, std::size_t trace, const QVector<double>& x, const QVector<double>& y)
+{
+    if (!this->replaying || plotIdx >= this->ui.plotCount())
+        return;
+    auto plot = this->ui.plot(plotIdx);
+    plot->plot2D()->addData(trace, x, y);
+    plot->queue();
+}
+
+
+void
+AppMain::reader_sizeCM(std::size_t plotIdx, int x, int y)
+{
+    if (!this->replaying || plotIdx >= this->ui.plotCount())
+        return;
+    auto plot = this->ui.plot(plotIdx);
+    plot->plotColorMap()->setDataSize(x, y);
+    plot->queue();
+}
+
+
+void
+AppMain::reader_dataCM(std::size_t plotIdx, const std::vector<CMData>& cells)
+{
+    if (!this->replaying || plotIdx >= this->ui.plotCount())
+        return;
+    auto plot = this->ui.plot(plotIdx);
+    for (const auto& cell : cells)
+        plot->plotColorMap()->setCell(cell.x, cell.y, cell.value);
+    plot->queue();
+}
+
+
+void
+AppMain::reader_rowsWaterfall(std::size_t plotIdx, const std::vector<double>& rows, std::size_t columns)
+{
+    if (!this->replaying || plotIdx >= this->ui.plotCount() || columns == 0)
+        return;
+    auto plot = this->ui.plot(plotIdx);
+    std::vector<double> row(columns);
+    for (std::size_t offset = 0; offset + columns <= rows.size(); offset += columns) {
+        std::copy(rows.begin() + offset, rows.begin() + offset + columns, row.begin());
+        plot->plotColorMap()->pushRow(row);
+    }
+    plot->queue();
+}
+
+
 /**
  * @brief Resets the application to the pre-load state. This should
  * be called immediately before a script is loaded.
@@ -394,12 +666,30 @@ AppMain::module_showPlot(std::size_t plotIdx, QPlot::Type plotType)
 void
 AppMain::reset()
 {
+    this->stopReplay();
     this->promptBeforeRun = false;
     this->ui.reset();
     emit this->dmReset();
 }
 
 
+/**
+ * @brief Stops viewing the currently open data file (if any). Data still queued from the reader
+ * is discarded by the reader slots once the replay flag is cleared.
+ * 
+ */
+void
+AppMain::stopReplay()
+{
+    if (!this->replaying)
+        return;
+    this->replaying = false;
+    this->reader.cancel();
+    this->ui.enableSeek(false);
+    emit this->drClose();
+}
+
+
 void
 AppMain::scriptError(const QString& message, const QString& title)
 {
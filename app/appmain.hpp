@@ -16,6 +16,7 @@
 #include "appinterface.hpp"
 #include "appui.hpp"
 #include "datamanager.hpp"
+#include "datareader.hpp"
 
 
 struct Config
@@ -23,9 +24,17 @@ struct Config
     Config();
 
     const std::vector<std::filesystem::path>& searchPaths() const { return this->m_searchPaths; }
+    Plot::Renderer renderer() const { return this->m_renderer; }
+    const std::map<std::size_t, Plot::Renderer>& plotRenderers() const { return this->m_plotRenderers; }
+    std::size_t antialiasMaxPoints() const { return this->m_antialiasMaxPoints; }
+    std::size_t memoryBudget() const { return this->m_memoryBudget; }
 
 private:
     std::vector<std::filesystem::path> m_searchPaths;
+    Plot::Renderer m_renderer;
+    std::map<std::size_t, Plot::Renderer> m_plotRenderers;
+    std::size_t m_antialiasMaxPoints;
+    std::size_t m_memoryBudget;
 };
 
 
@@ -49,12 +58,10 @@ Q_SIGNALS:
     void dmConfigure(const exa::DatafileConfig& config);
     void dmOpen(const std::filesystem::path& path, std::size_t datasets);
     void dmClose();
-    void dmWrite2D(std::size_t plotIdx, double x, double y);
-    void dmWrite2DVec(std::size_t plotIdx, const std::vector<double>& x, const std::vector<double>& y);
-    void dmWriteCM(std::size_t plotIdx, int x, int y, double value);
-    void dmWriteCMVec(std::size_t plotIdx, int y, const std::vector<double>& row);
-    void dmWriteCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>& frame);
     void dmFlush(std::size_t plotIdx);
+    void drOpen(const std::filesystem::path& path);
+    void drSeek(double from, double to);
+    void drClose();
 
 public Q_SLOTS:
     void shutdown(int = 0);
@@ -63,30 +70,47 @@ public Q_SLOTS:
     void run(const std::vector<std::string>&);
     void stop();
     void initializeDatafile(std::filesystem::path);
+    void openDatafile(const QString&);
+    void seekDatafile();
     void scriptError(const QString&, const QString&);
     void updateScriptStatus(const QString&);
     void runComplete(const QString&);
     void module_init(const std::vector<exa::RunParam>&, const std::vector<exa::GridPoint>&);
     void module_msg(const std::string&, bool);
     void module_datafile(const exa::DatafileConfig& config, bool prompt);
-    void module_plot2D(std::size_t plotIdx, double, double, bool);
+    void module_plot2D(std::size_t plotIdx, double, double);
     void module_plot2DVec(std::size_t plotIdx, const std::vector<double>&, const std::vector<double>&, bool);
-    void module_plotCM(std::size_t plotIdx, int, int, double, bool);
-    void module_plotCMVec(std::size_t plotIdx, int, const std::vector<double>&, bool);
-    void module_plotCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>&, bool);
+    void module_plot2DMulti(std::size_t plotIdx, const std::vector<double>&, const std::vector<std::vector<double>>&, bool);
+    void module_plot2DStream(std::size_t plotIdx, const std::vector<double>&, double, double);
+    void module_plotCM(std::size_t plotIdx, int, int, double);
+    void module_plotCMVec(std::size_t plotIdx, int, const std::vector<double>&);
+    void module_plotCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>&);
+    void module_plotCMPush(std::size_t plotIdx, const std::vector<double>&);
     void module_clear(std::size_t plotIdx);
-    void module_setPlotProperty(std::size_t plotIdx, const exa::PlotProperty&, const QPlotTab::Cache&);
+    void module_setPlotProperties(std::size_t plotIdx, const std::vector<exa::PlotProperty::Type>&, const QPlotTab::Cache&);
     void module_showPlot(std::size_t plotIdx, QPlot::Type);
+    void reader_opened(bool, const QString&, const std::vector<DataReader::DatasetInfo>&);
+    void reader_loaded(bool, const QString&);
+    void reader_cleared();
+    void reader_data2D(std::size_t plotIdx, std::size_t trace, const QVector<double>&, const QVector<double>&);
+    void reader_sizeCM(std::size_t plotIdx, int, int);
+    void reader_dataCM(std::size_t plotIdx, const std::vector<CMData>&);
+    void reader_rowsWaterfall(std::size_t plotIdx, const std::vector<double>&, std::size_t);
 
 private:
     void reset();
+    void stopReplay();
 
     QThread ifaceThread;
     Interface iface;
     QThread dmThread;
     DataManager dm;
+    DataReader reader;
     QApplication a;
     AppUI ui;
     bool promptBeforeRun;
     bool scriptRunning;
+    bool hasScript;     // a script has been loaded (its plot arrangement is in use)
+    bool replaying;
+    QCPRange replayRange;
 };
@@ -6,10 +6,14 @@
  * Copyright (C) 2024 bytemarx
  */
 
+#include <QInputDialog>
 #include <QMessageBox>
 
 #include "appui.hpp"
 
+#include <limits>
+#include <set>
+
 
 AppUI::AppUI(QObject* parent)
     : QObject{parent}
@@ -27,6 +31,14 @@ AppUI::AppUI(QObject* parent)
         this->mainWindow->actionLoad(), &QAction::triggered,
         this, &AppUI::loadScript
     );
+    QObject::connect(
+        this->mainWindow->actionOpenDatafile(), &QAction::triggered,
+        this, &AppUI::openDatafile
+    );
+    QObject::connect(
+        this->mainWindow->actionSeekDatafile(), &QAction::triggered,
+        [this] { emit this->datafileSeek(); }
+    );
     QObject::connect(
         this->mainWindow->buttonRun(), &QPushButton::clicked,
         [this] { emit this->scriptRun(this->scriptArgs()); }
@@ -41,7 +53,10 @@ AppUI::AppUI(QObject* parent)
     );
     QObject::connect(
         this->mainWindow->actionPlotEditor(), &QAction::triggered,
-        this->plotEditorDialog, &PlotEditor::open
+        [this] {
+            this->syncPlotEditor();
+            this->plotEditorDialog->open();
+        }
     );
     QObject::connect(
         this->plotEditorDialog, &QDialog::accepted,
@@ -77,6 +92,7 @@ AppUI::close()
 void
 AppUI::reset()
 {
+    this->editorPlots.clear();
     this->plotEditorDialog->reset();
     this->mainWindow->setPlots(this->plotEditorDialog->plots());
     this->mainWindow->plot(0)->clear();
@@ -113,11 +129,22 @@ AppUI::init(
     const std::vector<exa::GridPoint>& arrangement,
     const std::vector<std::pair<std::string, std::string>>& params)
 {
+    if (!this->setArrangement(arrangement))
+        return false;
+
+    this->mainWindow->initArgs(params);
+    return true;
+}
+
+
+bool
+AppUI::setArrangement(const std::vector<exa::GridPoint>& arrangement)
+{
+    this->syncPlotEditor();
     if (!this->plotEditorDialog->setArrangement(arrangement))
         return false;
 
     this->mainWindow->setPlots(this->plotEditorDialog->plots());
-    this->mainWindow->initArgs(params);
     return true;
 }
 
@@ -159,12 +186,69 @@ AppUI::enableStop(bool enable)
 
 
 void
-AppUI::setPlotProperty(
+AppUI::enableSeek(bool enable)
+{
+    this->mainWindow->actionSeekDatafile()->setEnabled(enable);
+}
+
+
+/**
+ * @brief Properties that are applied to the plot together (e.g. both ends of a range) map to the
+ * same property.
+ * 
+ * @param property 
+ * @return exa::PlotProperty::Type 
+ */
+static exa::PlotProperty::Type
+propertyGroup(exa::PlotProperty::Type property)
+{
+    using PlotProperty = exa::PlotProperty;
+    switch (property) {
+    case PlotProperty::TWODIMEN_XRANGE_MAX: return PlotProperty::TWODIMEN_XRANGE_MIN;
+    case PlotProperty::TWODIMEN_YRANGE_MAX: return PlotProperty::TWODIMEN_YRANGE_MIN;
+    case PlotProperty::TWODIMEN_LINE_STYLE: return PlotProperty::TWODIMEN_LINE_COLOR;
+    case PlotProperty::TWODIMEN_POINTS_COLOR:
+    case PlotProperty::TWODIMEN_POINTS_SIZE: return PlotProperty::TWODIMEN_POINTS_SHAPE;
+    case PlotProperty::COLORMAP_XRANGE_MAX: return PlotProperty::COLORMAP_XRANGE_MIN;
+    case PlotProperty::COLORMAP_YRANGE_MAX: return PlotProperty::COLORMAP_YRANGE_MIN;
+    case PlotProperty::COLORMAP_ZRANGE_MAX: return PlotProperty::COLORMAP_ZRANGE_MIN;
+    case PlotProperty::COLORMAP_DATASIZE_Y: return PlotProperty::COLORMAP_DATASIZE_X;
+    case PlotProperty::COLORMAP_COLOR_MAX: return PlotProperty::COLORMAP_COLOR_MIN;
+    default: return property;
+    }
+}
+
+
+/**
+ * @brief Apply a set of changed properties to a plot. Each plot setter is called at most once, and
+ * the plot editor is only updated when it's next opened (or its plots are read).
+ * 
+ * @param plotIdx 
+ * @param changed 
+ * @param properties the plot's attributes after the change
+ */
+void
+AppUI::setPlotProperties(
     std::size_t plotIdx,
-    const exa::PlotProperty& property,
+    const std::vector<exa::PlotProperty::Type>& changed,
     const QPlotTab::Cache& properties)
 {
     auto plot = this->plot(plotIdx);
+    std::set<exa::PlotProperty::Type> applied;
+    for (auto property : changed) {
+        if (applied.insert(propertyGroup(property)).second)
+            this->setPlotProperty(plot, property, properties);
+    }
+    this->editorPlots[plotIdx] = properties;
+}
+
+
+void
+AppUI::setPlotProperty(
+    QPlot* plot,
+    exa::PlotProperty::Type property,
+    const QPlotTab::Cache& properties)
+{
     using PlotProperty = exa::PlotProperty;
     switch (property) {
     case PlotProperty::TITLE:
@@ -213,6 +297,9 @@ AppUI::setPlotProperty(
     case PlotProperty::TWODIMEN_AUTORS_AXES:
         plot->plot2D()->setRescaleAxes(properties.twoDimen.autoRescaleAxes);
         break;
+    case PlotProperty::TWODIMEN_STORAGE:
+        plot->plot2D()->setStorage(properties.twoDimen.storage);
+        break;
     case PlotProperty::COLORMAP_XRANGE_MIN:
     case PlotProperty::COLORMAP_XRANGE_MAX:
         plot->plotColorMap()->setRangeX({properties.colorMap.xRange.min, properties.colorMap.xRange.max});
@@ -244,10 +331,28 @@ AppUI::setPlotProperty(
     case PlotProperty::COLORMAP_AUTORS_DATA:
         plot->plotColorMap()->setRescaleData(properties.colorMap.autoRescaleData);
         break;
+    case PlotProperty::COLORMAP_WATERFALL:
+        plot->plotColorMap()->setWaterfall(properties.colorMap.waterfall);
+        break;
     default:
         return this->displayError(QString{"Invalid plot property (%1)"}.arg(property));
     }
-    this->plotEditorDialog->setPlot(plotIdx, properties);
+}
+
+
+/**
+ * @brief Bring the plot editor up to date with the properties set by the script.
+ * 
+ */
+void
+AppUI::syncPlotEditor()
+{
+    auto plotCount = this->plotCount();
+    for (const auto& [plotIdx, attributes] : this->editorPlots) {
+        if (plotIdx < plotCount)
+            this->plotEditorDialog->setPlot(plotIdx, attributes);
+    }
+    this->editorPlots.clear();
 }
 
 
@@ -259,6 +364,23 @@ AppUI::showPlot(std::size_t plotIdx, QPlot::Type plotType)
 }
 
 
+void
+AppUI::setRendering(
+    Plot::Renderer renderer,
+    const std::map<std::size_t, Plot::Renderer>& plotRenderers,
+    std::size_t antialiasMaxPoints)
+{
+    this->mainWindow->setRendering(renderer, plotRenderers, antialiasMaxPoints);
+}
+
+
+void
+AppUI::setMemoryBudget(std::size_t bytes)
+{
+    this->mainWindow->setMemoryBudget(bytes);
+}
+
+
 std::filesystem::path
 AppUI::promptDatafile(const std::filesystem::path& path) const
 {
@@ -271,6 +393,43 @@ AppUI::promptDatafile(const std::filesystem::path& path) const
 }
 
 
+/**
+ * @brief Prompts the user for a key (x-axis) range. Returns an empty value if either prompt was
+ * cancelled.
+ * 
+ * @param range initial range
+ * @return std::optional<QCPRange> 
+ */
+std::optional<QCPRange>
+AppUI::promptRange(const QCPRange& range) const
+{
+    bool ok = false;
+    auto lower = QInputDialog::getDouble(
+        this->mainWindow,
+        tr("Seek Data File"),
+        tr("From:"),
+        range.lower,
+        std::numeric_limits<double>::lowest(),
+        std::numeric_limits<double>::max(),
+        6,
+        &ok
+    );
+    if (!ok) return std::nullopt;
+    auto upper = QInputDialog::getDouble(
+        this->mainWindow,
+        tr("Seek Data File"),
+        tr("To:"),
+        range.upper,
+        lower,
+        std::numeric_limits<double>::max(),
+        6,
+        &ok
+    );
+    if (!ok) return std::nullopt;
+    return QCPRange{lower, upper};
+}
+
+
 void
 AppUI::displayError(const QString& msg, const QString& title)
 {
@@ -299,3 +458,17 @@ AppUI::loadScript()
     if (file.isEmpty()) return;
     emit this->scriptLoad(file);
 }
+
+
+void
+AppUI::openDatafile()
+{
+    auto file = QFileDialog::getOpenFileName(
+        this->mainWindow,
+        tr("Open Data File"),
+        QString{},
+        tr("HDF5 Files (*.hdf5 *.h5);;All Files (*)")
+    );
+    if (file.isEmpty()) return;
+    emit this->datafileOpen(file);
+}
@@ -16,7 +16,9 @@
 #include "ploteditor.hpp"
 
 #include <map>
+#include <optional>
 #include <string>
+#include <vector>
 
 
 class AppUI : public QObject
@@ -34,14 +36,19 @@ public:
     std::vector<std::string> scriptArgs() const;
     void setMessage(const QString&, bool);
     bool init(const std::vector<exa::GridPoint>&, const std::vector<std::pair<std::string, std::string>>&);
+    bool setArrangement(const std::vector<exa::GridPoint>&);
     void setScriptStatus(const QString&);
     QPlot* plot(std::size_t);
     std::size_t plotCount() const;
     void enableRun(bool);
     void enableStop(bool);
-    void setPlotProperty(std::size_t, const exa::PlotProperty&, const QPlotTab::Cache&);
+    void enableSeek(bool);
+    void setPlotProperties(std::size_t, const std::vector<exa::PlotProperty::Type>&, const QPlotTab::Cache&);
     void showPlot(std::size_t, QPlot::Type);
+    void setRendering(Plot::Renderer, const std::map<std::size_t, Plot::Renderer>&, std::size_t);
+    void setMemoryBudget(std::size_t);
     std::filesystem::path promptDatafile(const std::filesystem::path& path) const;
+    std::optional<QCPRange> promptRange(const QCPRange& range) const;
 
 public Q_SLOTS:
     void displayError(const QString&, const QString& = "ERROR");
@@ -51,15 +58,21 @@ Q_SIGNALS:
     void scriptLoad(const QString&);
     void scriptRun(const std::vector<std::string>&);
     void scriptStop();
+    void datafileOpen(const QString&);
+    void datafileSeek();
     void plotsSet(const std::vector<PlotEditor::PlotInfo>&);
 
 private Q_SLOTS:
     void loadScript();
+    void openDatafile();
 
 private:
     void setPlots(const std::vector<PlotEditor::PlotInfo>&);
+    void setPlotProperty(QPlot*, exa::PlotProperty::Type, const QPlotTab::Cache&);
+    void syncPlotEditor();
 
     MainWindow* mainWindow;
     About* aboutDialog;
     PlotEditor* plotEditorDialog;
+    std::map<std::size_t, QPlotTab::Cache> editorPlots;     // plot attributes not yet synced to the plot editor
 };
@@ -0,0 +1,146 @@
+/*
+ * ExaPlot
+ * dataset chunk compression
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "datacompressor.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <zlib.h>
+
+
+/**
+ * @brief Byte-transpose a chunk of elements (HDF5's shuffle filter): the first bytes of all of the
+ * elements, followed by their second bytes, and so on. Trailing bytes that don't make up a whole
+ * element are copied as is.
+ * 
+ * @param data 
+ * @param size 
+ * @param elementSize 
+ * @param out destination for `size` bytes
+ */
+static void
+shuffle(const std::uint8_t* data, std::size_t size, std::size_t elementSize, std::uint8_t* out)
+{
+    auto elements = size / elementSize;
+    if (elementSize <= 1 || elements <= 1) {
+        std::memcpy(out, data, size);
+        return;
+    }
+    for (std::size_t byte = 0; byte < elementSize; ++byte) {
+        auto dest = out + byte * elements;
+        auto src = data + byte;
+        for (std::size_t i = 0; i < elements; ++i)
+            dest[i] = src[i * elementSize];
+    }
+    auto shuffled = elements * elementSize;
+    std::memcpy(out + shuffled, data + shuffled, size - shuffled);
+}
+
+
+/**
+ * @brief Start the worker threads.
+ * 
+ * @param level deflate compression level (1 through 9)
+ * @param workers number of worker threads
+ */
+ChunkCompressor::ChunkCompressor(int level, std::size_t workers)
+    : m_level{level}
+    , m_stopping{false}
+    , m_mutex{}
+    , m_condition{}
+    , m_tasks{}
+    , m_workers{}
+{
+    for (std::size_t i = 0; i < workers; ++i)
+        this->m_workers.emplace_back(&ChunkCompressor::work, this);
+}
+
+
+/**
+ * @brief Stop the worker threads once they've compressed the chunks already submitted.
+ * 
+ */
+ChunkCompressor::~ChunkCompressor()
+{
+    {
+        std::lock_guard lock{this->m_mutex};
+        this->m_stopping = true;
+    }
+    this->m_condition.notify_all();
+    for (auto& worker : this->m_workers)
+        worker.join();
+}
+
+
+/**
+ * @brief Submit a chunk to be compressed by the next available worker.
+ * 
+ * @param chunk the chunk's (uncompressed) bytes
+ * @param elementSize size of the dataset's elements (for the shuffle)
+ * @return std::future<Chunk> the compressed chunk
+ */
+std::future<ChunkCompressor::Chunk>
+ChunkCompressor::compress(Chunk&& chunk, std::size_t elementSize)
+{
+    std::packaged_task<Chunk()> task{[chunk = std::move(chunk), elementSize, level = this->m_level] {
+        return ChunkCompressor::compressChunk(chunk.data(), chunk.size(), elementSize, level);
+    }};
+    auto result = task.get_future();
+    {
+        std::lock_guard lock{this->m_mutex};
+        this->m_tasks.push_back(std::move(task));
+    }
+    this->m_condition.notify_one();
+    return result;
+}
+
+
+/**
+ * @brief Shuffle and deflate a chunk, producing the same bytes HDF5 would store for a dataset with
+ * the shuffle and deflate filters (in that order).
+ * 
+ * @param data 
+ * @param size 
+ * @param elementSize 
+ * @param level 
+ * @return Chunk 
+ */
+ChunkCompressor::Chunk
+ChunkCompressor::compressChunk(const std::uint8_t* data, std::size_t size, std::size_t elementSize, int level)
+{
+    Chunk shuffled(size);
+    shuffle(data, size, elementSize, shuffled.data());
+
+    auto length = compressBound(static_cast<uLong>(size));
+    Chunk compressed(length);
+    if (compress2(compressed.data(), &length, shuffled.data(), static_cast<uLong>(size), level) != Z_OK)
+        throw std::runtime_error{"failed to compress chunk"};
+    compressed.resize(length);
+    return compressed;
+}
+
+
+void
+ChunkCompressor::work()
+{
+    for (;;) {
+        std::packaged_task<Chunk()> task;
+        {
+            std::unique_lock lock{this->m_mutex};
+            this->m_condition.wait(lock, [this] { return this->m_stopping || !this->m_tasks.empty(); });
+            if (this->m_tasks.empty())
+                return;
+            task = std::move(this->m_tasks.front());
+            this->m_tasks.pop_front();
+        }
+        // exceptions are stored in the task's future
+        task();
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * ExaPlot
+ * dataset chunk compression
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+/**
+ * @brief Pool of worker threads compressing dataset chunks the way HDF5's shuffle and deflate
+ * filters do, so that complete chunks can be written to a dataset (created with those filters)
+ * with `H5Dwrite_chunk`. Compression then scales across cores while all of the HDF5 library calls
+ * stay on the data manager's thread.
+ * 
+ * With no workers, datasets are still created with the filters but chunks are compressed by
+ * HDF5's (single-threaded) filter pipeline.
+ * 
+ */
+class ChunkCompressor
+{
+public:
+    typedef std::vector<std::uint8_t> Chunk;
+
+    ChunkCompressor(int level, std::size_t workers);
+    ~ChunkCompressor();
+
+    ChunkCompressor(const ChunkCompressor&) = delete;
+    ChunkCompressor& operator=(const ChunkCompressor&) = delete;
+
+    int level() const { return this->m_level; }
+    std::size_t workers() const { return this->m_workers.size(); }
+
+    std::future<Chunk> compress(Chunk&& chunk, std::size_t elementSize);
+
+    static Chunk compressChunk(const std::uint8_t* data, std::size_t size, std::size_t elementSize, int level);
+
+private:
+    void work();
+
+    int m_level;
+    bool m_stopping;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::packaged_task<Chunk()>> m_tasks;
+    std::vector<std::thread> m_workers;
+};
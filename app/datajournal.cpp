@@ -0,0 +1,344 @@
+/*
+ * ExaPlot
+ * data journal
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "datajournal.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+static_assert(sizeof(DataJournal::Record) == 24, "journal records must be 24 bytes");
+static_assert(sizeof(DataJournal::Header) <= DataJournal::HEADER_SIZE);
+static_assert((DataJournal::SEGMENT_RECORDS * sizeof(DataJournal::Record)) % DataJournal::HEADER_SIZE == 0);
+
+
+DataJournal::DataJournal()
+    : m_path{}
+    , m_records{nullptr}
+    , m_count{0}
+    , m_capacity{0}
+    , m_segmentStart{0}
+#if defined(_WIN32)
+    , m_file{INVALID_HANDLE_VALUE}
+    , m_mapping{NULL}
+#else
+    , m_file{-1}
+#endif
+    , m_view{nullptr}
+{
+}
+
+
+DataJournal::~DataJournal()
+{
+    // a journal still open at this point wasn't closed cleanly, so it's kept for recovery
+    this->close(false);
+}
+
+
+/**
+ * @brief Create the journal file (replacing any existing one) and map the first block of records.
+ * 
+ * @param path 
+ * @param datasets number of dataset groups in the data file (plot IDs 1 through datasets - 1)
+ */
+void
+DataJournal::open(const std::filesystem::path& path, std::size_t datasets)
+{
+    this->close(false);
+
+#if defined(_WIN32)
+    this->m_file = CreateFileW(
+        path.wstring().c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ,
+        NULL,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL
+    );
+    if (this->m_file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error{"failed to create journal file"};
+#else
+    this->m_file = ::open(path.string().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (this->m_file == -1)
+        throw std::runtime_error{"failed to create journal file"};
+#endif
+    this->m_path = path;
+    this->m_count = 0;
+    this->m_capacity = 0;
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.recordSize = sizeof(Record);
+    header.datasets = datasets;
+#if defined(_WIN32)
+    DWORD written = 0;
+    auto headerWritten = WriteFile(this->m_file, &header, sizeof(header), &written, NULL) && written == sizeof(header);
+#else
+    auto headerWritten = write(this->m_file, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+#endif
+
+    try {
+        if (!headerWritten)
+            throw std::runtime_error{"failed to write journal header"};
+        this->map(0);
+    } catch (const std::runtime_error&) {
+        this->close(true);
+        throw;
+    }
+}
+
+
+/**
+ * @brief Unmap and close the journal.
+ * 
+ * @param remove delete the journal file (i.e. the data file was closed cleanly)
+ */
+void
+DataJournal::close(bool remove)
+{
+#if defined(_WIN32)
+    if (this->m_file == INVALID_HANDLE_VALUE)
+        return;
+#else
+    if (this->m_file == -1)
+        return;
+#endif
+
+    // trim the unused tail of the last segment
+    this->unmap();
+    auto size = HEADER_SIZE + this->m_count * sizeof(Record);
+#if defined(_WIN32)
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (SetFilePointerEx(this->m_file, fileSize, NULL, FILE_BEGIN))
+        SetEndOfFile(this->m_file);
+    CloseHandle(this->m_file);
+    this->m_file = INVALID_HANDLE_VALUE;
+#else
+    [[maybe_unused]] auto status = ftruncate(this->m_file, static_cast<off_t>(size));
+    ::close(this->m_file);
+    this->m_file = -1;
+#endif
+
+    if (remove) {
+        std::error_code ec;
+        std::filesystem::remove(this->m_path, ec);
+    }
+    this->m_count = 0;
+    this->m_capacity = 0;
+    this->m_segmentStart = 0;
+}
+
+
+/**
+ * @brief Schedule the mapped pages to be written to disk (the data is already safe from the
+ * process being killed; this bounds the loss window for a system crash).
+ * 
+ */
+void
+DataJournal::sync()
+{
+    if (!this->m_view)
+        return;
+    auto size = (this->m_count - this->m_segmentStart) * sizeof(Record);
+#if defined(_WIN32)
+    FlushViewOfFile(this->m_view, size);
+#else
+    msync(this->m_view, size, MS_ASYNC);
+#endif
+}
+
+
+void
+DataJournal::grow()
+{
+    this->map(this->m_capacity / SEGMENT_RECORDS);
+}
+
+
+/**
+ * @brief Extend the file by a segment and map it in place of the current one.
+ * 
+ * @param segment 
+ */
+void
+DataJournal::map(std::size_t segment)
+{
+    this->unmap();
+    auto offset = HEADER_SIZE + segment * SEGMENT_RECORDS * sizeof(Record);
+    auto length = SEGMENT_RECORDS * sizeof(Record);
+    auto size = offset + length;
+
+#if defined(_WIN32)
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(this->m_file, fileSize, NULL, FILE_BEGIN) || !SetEndOfFile(this->m_file))
+        throw std::runtime_error{"failed to extend journal file"};
+    this->m_mapping = CreateFileMappingW(
+        this->m_file,
+        NULL,
+        PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+        static_cast<DWORD>(size & 0xFFFFFFFF),
+        NULL
+    );
+    if (this->m_mapping == NULL)
+        throw std::runtime_error{"failed to map journal file"};
+    this->m_view = MapViewOfFile(
+        this->m_mapping,
+        FILE_MAP_WRITE,
+        static_cast<DWORD>(static_cast<std::uint64_t>(offset) >> 32),
+        static_cast<DWORD>(offset & 0xFFFFFFFF),
+        length
+    );
+    if (this->m_view == NULL) {
+        CloseHandle(this->m_mapping);
+        this->m_mapping = NULL;
+        throw std::runtime_error{"failed to map journal file"};
+    }
+#else
+    // the new segment is zero-filled, i.e. `EMPTY` records
+    if (ftruncate(this->m_file, static_cast<off_t>(size)) < 0)
+        throw std::runtime_error{"failed to extend journal file"};
+    auto view = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, this->m_file, static_cast<off_t>(offset));
+    if (view == MAP_FAILED)
+        throw std::runtime_error{"failed to map journal file"};
+    this->m_view = view;
+#endif
+
+    this->m_records = static_cast<Record*>(this->m_view);
+    this->m_segmentStart = segment * SEGMENT_RECORDS;
+    this->m_capacity = this->m_segmentStart + SEGMENT_RECORDS;
+}
+
+
+void
+DataJournal::unmap()
+{
+    if (!this->m_view)
+        return;
+#if defined(_WIN32)
+    UnmapViewOfFile(this->m_view);
+    CloseHandle(this->m_mapping);
+    this->m_mapping = NULL;
+#else
+    munmap(this->m_view, SEGMENT_RECORDS * sizeof(Record));
+#endif
+    this->m_view = nullptr;
+    this->m_records = nullptr;
+}
+
+
+/**
+ * @brief Rebuild a data file from a journal. The journal is read up to its first empty (or
+ * incomplete) record; records referring to plots outside of the journal's datasets are skipped.
+ * 
+ * @param journal 
+ * @param output path of the data file to create (overwritten if it exists)
+ * @return std::size_t number of records recovered
+ */
+std::size_t
+DataJournal::recover(const std::filesystem::path& journal, const std::filesystem::path& output)
+{
+    std::ifstream input{journal, std::ios::binary};
+    if (!input)
+        throw std::runtime_error{"failed to open journal file"};
+
+    Header header;
+    if (!input.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error{"not a journal file"};
+    // version 1 journals only lack the (multi-trace) `TRACE` records
+    if (header.version < 1 || header.version > VERSION || header.recordSize != sizeof(Record))
+        throw std::runtime_error{"unsupported journal version"};
+    if (!input.seekg(HEADER_SIZE))
+        throw std::runtime_error{"truncated journal file"};
+
+    HDF5Storage storage;
+    storage.open(output, false);
+
+    std::size_t recovered = 0;
+    {
+        std::vector<DataSetGroup> datasets;
+        for (std::uint64_t i = 1; i < header.datasets; ++i)
+            datasets.push_back(DataSetGroup{storage, std::string{"dataset"} + std::to_string(i)});
+
+        // multi-trace rows span several records, so each plot's last row is held until it's complete
+        std::vector<std::pair<double, std::vector<double>>> rows(datasets.size());
+        auto writeRow = [&](std::size_t plotIdx) {
+            auto& [x, y] = rows[plotIdx];
+            if (y.size() == 1) {
+                datasets[plotIdx].dataset2D()->write(x, y[0]);
+            } else if (!y.empty()) {
+                std::vector<std::vector<double>> traces;
+                for (auto value : y)
+                    traces.push_back({value});
+                datasets[plotIdx].dataset2D()->write({x}, traces);
+            }
+            y.clear();
+        };
+
+        std::vector<Record> records(4096);
+        bool done = false;
+        while (!done && input) {
+            input.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+            auto count = static_cast<std::size_t>(input.gcount()) / sizeof(Record);
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto& record = records[i];
+                if (record.type == EMPTY) {
+                    done = true;
+                    break;
+                }
+                if (record.plotIdx >= datasets.size())
+                    continue;
+                auto& group = datasets[record.plotIdx];
+                if (record.type == TWODIMEN) {
+                    writeRow(record.plotIdx);
+                    rows[record.plotIdx] = {record.data.point.x, {record.data.point.y}};
+                } else if (record.type == TRACE) {
+                    auto& y = rows[record.plotIdx].second;
+                    auto trace = static_cast<std::size_t>(record.data.point.x);
+                    if (y.empty() || trace >= (1 << 16))
+                        continue;
+                    y.resize(std::max(y.size(), trace + 1), std::numeric_limits<double>::quiet_NaN());
+                    y[trace] = record.data.point.y;
+                } else if (record.type == COLORMAP) {
+                    const auto& cell = record.data.cell;
+                    group.datasetCM()->write(cell.x, cell.y, cell.value);
+                } else {
+                    done = true;
+                    break;
+                }
+                ++recovered;
+            }
+        }
+        for (std::size_t i = 0; i < rows.size(); ++i)
+            writeRow(i);
+    }
+
+    // the datasets have been flushed and closed by now (the file is closed by the storage's
+    //   destructor if this throws)
+    storage.close();
+    return recovered;
+}
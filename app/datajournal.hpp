@@ -0,0 +1,144 @@
+/*
+ * ExaPlot
+ * data journal
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#include "datamanager.hpp"
+
+
+/**
+ * @brief Append-only, memory-mapped journal of the data written during a run.
+ * 
+ * Every point written to the data file is also appended to the journal as a fixed-size record.
+ * Appending is a store into the mapped file (no system call, no HDF5 bookkeeping), and since the
+ * pages belong to the OS, the records survive the application being killed mid-run. Only the
+ * segment currently being appended to is mapped; the file grows one segment at a time. A data file
+ * that wasn't closed cleanly can then be rebuilt from its journal with `DataJournal::recover`
+ * (see the `exaplot-recover` tool).
+ * 
+ */
+class DataJournal
+{
+public:
+    typedef enum : std::uint32_t
+    {
+        EMPTY = 0,
+        TWODIMEN = 1,
+        COLORMAP = 2,
+        TRACE = 3,          // additional trace of the preceding 2D record (x: trace index)
+    } RecordType;
+
+    typedef struct
+    {
+        double x;
+        double y;
+    } Point2D;
+
+    typedef struct
+    {
+        std::uint32_t type;
+        std::uint32_t plotIdx;
+        union
+        {
+            Point2D point;
+            CMData cell;
+        } data;
+    } Record;
+
+    typedef struct
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t recordSize;
+        std::uint64_t datasets;
+    } Header;
+
+    constexpr static char MAGIC[8] = "EXAJRNL";
+    constexpr static std::uint32_t VERSION = 2;
+    // records start at this offset (and segments are a multiple of it) so that every segment is aligned
+    //   to the mapping granularity of all platforms
+    constexpr static std::size_t HEADER_SIZE = 1 << 16;
+    constexpr static std::size_t SEGMENT_RECORDS = 1 << 20;
+
+    DataJournal();
+    ~DataJournal();
+
+    DataJournal(const DataJournal&) = delete;
+    DataJournal& operator=(const DataJournal&) = delete;
+
+    void open(const std::filesystem::path& path, std::size_t datasets);
+    void close(bool remove);
+    void sync();
+    bool isOpen() const { return this->m_records != nullptr; }
+    const std::filesystem::path& path() const { return this->m_path; }
+
+    void append2D(std::size_t plotIdx, double x, double y)
+    {
+        auto record = this->next();
+        record->plotIdx = static_cast<std::uint32_t>(plotIdx);
+        record->data.point = {x, y};
+        this->commit(record, TWODIMEN);
+    }
+
+    void appendTrace(std::size_t plotIdx, std::size_t trace, double y)
+    {
+        auto record = this->next();
+        record->plotIdx = static_cast<std::uint32_t>(plotIdx);
+        record->data.point = {static_cast<double>(trace), y};
+        this->commit(record, TRACE);
+    }
+
+    void appendCM(std::size_t plotIdx, int x, int y, double value)
+    {
+        auto record = this->next();
+        record->plotIdx = static_cast<std::uint32_t>(plotIdx);
+        record->data.cell = {x, y, value};
+        this->commit(record, COLORMAP);
+    }
+
+    static std::size_t recover(const std::filesystem::path& journal, const std::filesystem::path& output);
+
+private:
+    Record* next()
+    {
+        if (this->m_count == this->m_capacity)
+            this->grow();
+        return this->m_records + (this->m_count - this->m_segmentStart);
+    }
+
+    void commit(Record* record, RecordType type)
+    {
+        // the type is what marks a record as valid, so it must land after the payload (only the
+        //   compiler needs fencing: the journal is only ever read after this process is gone)
+        std::atomic_signal_fence(std::memory_order_release);
+        record->type = type;
+        ++this->m_count;
+    }
+
+    void grow();
+    void map(std::size_t segment);
+    void unmap();
+
+    std::filesystem::path m_path;
+    Record* m_records;
+    std::size_t m_count;
+    std::size_t m_capacity;
+    std::size_t m_segmentStart;
+#if defined(_WIN32)
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_file;
+#endif
+    void* m_view;
+};
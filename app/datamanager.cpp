@@ -7,94 +7,191 @@
  */
 
 #include "datamanager.hpp"
+#include "datajournal.hpp"
 
+#include <thread>
 
-DataSet2D::DataSet2D(hid_t fileID, const std::string& name)
-    : DataSet{fileID, name + ".twodimen", 2, H5T_IEEE_F64LE}
-{
-}
 
-
-void
-DataSet2D::write(double x, double y)
+/**
+ * @brief Flush and close a segment of the data file (on a background thread while the next segment
+ * is written).
+ * 
+ * @param segment 
+ * @return std::string error message (empty on success)
+ */
+static std::string
+finaliseSegment(DataSegment& segment)
 {
-    this->m_buffer.push_back(x);
-    this->m_buffer.push_back(y);
-    if (this->m_buffer.size() == (2 * 4096))
-        this->writeToDataset();
+    std::string error;
+    try {
+        for (auto& group : segment.datasets)
+            group.flush();
+        for (auto& [name, table] : segment.tables)
+            table.flush();
+    } catch (const std::runtime_error& e) {
+        error = e.what();
+    }
+    segment.datasets.clear();
+    segment.tables.clear();
+    segment.compressor.reset();
+    try {
+        segment.storage->close();
+    } catch (const std::runtime_error& e) {
+        if (error.empty())
+            error = e.what();
+    }
+    return error;
 }
 
 
-void
-DataSet2D::write(const std::vector<double>& x, const std::vector<double>& y)
+/**
+ * @brief Default number of compression workers: up to 4, leaving a core for the application.
+ * 
+ * @return std::size_t 
+ */
+static std::size_t
+defaultCompressionWorkers()
 {
-    auto min = x.size() < y.size() ? x.size() : y.size();
-    for (std::size_t i = 0; i < min; ++i)
-        this->write(x[i], y[i]);
+    auto cores = static_cast<std::size_t>(std::thread::hardware_concurrency());
+    return std::clamp<std::size_t>(cores > 1 ? cores - 1 : 1, 1, 4);
 }
 
 
-static hid_t
-cmDatatype()
+std::unique_ptr<DataSet2D>
+DataSet2D::create(DataStorage& storage, const std::string& name, exa::StorageType type, ChunkCompressor* compressor,
+                  std::size_t summary)
 {
-    auto datatype = H5Tcreate(H5T_COMPOUND, sizeof(CMData));
-    H5Tinsert(datatype, "x", HOFFSET(CMData, x), H5T_NATIVE_INT);
-    H5Tinsert(datatype, "y", HOFFSET(CMData, y), H5T_NATIVE_INT);
-    H5Tinsert(datatype, "z", HOFFSET(CMData, value), H5T_NATIVE_DOUBLE);
-    return datatype;
+    switch (type) {
+        case exa::StorageType::FLOAT64:
+            return std::make_unique<TypedDataSet2D<double>>(storage, name, compressor, summary);
+        case exa::StorageType::FLOAT32:
+            return std::make_unique<TypedDataSet2D<float>>(storage, name, compressor, summary);
+        case exa::StorageType::INT16:
+            return std::make_unique<TypedDataSet2D<std::int16_t>>(storage, name, compressor, summary);
+        case exa::StorageType::INT32:
+            return std::make_unique<TypedDataSet2D<std::int32_t>>(storage, name, compressor, summary);
+        case exa::StorageType::UINT16:
+            return std::make_unique<TypedDataSet2D<std::uint16_t>>(storage, name, compressor, summary);
+    }
+    throw std::runtime_error{"invalid storage type"};
 }
 
 
-DataSetCM::DataSetCM(hid_t fileID, const std::string& name)
-    : DataSet<CMData>{fileID, name + ".colormap", 1, cmDatatype()}
+std::unique_ptr<DataSetCM>
+DataSetCM::create(DataStorage& storage, const std::string& name, exa::StorageType type, ChunkCompressor* compressor)
 {
+    switch (type) {
+        case exa::StorageType::FLOAT64:
+            return std::make_unique<TypedDataSetCM<double>>(storage, name, compressor);
+        case exa::StorageType::FLOAT32:
+            return std::make_unique<TypedDataSetCM<float>>(storage, name, compressor);
+        case exa::StorageType::INT16:
+            return std::make_unique<TypedDataSetCM<std::int16_t>>(storage, name, compressor);
+        case exa::StorageType::INT32:
+            return std::make_unique<TypedDataSetCM<std::int32_t>>(storage, name, compressor);
+        case exa::StorageType::UINT16:
+            return std::make_unique<TypedDataSetCM<std::uint16_t>>(storage, name, compressor);
+    }
+    throw std::runtime_error{"invalid storage type"};
 }
 
 
-void
-DataSetCM::write(int x, int y, double value)
+std::unique_ptr<DataSetStream>
+DataSetStream::create(DataStorage& storage, const std::string& name, exa::StorageType type, ChunkCompressor* compressor)
 {
-    this->m_buffer.push_back({
-        .x = x,
-        .y = y,
-        .value = value
-    });
-    if (this->m_buffer.size() == 4096)
-        this->writeToDataset();
+    switch (type) {
+        case exa::StorageType::FLOAT64:
+            return std::make_unique<TypedDataSetStream<double>>(storage, name, compressor);
+        case exa::StorageType::FLOAT32:
+            return std::make_unique<TypedDataSetStream<float>>(storage, name, compressor);
+        case exa::StorageType::INT16:
+            return std::make_unique<TypedDataSetStream<std::int16_t>>(storage, name, compressor);
+        case exa::StorageType::INT32:
+            return std::make_unique<TypedDataSetStream<std::int32_t>>(storage, name, compressor);
+        case exa::StorageType::UINT16:
+            return std::make_unique<TypedDataSetStream<std::uint16_t>>(storage, name, compressor);
+    }
+    throw std::runtime_error{"invalid storage type"};
 }
 
 
-void
-DataSetCM::write(int y, const std::vector<double>& row)
+std::unique_ptr<DataSetWaterfall>
+DataSetWaterfall::create(DataStorage& storage, const std::string& name, exa::StorageType type, std::size_t columns, ChunkCompressor* compressor)
 {
-    int x = 0;
-    for (const auto& value : row)
-        this->write(x++, y, value);
+    switch (type) {
+        case exa::StorageType::FLOAT64:
+            return std::make_unique<TypedDataSetWaterfall<double>>(storage, name, columns, compressor);
+        case exa::StorageType::FLOAT32:
+            return std::make_unique<TypedDataSetWaterfall<float>>(storage, name, columns, compressor);
+        case exa::StorageType::INT16:
+            return std::make_unique<TypedDataSetWaterfall<std::int16_t>>(storage, name, columns, compressor);
+        case exa::StorageType::INT32:
+            return std::make_unique<TypedDataSetWaterfall<std::int32_t>>(storage, name, columns, compressor);
+        case exa::StorageType::UINT16:
+            return std::make_unique<TypedDataSetWaterfall<std::uint16_t>>(storage, name, columns, compressor);
+    }
+    throw std::runtime_error{"invalid storage type"};
 }
 
 
-void
-DataSetCM::write(const std::vector<std::vector<double>>& frame)
+std::unique_ptr<DataSetColumn>
+DataSetColumn::create(DataStorage& storage, const std::string& name, std::size_t type, ChunkCompressor* compressor)
 {
-    int y = 0;
-    for (const auto& row : frame)
-        this->write(y++, row);
+    switch (type) {
+        case exa::ColumnType::FLOAT:
+            return std::make_unique<TypedDataSetColumn<double>>(storage, name, compressor);
+        case exa::ColumnType::INT:
+            return std::make_unique<TypedDataSetColumn<std::int64_t>>(storage, name, compressor);
+        case exa::ColumnType::BOOL:
+            return std::make_unique<TypedDataSetColumn<std::uint8_t>>(storage, name, compressor);
+    }
+    throw std::runtime_error{"invalid column type"};
 }
 
 
 DataManager::DataManager()
     : QObject{nullptr}
     , m_enabled{false}
-    , m_fileID{H5I_INVALID_HID}
+    , m_swmr{false}
+    , m_journalEnabled{false}
+    , m_format{exa::StorageFormat::HDF5}
+    , m_storageType{exa::StorageType::FLOAT64}
+    , m_plotStorageTypes{}
+    , m_flushPolicy{}
+    , m_compression{0}
+    , m_compressionWorkers{defaultCompressionWorkers()}
+    , m_segmentBytes{0}
+    , m_segmentDuration{0}
+    , m_summary{0}
+    , m_flushTimer{this}
+    , m_compressor{}
+    , m_datasets{}
+    , m_channels{}
+    , m_tables{}
+    , m_journal{new DataJournal}
+    , m_storage{}
+    , m_path{}
+    , m_segment{0}
+    , m_segmentOpened{}
+    , m_segmentEmpty{true}
+    , m_index{}
+    , m_finalising{}
+    , m_queue{}
 {
+    QObject::connect(&this->m_flushTimer, &QTimer::timeout, this, &DataManager::flushBuffered);
+    this->m_queue.setNotify([this] {
+        QMetaObject::invokeMethod(this, &DataManager::drain, Qt::QueuedConnection);
+    });
 }
 
 
 DataManager::~DataManager()
 {
+    this->collectFinalised(true);
     this->m_datasets.clear();
-    if (this->m_fileID != H5I_INVALID_HID)
-        H5Fclose(this->m_fileID);
+    this->m_tables.clear();
+    this->m_compressor.reset();
+    this->m_storage.reset();
 }
 
 
@@ -106,6 +203,17 @@ void
 DataManager::reset()
 {
     this->setEnabled(false);
+    this->m_swmr = false;
+    this->m_journalEnabled = false;
+    this->m_format = exa::StorageFormat::HDF5;
+    this->m_storageType = exa::StorageType::FLOAT64;
+    this->m_plotStorageTypes.clear();
+    this->m_flushPolicy = FlushPolicy{};
+    this->m_compression = 0;
+    this->m_compressionWorkers = defaultCompressionWorkers();
+    this->m_segmentBytes = 0;
+    this->m_segmentDuration = std::chrono::milliseconds{0};
+    this->m_summary = 0;
 }
 
 
@@ -119,6 +227,38 @@ DataManager::configure(const exa::DatafileConfig& config)
 {
     if (config.enable)
         this->setEnabled(*config.enable);
+    if (config.swmr)
+        this->m_swmr = *config.swmr;
+    if (config.journal)
+        this->m_journalEnabled = *config.journal;
+    if (config.format)
+        this->m_format = *config.format;
+    if (config.dtype)
+        this->m_storageType = *config.dtype;
+    if (config.plotDtypes)
+        this->m_plotStorageTypes = *config.plotDtypes;
+    if (config.flushRows)
+        this->m_flushPolicy.rows = *config.flushRows;
+    if (config.flushBytes)
+        this->m_flushPolicy.bytes = *config.flushBytes;
+    if (config.flushAge) {
+        this->m_flushPolicy.age = std::chrono::milliseconds{
+            static_cast<std::chrono::milliseconds::rep>(*config.flushAge * 1000)
+        };
+    }
+    if (config.compression)
+        this->m_compression = *config.compression;
+    if (config.compressionWorkers)
+        this->m_compressionWorkers = *config.compressionWorkers;
+    if (config.segmentBytes)
+        this->m_segmentBytes = *config.segmentBytes;
+    if (config.segmentDuration) {
+        this->m_segmentDuration = std::chrono::milliseconds{
+            static_cast<std::chrono::milliseconds::rep>(*config.segmentDuration * 1000)
+        };
+    }
+    if (config.summary)
+        this->m_summary = *config.summary;
 }
 
 
@@ -127,44 +267,93 @@ DataManager::setEnabled(bool enabled)
 {
     if (!enabled) {
         // put data manager in initial state
+        this->m_flushTimer.stop();
         this->m_datasets.clear();
-        if (this->m_fileID != H5I_INVALID_HID)
-            H5Fclose(this->m_fileID);
-        this->m_fileID = H5I_INVALID_HID;
+        this->m_channels.clear();
+        this->m_tables.clear();
+        this->m_compressor.reset();
+        this->m_journal->close(false);
+        this->m_storage.reset();
+        this->collectFinalised(true);
+        this->m_index.reset();
     }
 
     this->m_enabled = enabled;
 }
 
 
+/**
+ * @brief Create the data file and its datasets. In SWMR mode, the file is created with the latest
+ * file format and switched to SWMR writing once all datasets exist (no objects may be created
+ * afterwards). With a rotation policy, the file is the first of the data file's segments (see
+ * `rotate`) and the segment index is written alongside it.
+ * 
+ * @param path 
+ * @param datasets 
+ */
 void
 DataManager::open(const std::filesystem::path& path, std::size_t datasets)
 {
     if (this->m_enabled) {
-        assert(this->m_fileID == H5I_INVALID_HID);
+        assert(!this->m_storage);
 
-        this->m_fileID = H5Fcreate(path.string().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
-        if (this->m_fileID == H5I_INVALID_HID) {
-            emit this->opened(true, "failed to create HDF5 file");
+        try {
+            this->m_storage = DataStorage::create(this->m_format);
+            this->m_storage->open(path, this->swmr());
+        } catch (const std::runtime_error& e) {
+            this->m_storage.reset();
+            emit this->opened(true, e.what());
             return;
         }
 
-        // TODO: zeroth/non-plot dataset
         try {
+            if (this->m_compression > 0 && this->m_format == exa::StorageFormat::HDF5)
+                this->m_compressor = std::make_unique<ChunkCompressor>(this->m_compression, this->m_compressionWorkers);
             for (std::size_t i = 1; i < datasets; ++i) {
                 auto datasetName = std::string{"dataset"} + std::to_string(i);
-                this->m_datasets.push_back(DataSetGroup{this->m_fileID, datasetName});
+                auto type = this->m_plotStorageTypes.find(i);
+                this->m_datasets.push_back(DataSetGroup{
+                    *this->m_storage,
+                    datasetName,
+                    type != this->m_plotStorageTypes.end() ? type->second : this->m_storageType,
+                    this->m_compressor.get(),
+                    this->m_summary
+                });
+                this->m_datasets.back().setFlushOnWrite(this->swmr());
+                this->m_datasets.back().setFlushPolicy(this->m_flushPolicy);
+            }
+            // the zeroth dataset (the "hidden plot") is data-only channel 0
+            this->openChannel("dataset0");
+            if (this->swmr())
+                this->m_storage->startSWMR();
+            if (this->m_segmentBytes > 0 || this->m_segmentDuration.count() > 0) {
+                this->m_index = std::make_shared<SegmentIndex>(path);
+                this->m_index->add(path, std::chrono::system_clock::now());
             }
+            if (this->m_journalEnabled)
+                this->m_journal->open(std::filesystem::path{path}.concat(".journal"), datasets);
         } catch (const std::runtime_error& e) {
             this->m_datasets.clear();
-            auto status = H5Fclose(this->m_fileID);
-            this->m_fileID = H5I_INVALID_HID;
-            auto message = QString{"error creating dataset: "}.append(e.what());
-            if (status < 0)
-                message.append(" (failed to close HDF5 file while handling error)");
+            this->m_channels.clear();
+            this->m_compressor.reset();
+            this->m_index.reset();
+            auto message = QString{"error initializing data file: "}.append(e.what());
+            try {
+                this->m_storage->close();
+            } catch (const std::runtime_error&) {
+                message.append(" (failed to close data file while handling error)");
+            }
+            this->m_storage.reset();
             emit this->opened(true, message);
             return;
         }
+
+        this->m_path = path;
+        this->m_segment = 0;
+        this->m_segmentOpened = std::chrono::steady_clock::now();
+        this->m_segmentEmpty = true;
+        if (this->m_flushPolicy.age.count() > 0)
+            this->m_flushTimer.start(this->m_flushPolicy.age);
     }
 
     emit this->opened(false, "");
@@ -174,17 +363,49 @@ DataManager::open(const std::filesystem::path& path, std::size_t datasets)
 void
 DataManager::close()
 {
+    // writes queued before the close are still part of the run
+    this->drain();
     if (this->m_enabled) {
+        this->m_flushTimer.stop();
         this->m_datasets.clear();
-
-        if (this->m_fileID != H5I_INVALID_HID) {
-            auto status = H5Fclose(this->m_fileID);
-            this->m_fileID = H5I_INVALID_HID;
-            if (status < 0) {
-                emit this->closed(true, "failed to close HDF5 file");
-                return;
+        this->m_channels.clear();
+        this->m_tables.clear();
+        this->m_compressor.reset();
+
+        QString message;
+        if (this->m_storage) {
+            auto storage = std::move(this->m_storage);
+            try {
+                storage->close();
+            } catch (const std::runtime_error& e) {
+                message = e.what();
             }
         }
+        // earlier segments still being closed in the background
+        auto errors = this->collectFinalised(true);
+        if (!errors.isEmpty())
+            message.append(message.isEmpty() ? "" : "; ").append(errors);
+        if (auto index = std::move(this->m_index)) {
+            try {
+                index->end(this->m_segment, std::chrono::system_clock::now());
+                if (message.isEmpty())
+                    index->setClosed(this->m_segment);
+            } catch (const std::runtime_error& e) {
+                message.append(message.isEmpty() ? "" : "; ").append(e.what());
+            }
+        }
+        if (!message.isEmpty()) {
+            if (this->m_journal->isOpen()) {
+                message.append(" (data journal kept at ")
+                    .append(QString::fromStdString(this->m_journal->path().string()))
+                    .append(")");
+            }
+            this->m_journal->close(false);
+            emit this->closed(true, message);
+            return;
+        }
+        // the data file is complete, the journal is no longer needed
+        this->m_journal->close(true);
     }
 
     emit this->closed(false, "");
@@ -197,6 +418,8 @@ DataManager::write2D(std::size_t plotIdx, double x, double y)
     if (!this->m_enabled) return;
 
     try {
+        if (this->journaled(plotIdx))
+            this->m_journal->append2D(plotIdx, x, y);
         this->m_datasets.at(plotIdx).dataset2D()->write(x, y);
     } catch (const std::out_of_range&) {
         emit this->error(QString{"Error writing data: plot index out of range"});
@@ -212,6 +435,34 @@ DataManager::write2DVec(std::size_t plotIdx, const std::vector<double>& x, const
     if (!this->m_enabled) return;
 
     try {
+        if (this->journaled(plotIdx)) {
+            auto min = x.size() < y.size() ? x.size() : y.size();
+            for (std::size_t i = 0; i < min; ++i)
+                this->m_journal->append2D(plotIdx, x[i], y[i]);
+        }
+        this->m_datasets.at(plotIdx).dataset2D()->write(x, y);
+    } catch (const std::out_of_range&) {
+        emit this->error(QString{"Error writing data: plot index out of range"});
+    } catch (const std::runtime_error& e) {
+        emit this->error(QString{"Error writing data: "}.append(e.what()));
+    }
+}
+
+
+void
+DataManager::write2DMulti(std::size_t plotIdx, const std::vector<double>& x, const std::vector<std::vector<double>>& y)
+{
+    if (!this->m_enabled) return;
+
+    try {
+        if (this->journaled(plotIdx) && !y.empty()) {
+            constexpr auto missing = std::numeric_limits<double>::quiet_NaN();
+            for (std::size_t i = 0; i < x.size(); ++i) {
+                this->m_journal->append2D(plotIdx, x[i], i < y[0].size() ? y[0][i] : missing);
+                for (std::size_t trace = 1; trace < y.size(); ++trace)
+                    this->m_journal->appendTrace(plotIdx, trace, i < y[trace].size() ? y[trace][i] : missing);
+            }
+        }
         this->m_datasets.at(plotIdx).dataset2D()->write(x, y);
     } catch (const std::out_of_range&) {
         emit this->error(QString{"Error writing data: plot index out of range"});
@@ -221,12 +472,53 @@ DataManager::write2DVec(std::size_t plotIdx, const std::vector<double>& x, const
 }
 
 
+/**
+ * @brief Write uniformly sampled 2D data (`x[i] = x0 + i * dx`) to the plot's stream dataset. In
+ * SWMR mode no datasets or attributes can be created once writing has started, so the data is
+ * written as `(x, y)` rows to the plot's 2D dataset instead.
+ * 
+ * @param plotIdx 
+ * @param y 
+ * @param x0 
+ * @param dx 
+ */
+void
+DataManager::write2DStream(std::size_t plotIdx, const std::vector<double>& y, double x0, double dx)
+{
+    if (!this->m_enabled) return;
+
+    try {
+        auto& group = this->m_datasets.at(plotIdx);
+        if (this->journaled(plotIdx) || this->swmr()) {
+            std::vector<double> x(y.size());
+            for (std::size_t i = 0; i < x.size(); ++i)
+                x[i] = x0 + static_cast<double>(i) * dx;
+            if (this->journaled(plotIdx)) {
+                for (std::size_t i = 0; i < x.size(); ++i)
+                    this->m_journal->append2D(plotIdx, x[i], y[i]);
+            }
+            if (this->swmr()) {
+                group.dataset2D()->write(x, y);
+                return;
+            }
+        }
+        group.openStream().write(y, x0, dx);
+    } catch (const std::out_of_range&) {
+        emit this->error(QString{"Error writing data: plot index out of range"});
+    } catch (const std::runtime_error& e) {
+        emit this->error(QString{"Error writing data: "}.append(e.what()));
+    }
+}
+
+
 void
 DataManager::writeCM(std::size_t plotIdx, int x, int y, double value)
 {
     if (!this->m_enabled) return;
 
     try {
+        if (this->journaled(plotIdx))
+            this->m_journal->appendCM(plotIdx, x, y, value);
         this->m_datasets.at(plotIdx).datasetCM()->write(x, y, value);
     } catch (const std::out_of_range&) {
         emit this->error(QString{"Error writing data: plot index out of range"});
@@ -242,6 +534,11 @@ DataManager::writeCMVec(std::size_t plotIdx, int y, const std::vector<double>& r
     if (!this->m_enabled) return;
 
     try {
+        if (this->journaled(plotIdx)) {
+            int x = 0;
+            for (const auto& value : row)
+                this->m_journal->appendCM(plotIdx, x++, y, value);
+        }
         this->m_datasets.at(plotIdx).datasetCM()->write(y, row);
     } catch (const std::out_of_range&) {
         emit this->error(QString{"Error writing data: plot index out of range"});
@@ -257,6 +554,15 @@ DataManager::writeCMFrame(std::size_t plotIdx, const std::vector<std::vector<dou
     if (!this->m_enabled) return;
 
     try {
+        if (this->journaled(plotIdx)) {
+            int y = 0;
+            for (const auto& row : frame) {
+                int x = 0;
+                for (const auto& value : row)
+                    this->m_journal->appendCM(plotIdx, x++, y, value);
+                ++y;
+            }
+        }
         this->m_datasets.at(plotIdx).datasetCM()->write(frame);
     } catch (const std::out_of_range&) {
         emit this->error(QString{"Error writing data: plot index out of range"});
@@ -266,17 +572,320 @@ DataManager::writeCMFrame(std::size_t plotIdx, const std::vector<std::vector<dou
 }
 
 
+/**
+ * @brief Append a row pushed to a waterfall color map to the plot's waterfall dataset. In SWMR mode
+ * (no datasets can be created once writing has started) the row is written as color map cells
+ * instead, with the row's index over the run as the y-value.
+ * 
+ * @param plotIdx 
+ * @param row 
+ */
+void
+DataManager::writeCMPush(std::size_t plotIdx, const std::vector<double>& row)
+{
+    if (!this->m_enabled) return;
+
+    try {
+        auto& group = this->m_datasets.at(plotIdx);
+        auto y = static_cast<int>(group.nextWaterfallRow());
+        if (this->journaled(plotIdx)) {
+            int x = 0;
+            for (const auto& value : row)
+                this->m_journal->appendCM(plotIdx, x++, y, value);
+        }
+        if (this->swmr())
+            group.datasetCM()->write(y, row);
+        else
+            group.openWaterfall(row.size()).write(row);
+    } catch (const std::out_of_range&) {
+        emit this->error(QString{"Error writing data: plot index out of range"});
+    } catch (const std::runtime_error& e) {
+        emit this->error(QString{"Error writing data: "}.append(e.what()));
+    }
+}
+
+
+/**
+ * @brief Append rows to a record table, creating the table on its first record. In SWMR mode no
+ * datasets can be created once writing has started, so there are no tables.
+ * 
+ * @param table 
+ * @param columns 
+ */
+void
+DataManager::writeTable(const std::string& table, const std::vector<exa::RecordColumn>& columns)
+{
+    if (!this->m_enabled) return;
+
+    try {
+        auto it = this->m_tables.find(table);
+        if (it == this->m_tables.end()) {
+            if (this->m_storage->frozen())
+                throw std::runtime_error{"tables can't be created in SWMR mode"};
+            it = this->m_tables.try_emplace(table, *this->m_storage, table, columns, this->m_compressor.get()).first;
+            it->second.setFlushPolicy(this->m_flushPolicy);
+        }
+        it->second.write(columns);
+    } catch (const std::runtime_error& e) {
+        emit this->error(QString{"Error writing record: "}.append(e.what()));
+    }
+}
+
+
 void
 DataManager::flush(std::size_t plotIdx)
 {
     if (!this->m_enabled) return;
 
+    this->drain();
+
     try {
-        this->m_datasets.at(plotIdx).dataset2D()->flush();
-        this->m_datasets.at(plotIdx).datasetCM()->flush();
+        this->m_datasets.at(plotIdx).flush();
+        this->m_journal->sync();
     } catch (const std::out_of_range&) {
         emit this->error(QString{"Error flushing data: plot index out of range"});
     } catch (const std::runtime_error& e) {
         emit this->error(QString{"Error flushing data: "}.append(e.what()));
     }
 }
+
+
+/**
+ * @brief Write the data queued by the script thread (see `DataQueue`).
+ * 
+ */
+void
+DataManager::drain()
+{
+    DataWrite write;
+    do {
+        for (bool first = true; this->m_queue.pop(write); first = false) {
+            // (before writing, so that the policy never leaves a segment empty)
+            if (first)
+                this->rotateIfDue();
+            if (write.type != DataWrite::ROTATE)
+                this->m_segmentEmpty = false;
+            auto plotIdx = write.plotIdx;
+            if (write.channel) {
+                // an unknown channel maps past the last group (i.e. out of range)
+                plotIdx = plotIdx < this->m_channels.size() ? this->m_channels[plotIdx] : this->m_datasets.size();
+                // writes to a channel that couldn't be created are dropped (the failure was reported)
+                if (plotIdx == NO_GROUP)
+                    continue;
+            }
+            switch (write.type) {
+            case DataWrite::TWODIMEN: this->write2D(plotIdx, write.x, write.y); break;
+            case DataWrite::TWODIMEN_VEC: this->write2DVec(plotIdx, write.xs, write.ys); break;
+            case DataWrite::TWODIMEN_MULTI: this->write2DMulti(plotIdx, write.xs, write.traces); break;
+            case DataWrite::TWODIMEN_STREAM: this->write2DStream(plotIdx, write.ys, write.x, write.y); break;
+            case DataWrite::COLORMAP: this->writeCM(plotIdx, write.col, write.row, write.x); break;
+            case DataWrite::COLORMAP_VEC: this->writeCMVec(plotIdx, write.row, write.ys); break;
+            case DataWrite::COLORMAP_FRAME: this->writeCMFrame(plotIdx, write.traces); break;
+            case DataWrite::COLORMAP_PUSH: this->writeCMPush(plotIdx, write.ys); break;
+            case DataWrite::TABLE: this->writeTable(write.name, write.columns); break;
+            case DataWrite::ROTATE: this->rotate(); break;
+            case DataWrite::CHANNEL:
+                if (!this->m_enabled) break;
+                try {
+                    this->openChannel(write.name);
+                } catch (const std::runtime_error& e) {
+                    // keeps the IDs of the channels after it in step with the interface's
+                    this->m_channels.push_back(NO_GROUP);
+                    emit this->error(QString{"Error creating channel: "}.append(e.what()));
+                }
+                break;
+            }
+        }
+    } while (!this->m_queue.idle());
+
+    if (!this->m_finalising.empty()) {
+        auto errors = this->collectFinalised(false);
+        if (!errors.isEmpty())
+            emit this->error(QString{"Error closing data file segment: "}.append(errors));
+    }
+}
+
+
+/**
+ * @brief Start the next segment of the data file: the next file is created with the same datasets
+ * and writing carries on to it right away, while the current one is flushed and closed on a
+ * background thread. If the next file can't be created, writing carries on to the current one.
+ * 
+ */
+void
+DataManager::rotate()
+{
+    if (!this->m_enabled || !this->m_storage) return;
+
+    auto segment = this->m_segment + 1;
+    DataSegment next;
+    try {
+        next.storage = DataStorage::create(this->m_format);
+        next.storage->open(SegmentIndex::segmentPath(this->m_path, segment), this->swmr());
+        if (this->m_compressor)
+            next.compressor = std::make_unique<ChunkCompressor>(this->m_compression, this->m_compressionWorkers);
+        for (const auto& group : this->m_datasets)
+            next.datasets.push_back(group.next(*next.storage, next.compressor.get()));
+        if (this->swmr())
+            next.storage->startSWMR();
+    } catch (const std::runtime_error& e) {
+        emit this->error(QString{"Error rotating data file: "}.append(e.what()));
+        return;
+    }
+
+    // (tables are created again on their next record)
+    std::swap(this->m_storage, next.storage);
+    std::swap(this->m_compressor, next.compressor);
+    std::swap(this->m_datasets, next.datasets);
+    std::swap(this->m_tables, next.tables);
+    this->m_segment = segment;
+    this->m_segmentOpened = std::chrono::steady_clock::now();
+    this->m_segmentEmpty = true;
+
+    try {
+        auto now = std::chrono::system_clock::now();
+        if (!this->m_index) {
+            // an explicit rotation of a data file without a rotation policy
+            this->m_index = std::make_shared<SegmentIndex>(this->m_path);
+            this->m_index->add(this->m_path, now);
+        }
+        this->m_index->end(segment - 1, now);
+        this->m_index->add(SegmentIndex::segmentPath(this->m_path, segment), now);
+    } catch (const std::runtime_error& e) {
+        emit this->error(QString{"Error writing data file segment index: "}.append(e.what()));
+    }
+
+    this->m_finalising.push_back(std::async(
+        std::launch::async,
+        [retired = std::move(next), index = this->m_index, previous = segment - 1]() mutable {
+            auto error = finaliseSegment(retired);
+            try {
+                if (error.empty())
+                    index->setClosed(previous);
+            } catch (const std::runtime_error& e) {
+                error = e.what();
+            }
+            return error;
+        }
+    ));
+}
+
+
+/**
+ * @brief Rotate the data file if the segment being written has reached the size or age limit of
+ * the rotation policy (and has been written to).
+ * 
+ */
+void
+DataManager::rotateIfDue()
+{
+    if (!this->m_enabled || !this->m_storage || this->m_segmentEmpty) return;
+
+    if ((this->m_segmentDuration.count() > 0
+            && std::chrono::steady_clock::now() - this->m_segmentOpened >= this->m_segmentDuration)
+        || (this->m_segmentBytes > 0 && this->m_storage->size() >= this->m_segmentBytes))
+        this->rotate();
+}
+
+
+/**
+ * @brief Collect the results of the segments closed in the background.
+ * 
+ * @param wait wait for the segments still being closed (otherwise only collect those done)
+ * @return QString the errors closing the segments (empty if there were none)
+ */
+QString
+DataManager::collectFinalised(bool wait)
+{
+    QString errors;
+    for (auto it = this->m_finalising.begin(); it != this->m_finalising.end();) {
+        if (!wait && it->wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        auto error = it->get();
+        if (!error.empty())
+            errors.append(errors.isEmpty() ? "" : "; ").append(error.c_str());
+        it = this->m_finalising.erase(it);
+    }
+    return errors;
+}
+
+
+/**
+ * @brief Create the dataset group of the next data-only channel. Channels have no plot: they're
+ * only ever written to the data file, and they aren't journaled. Channel IDs are handed out by the
+ * interface in order, so a channel that fails to be created still takes up its ID (`NO_GROUP`).
+ * 
+ * @param name 
+ */
+void
+DataManager::openChannel(const std::string& name)
+{
+    // no datasets can be created once SWMR writing has started (the hidden plot is created before)
+    if (this->m_storage->frozen())
+        throw std::runtime_error{"channels can't be created in SWMR mode"};
+    this->m_datasets.push_back(DataSetGroup{
+        *this->m_storage, name, this->m_storageType, this->m_compressor.get(), this->m_summary});
+    this->m_datasets.back().setFlushOnWrite(this->swmr());
+    this->m_datasets.back().setFlushPolicy(this->m_flushPolicy);
+    this->m_channels.push_back(this->m_datasets.size() - 1);
+}
+
+
+/**
+ * @brief Whether the data file is written in SWMR mode (only HDF5 files have one: raw data files
+ * can always be read while they're written).
+ * 
+ * @return true 
+ * @return false 
+ */
+bool
+DataManager::swmr() const
+{
+    return this->m_swmr && this->m_format == exa::StorageFormat::HDF5;
+}
+
+
+/**
+ * @brief Whether writes to a dataset group go to the journal (only the plots' do).
+ * 
+ * @param plotIdx 
+ * @return true 
+ * @return false 
+ */
+bool
+DataManager::journaled(std::size_t plotIdx) const
+{
+    return this->m_journal->isOpen() && (this->m_channels.empty() || plotIdx < this->m_channels.front());
+}
+
+
+/**
+ * @brief Flush any data still sitting in the dataset buffers (the flush timer fires once per
+ * maximum buffer age, so no data stays buffered for longer than that).
+ * 
+ */
+void
+DataManager::flushBuffered()
+{
+    try {
+        for (auto& group : this->m_datasets) {
+            if (!group.dataset2D()->empty())
+                group.dataset2D()->flush();
+            if (!group.datasetCM()->empty())
+                group.datasetCM()->flush();
+            if (group.datasetStream() && !group.datasetStream()->empty())
+                group.datasetStream()->flush();
+            if (group.datasetWaterfall() && !group.datasetWaterfall()->empty())
+                group.datasetWaterfall()->flush();
+        }
+        for (auto& [name, table] : this->m_tables) {
+            if (!table.empty())
+                table.flush();
+        }
+        this->m_journal->sync();
+    } catch (const std::runtime_error& e) {
+        emit this->error(QString{"Error flushing data: "}.append(e.what()));
+    }
+}
@@ -11,59 +11,77 @@
 #include "hdf5.h"
 
 #include <QObject>
+#include <QTimer>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <filesystem>
+#include <future>
+#include <limits>
+#include <map>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "dataconfig.hpp"
+#include "datacompressor.hpp"
+#include "dataqueue.hpp"
+#include "datarecord.hpp"
+#include "datasegments.hpp"
+#include "datastorage.hpp"
 
 
+class DataJournal;
+
+
+/**
+ * @brief Bounds on the data buffered by a dataset before it's written to the file. The row and
+ * byte limits are enforced by the datasets as data is written; the age limit is enforced by the
+ * data manager's flush timer.
+ * 
+ */
+struct FlushPolicy
+{
+    std::size_t rows = 4096;
+    std::size_t bytes = 0;                      // 0: no limit
+    std::chrono::milliseconds age{0};           // 0: no limit
+};
+
+
+/**
+ * @brief Buffered dataset of rows of `T`, written to the data file through the storage backend's
+ * dataset (`StoredDataset`). Rows are buffered up to the limits of the flush policy, unless the
+ * backend's appends are as cheap as buffering.
+ * 
+ * @tparam T element type (as stored in the file, i.e. the memory and file datatypes must have the
+ * same layout: the storage datatypes are little-endian)
+ */
 template<typename T>
 class DataSet
 {
 public:
-    DataSet(hid_t fileID, const std::string& name, hsize_t numElements, hid_t datatype)
+    DataSet(DataStorage& storage, const std::string& name, std::size_t numElements, hid_t datatype,
+            ChunkCompressor* compressor, bool growable = false, std::size_t chunkRows = 4096)
     : m_valid{true}
-    , m_datatype{datatype}
+    , m_flushOnWrite{false}
+    , m_rowElements{numElements}
+    , m_flushPolicy{}
+    , m_dataset{}
     {
-        hsize_t chunkDim[] = {4096, numElements};
-        auto propertyList = H5Pcreate(H5P_DATASET_CREATE);
-        if (propertyList == H5I_INVALID_HID) {
-            throw std::runtime_error{"error creating HDF5 property list"};
-        }
-        if (H5Pset_chunk(propertyList, 2, chunkDim) < 0) {
-            H5Pclose(propertyList);
-            throw std::runtime_error{"error setting chunk property"};
-        }
-
-        hsize_t dim[] = {0, numElements};
-        hsize_t maxDim[] = {H5S_UNLIMITED, numElements};
-        auto dataspace = H5Screate_simple(2, dim, maxDim);
-        if (dataspace == H5I_INVALID_HID) {
-            H5Pclose(propertyList);
-            throw std::runtime_error{"error creating HDF5 dataspace"};
-        }
-
-        this->m_dataset = H5Dcreate(
-            fileID,
-            name.c_str(),
-            datatype,
-            dataspace,
-            H5P_DEFAULT,
-            propertyList,
-            H5P_DEFAULT
-        );
-        assert(H5Sclose(dataspace) >= 0);
-        assert(H5Pclose(propertyList) >= 0);
-        if (this->m_dataset == H5I_INVALID_HID) {
-            throw std::runtime_error{"error creating HDF5 dataset"};
+        if constexpr (std::is_floating_point_v<T>) {
+            // columns added to a growable dataset read as NaN for the rows written before them
+            T fillValue = std::numeric_limits<T>::quiet_NaN();
+            this->m_dataset = storage.createDataset(name, datatype, numElements, growable, &fillValue, chunkRows, compressor);
+        } else {
+            this->m_dataset = storage.createDataset(name, datatype, numElements, growable, nullptr, chunkRows, compressor);
         }
     }
 
@@ -73,11 +91,13 @@ public:
 
     DataSet(DataSet&& other)
         : m_valid{other.m_valid}
+        , m_flushOnWrite{other.m_flushOnWrite}
+        , m_rowElements{other.m_rowElements}
+        , m_flushPolicy{other.m_flushPolicy}
         , m_buffer{std::move(other.m_buffer)}
-        , m_dataset{other.m_dataset}
+        , m_dataset{std::move(other.m_dataset)}
     {
         other.m_valid = false;
-        other.m_dataset = H5I_INVALID_HID;
     }
 
     DataSet& operator=(DataSet&&) = delete;
@@ -90,123 +110,973 @@ public:
             } catch (std::runtime_error const& e) {
                 std::cerr << "Failed to flush dataset during destruction: " << e.what() << '\n';
             }
-            H5Dclose(this->m_dataset);
         }
     }
 
     void flush()
     {
         this->writeToDataset();
-        if (H5Dflush(this->m_dataset) < 0)
-            throw std::runtime_error{"failed to flush dataset"};
+        this->m_dataset->flush();
+    }
+
+    /**
+     * @brief Flush the dataset every time the buffer is written to it (i.e. once per block of
+     * buffered data) rather than only on explicit flushes. Used in SWMR mode so that readers see
+     * new data as soon as it's written.
+     * 
+     * @param enable 
+     */
+    void setFlushOnWrite(bool enable)
+    {
+        this->m_flushOnWrite = enable;
+    }
+
+    void setFlushPolicy(const FlushPolicy& policy)
+    {
+        this->m_flushPolicy = policy;
+    }
+
+    bool empty() const
+    {
+        return this->m_buffer.empty() && !this->m_dataset->pending();
+    }
+
+    /**
+     * @brief Widen the rows of a growable dataset. Buffered rows are written out first (at their
+     * current width); the rows already in the dataset read the fill value in the new columns.
+     * 
+     * @param elements 
+     */
+    void setRowElements(std::size_t elements)
+    {
+        this->writeToDataset();
+        this->m_dataset->setRowElements(elements);
+        this->m_rowElements = elements;
     }
 
 protected:
+    /**
+     * @brief Write the buffer to the dataset if it has reached the row or byte limit of the flush
+     * policy (or right away, if the backend doesn't buffer). Called after each write to the buffer.
+     * 
+     */
+    void writeIfFull()
+    {
+        auto rows = this->m_buffer.size() / this->m_rowElements;
+        auto bytes = this->m_buffer.size() * sizeof(T);
+        if (!this->m_dataset->buffered() || rows >= this->m_flushPolicy.rows
+            || (this->m_flushPolicy.bytes && bytes >= this->m_flushPolicy.bytes))
+            this->writeToDataset();
+    }
+
     void writeToDataset()
     {
         if (this->m_buffer.size() == 0)
             return;
 
-        auto dataspaceID = H5Dget_space(this->m_dataset);
-        if (dataspaceID == H5I_INVALID_HID)
-            throw std::runtime_error{"failed to get dataspace (initial)"};
-
-        // retrieve current dataset dimensions
-        hsize_t currentDims[2] = {0};
-        int ndims = H5Sget_simple_extent_dims(dataspaceID, currentDims, NULL);
-        H5Sclose(dataspaceID);
-        if (ndims < 0)
-            throw std::runtime_error{"failed to retrieve dataset dimensions"};
-
-        hsize_t length = static_cast<hsize_t>(this->m_buffer.size()) / currentDims[1];
-
-        // extend the dataset
-        hsize_t updatedDims[2] = {currentDims[0] + length, currentDims[1]};
-        if (H5Dset_extent(this->m_dataset, updatedDims) < 0)
-            throw std::runtime_error{"failed to extend dataset"};
-
-        // select the extended region
-        dataspaceID = H5Dget_space(this->m_dataset);
-        if (dataspaceID == H5I_INVALID_HID)
-            throw std::runtime_error{"failed to get dataspace (extended)"};
-        hsize_t start[] = {currentDims[0], 0};
-        hsize_t count[] = {length, currentDims[1]};
-        if (H5Sselect_hyperslab(dataspaceID, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
-            throw std::runtime_error{"failed to select extended dataspace"};
-
-        auto memspaceID = H5Screate_simple(2, count, NULL);
-        if (memspaceID == H5I_INVALID_HID) {
-            H5Sclose(dataspaceID);
-            throw std::runtime_error{"failed to create memory dataspace"};
-        }
-
-        // write the buffer to the extended region of the dataset
-        auto status = H5Dwrite(
-            this->m_dataset,
-            this->m_datatype,
-            memspaceID,
-            dataspaceID,
-            H5P_DEFAULT,
-            this->m_buffer.data()
-        );
-
-        // TODO: check close returns?
-        H5Sclose(dataspaceID);
-        H5Sclose(memspaceID);
-        if (status < 0)
-            throw std::runtime_error{"failed to write buffer to dataset"};
+        this->m_dataset->append(this->m_buffer.data(), this->m_buffer.size() / this->m_rowElements);
+        this->appended(this->m_buffer.data(), this->m_buffer.size() / this->m_rowElements);
         this->m_buffer.clear();
+
+        if (this->m_flushOnWrite)
+            this->m_dataset->flush();
     }
 
+    // called with the rows just appended to the dataset (at the current row width)
+    virtual void appended(const T* /* rows */, std::size_t /* count */) {}
+
     bool m_valid;
+    bool m_flushOnWrite;
+    std::size_t m_rowElements;
+    FlushPolicy m_flushPolicy;
     std::vector<T> m_buffer;
-    hid_t m_dataset;
-    hid_t m_datatype;
+    std::unique_ptr<StoredDataset> m_dataset;
+};
+
+
+/**
+ * @brief Convert a value to its storage type. Integer conversions round to nearest and saturate
+ * (NaN is stored as 0). Written branch-free so that loops over it vectorize.
+ * 
+ * @tparam T storage type
+ * @param value 
+ * @return T 
+ */
+template<typename T>
+inline T
+toStorage(double value)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return static_cast<T>(value);
+    } else {
+        constexpr double lowest = static_cast<double>(std::numeric_limits<T>::lowest());
+        constexpr double max = static_cast<double>(std::numeric_limits<T>::max());
+        value = value == value ? value : 0.0;
+        value = std::min(std::max(value, lowest), max);
+        return static_cast<T>(value + std::copysign(0.5, value));
+    }
+}
+
+
+/**
+ * @brief Convert and interleave x/y columns into (x, y) rows of the storage type.
+ * 
+ * @tparam T storage type
+ * @param x 
+ * @param y 
+ * @param length 
+ * @param out destination for 2 * length values
+ */
+template<typename T>
+inline void
+toStorageRows(const double* x, const double* y, std::size_t length, T* out)
+{
+    for (std::size_t i = 0; i < length; ++i) {
+        out[2 * i] = toStorage<T>(x[i]);
+        out[2 * i + 1] = toStorage<T>(y[i]);
+    }
+}
+
+
+/**
+ * @brief HDF5 (file) datatype of a storage type.
+ * 
+ * @tparam T storage type
+ * @return hid_t 
+ */
+template<typename T>
+inline hid_t
+storageDatatype()
+{
+    if constexpr (std::is_same_v<T, double>)
+        return H5T_IEEE_F64LE;
+    else if constexpr (std::is_same_v<T, float>)
+        return H5T_IEEE_F32LE;
+    else if constexpr (std::is_same_v<T, std::int16_t>)
+        return H5T_STD_I16LE;
+    else if constexpr (std::is_same_v<T, std::int32_t>)
+        return H5T_STD_I32LE;
+    else if constexpr (std::is_same_v<T, std::uint16_t>)
+        return H5T_STD_U16LE;
+    else if constexpr (std::is_same_v<T, std::int64_t>)
+        return H5T_STD_I64LE;
+    else if constexpr (std::is_same_v<T, std::uint8_t>)
+        return H5T_STD_U8LE;
+    else
+        static_assert(!sizeof(T), "unsupported storage type");
+}
+
+
+/**
+ * @brief Multi-resolution min/max summary of a 2D dataset, so that an overview of a large dataset
+ * can be read without reading all of its rows. Level `i` is a dataset
+ * (`<name>.twodimen.summary<factor^i>`) with a row per `factor^i` rows of the 2D dataset, holding
+ * the range of each of their columns: `(x_min, x_max, y0_min, y0_max, ..., yN_min, yN_max)`
+ * (missing values are ignored); its `rows` attribute is the number of rows summarized per row. The
+ * levels are built incrementally as rows are appended to the 2D dataset, each from the one below
+ * it. The last, partial row of each level is only written once the dataset is closed (see
+ * `finish`). All levels are created up front, since no datasets may be created in SWMR mode.
+ * 
+ * @tparam T storage type
+ */
+template<typename T>
+class DataSetSummary
+{
+public:
+    // the highest level summarizes at most this many rows per row
+    constexpr static std::uint64_t MAX_ROWS = std::uint64_t{1} << 32;
+    constexpr static std::size_t CHUNK_ROWS = 256;
+
+    DataSetSummary(DataStorage& storage, const std::string& name, std::size_t factor,
+                   ChunkCompressor* compressor = nullptr)
+        : m_factor{factor}
+        , m_columns{2}
+    {
+        for (std::uint64_t rows = factor; ; rows *= factor) {
+            auto levelName = name + ".summary" + std::to_string(rows);
+            this->m_levels.push_back(std::make_unique<Level>(storage, levelName, rows, compressor));
+            if (rows > MAX_ROWS / factor)
+                break;
+        }
+    }
+
+    /**
+     * @brief Add rows of the 2D dataset to the summary. The summary is widened along with the
+     * dataset; the rows summarized before read the dataset's missing value in the new columns.
+     * 
+     * @param rows 
+     * @param count 
+     * @param columns 
+     */
+    void add(const T* rows, std::size_t count, std::size_t columns)
+    {
+        if (columns > this->m_columns)
+            this->widen(columns);
+        auto& level = *this->m_levels.front();
+        for (std::size_t i = 0; i < count; ++i) {
+            auto row = rows + i * columns;
+            for (std::size_t column = 0; column < columns; ++column)
+                level.merge(column, row[column], row[column]);
+            if (++level.count == this->m_factor)
+                this->complete(0);
+        }
+    }
+
+    /**
+     * @brief Write the last, partial row of each level. Called once no more rows will be added.
+     * 
+     */
+    void finish()
+    {
+        for (std::size_t i = 0; i < this->m_levels.size(); ++i) {
+            if (this->m_levels[i]->count > 0)
+                this->complete(i);
+        }
+    }
+
+    void flush()
+    {
+        for (auto& level : this->m_levels)
+            level->flush();
+    }
+
+    bool empty() const
+    {
+        for (const auto& level : this->m_levels) {
+            if (!level->empty())
+                return false;
+        }
+        return true;
+    }
+
+    void setFlushOnWrite(bool enable)
+    {
+        for (auto& level : this->m_levels)
+            level->setFlushOnWrite(enable);
+    }
+
+    void setFlushPolicy(const FlushPolicy& policy)
+    {
+        for (auto& level : this->m_levels)
+            level->setFlushPolicy(policy);
+    }
+
+private:
+    class Level : public DataSet<T>
+    {
+    public:
+        Level(DataStorage& storage, const std::string& name, std::uint64_t rows, ChunkCompressor* compressor)
+            : DataSet<T>{storage, name, 4, storageDatatype<T>(), compressor, true, CHUNK_ROWS}
+            , count{0}
+            , bounds(4)
+        {
+            this->m_dataset->setAttribute("rows", std::vector<std::uint64_t>{rows});
+        }
+
+        // merge a column's range into the row being built
+        void merge(std::size_t column, T min, T max)
+        {
+            auto& lower = this->bounds[2 * column];
+            auto& upper = this->bounds[2 * column + 1];
+            if (this->count == 0) {
+                lower = min;
+                upper = max;
+                return;
+            }
+            // NaN (missing) values never replace a value
+            if (min < lower || lower != lower)
+                lower = min;
+            if (max > upper || upper != upper)
+                upper = max;
+        }
+
+        void write()
+        {
+            this->m_buffer.insert(this->m_buffer.end(), this->bounds.begin(), this->bounds.end());
+            this->count = 0;
+            this->writeIfFull();
+        }
+
+        void widen(std::size_t columns)
+        {
+            this->setRowElements(2 * columns);
+            this->bounds.resize(2 * columns, toStorage<T>(std::numeric_limits<double>::quiet_NaN()));
+        }
+
+        std::size_t count;          // rows merged into the row being built
+        std::vector<T> bounds;      // the row being built
+    };
+
+    /**
+     * @brief Write the row being built by a level and merge it into the level above.
+     * 
+     * @param index 
+     */
+    void complete(std::size_t index)
+    {
+        auto& level = *this->m_levels[index];
+        if (index + 1 < this->m_levels.size()) {
+            auto& next = *this->m_levels[index + 1];
+            for (std::size_t column = 0; column < this->m_columns; ++column)
+                next.merge(column, level.bounds[2 * column], level.bounds[2 * column + 1]);
+            level.write();
+            if (++next.count == this->m_factor)
+                this->complete(index + 1);
+        } else {
+            level.write();
+        }
+    }
+
+    void widen(std::size_t columns)
+    {
+        for (auto& level : this->m_levels)
+            level->widen(columns);
+        this->m_columns = columns;
+    }
+
+    std::size_t m_factor;
+    std::size_t m_columns;      // of the 2D dataset
+    std::vector<std::unique_ptr<Level>> m_levels;
+};
+
+
+class DataSet2D
+{
+public:
+    virtual ~DataSet2D() = default;
+
+    static std::unique_ptr<DataSet2D> create(DataStorage& storage, const std::string& name, exa::StorageType type,
+                                             ChunkCompressor* compressor = nullptr, std::size_t summary = 0);
+
+    virtual void write(double x, double y) = 0;
+    virtual void write(const std::vector<double>& x, const std::vector<double>& y) = 0;
+    virtual void write(const std::vector<double>& x, const std::vector<std::vector<double>>& y) = 0;
+
+    virtual std::size_t traces() const = 0;
+    virtual void flush() = 0;
+    virtual bool empty() const = 0;
+    virtual void setFlushOnWrite(bool enable) = 0;
+    virtual void setFlushPolicy(const FlushPolicy& policy) = 0;
+};
+
+
+/**
+ * @brief 2D dataset of `(x, y0, ..., yN)` rows: the x-values are stored once for all of the
+ * plot's traces. The dataset starts out with a single trace and is widened when data for more
+ * traces is written; missing values (e.g. rows written with fewer traces) are stored as NaN
+ * (or 0 for integer storage types). With a summary factor, the dataset is summarized alongside
+ * (see `DataSetSummary`).
+ * 
+ * @tparam T storage type
+ */
+template<typename T>
+class TypedDataSet2D : public DataSet2D, public DataSet<T>
+{
+public:
+    TypedDataSet2D(DataStorage& storage, const std::string& name, ChunkCompressor* compressor = nullptr,
+                   std::size_t summary = 0)
+        : DataSet<T>{storage, name + ".twodimen", 2, storageDatatype<T>(), compressor, true}
+        , m_summary{}
+    {
+        if (summary > 0)
+            this->m_summary = std::make_unique<DataSetSummary<T>>(storage, name + ".twodimen", summary, compressor);
+    }
+
+    ~TypedDataSet2D()
+    {
+        if (this->m_valid && this->m_summary) {
+            try {
+                this->writeToDataset();
+                this->m_summary->finish();
+            } catch (std::runtime_error const& e) {
+                std::cerr << "Failed to write dataset summary during destruction: " << e.what() << '\n';
+            }
+        }
+    }
+
+    void write(double x, double y) override
+    {
+        this->m_buffer.push_back(toStorage<T>(x));
+        this->m_buffer.push_back(toStorage<T>(y));
+        this->pad(1);
+        this->writeIfFull();
+    }
+
+    void write(const std::vector<double>& x, const std::vector<double>& y) override
+    {
+        auto min = x.size() < y.size() ? x.size() : y.size();
+        if (this->m_rowElements != 2) {
+            for (std::size_t i = 0; i < min; ++i) {
+                this->m_buffer.push_back(toStorage<T>(x[i]));
+                this->m_buffer.push_back(toStorage<T>(y[i]));
+                this->pad(1);
+            }
+            this->writeIfFull();
+            return;
+        }
+        auto offset = this->m_buffer.size();
+        this->m_buffer.resize(offset + 2 * min);
+        toStorageRows(x.data(), y.data(), min, this->m_buffer.data() + offset);
+        this->writeIfFull();
+    }
+
+    void write(const std::vector<double>& x, const std::vector<std::vector<double>>& y) override
+    {
+        if (1 + y.size() > this->m_rowElements)
+            this->setRowElements(1 + y.size());
+
+        auto width = this->m_rowElements;
+        auto offset = this->m_buffer.size();
+        this->m_buffer.resize(offset + width * x.size(), toStorage<T>(std::numeric_limits<double>::quiet_NaN()));
+        auto rows = this->m_buffer.data() + offset;
+        for (std::size_t i = 0; i < x.size(); ++i)
+            rows[i * width] = toStorage<T>(x[i]);
+        for (std::size_t trace = 0; trace < y.size(); ++trace) {
+            auto length = std::min(x.size(), y[trace].size());
+            for (std::size_t i = 0; i < length; ++i)
+                rows[i * width + 1 + trace] = toStorage<T>(y[trace][i]);
+        }
+        this->writeIfFull();
+    }
+
+    std::size_t traces() const override { return this->m_rowElements - 1; }
+
+    void flush() override
+    {
+        DataSet<T>::flush();
+        if (this->m_summary)
+            this->m_summary->flush();
+    }
+
+    bool empty() const override
+    {
+        return DataSet<T>::empty() && (!this->m_summary || this->m_summary->empty());
+    }
+
+    void setFlushOnWrite(bool enable) override
+    {
+        DataSet<T>::setFlushOnWrite(enable);
+        if (this->m_summary)
+            this->m_summary->setFlushOnWrite(enable);
+    }
+
+    void setFlushPolicy(const FlushPolicy& policy) override
+    {
+        DataSet<T>::setFlushPolicy(policy);
+        if (this->m_summary)
+            this->m_summary->setFlushPolicy(policy);
+    }
+
+protected:
+    void appended(const T* rows, std::size_t count) override
+    {
+        if (this->m_summary)
+            this->m_summary->add(rows, count, this->m_rowElements);
+    }
+
+private:
+    /**
+     * @brief Fill the rest of the row being written with missing values.
+     * 
+     * @param traces number of traces already written to the row
+     */
+    void pad(std::size_t traces)
+    {
+        for (auto i = 1 + traces; i < this->m_rowElements; ++i)
+            this->m_buffer.push_back(toStorage<T>(std::numeric_limits<double>::quiet_NaN()));
+    }
+
+    std::unique_ptr<DataSetSummary<T>> m_summary;
+};
+
+
+class DataSetStream
+{
+public:
+    virtual ~DataSetStream() = default;
+
+    static std::unique_ptr<DataSetStream> create(DataStorage& storage, const std::string& name, exa::StorageType type,
+                                                 ChunkCompressor* compressor = nullptr);
+
+    virtual void write(const std::vector<double>& y, double x0, double dx) = 0;
+
+    virtual void flush() = 0;
+    virtual bool empty() const = 0;
+    virtual void setFlushOnWrite(bool enable) = 0;
+    virtual void setFlushPolicy(const FlushPolicy& policy) = 0;
 };
 
 
-class DataSet2D : public DataSet<double>
+/**
+ * @brief Dataset of uniformly sampled 2D data: only the y-values are stored (one per row), the
+ * x-values are described by the `offset`, `x0` and `dx` attributes. These list the segments of
+ * the data: rows `offset[i]` up to `offset[i + 1]` have x-values `x0[i] + (row - offset[i]) * dx[i]`.
+ * A block of data continuing the last segment (same step, next x-value) extends it; any other
+ * block starts a new segment. The attributes are rewritten on each flush.
+ * 
+ * @tparam T storage type
+ */
+template<typename T>
+class TypedDataSetStream : public DataSetStream, public DataSet<T>
 {
 public:
-    DataSet2D(hid_t fileID, const std::string& name);
+    // keeps the attributes well within the size of an object header
+    constexpr static std::size_t MAX_SEGMENTS = 4096;
+
+    TypedDataSetStream(DataStorage& storage, const std::string& name, ChunkCompressor* compressor = nullptr)
+        : DataSet<T>{storage, name + ".stream", 1, storageDatatype<T>(), compressor}
+        , m_rows{0}
+        , m_dirty{false}
+    {
+    }
 
-    void write(double x, double y);
-    void write(const std::vector<double>& x, const std::vector<double>& y);
+    ~TypedDataSetStream()
+    {
+        if (this->m_valid) {
+            try {
+                this->writeSegments();
+            } catch (std::runtime_error const& e) {
+                std::cerr << "Failed to write stream segments during destruction: " << e.what() << '\n';
+            }
+        }
+    }
+
+    void write(const std::vector<double>& y, double x0, double dx) override
+    {
+        if (y.empty())
+            return;
+        if (!this->continues(x0, dx)) {
+            if (this->m_offsets.size() == MAX_SEGMENTS)
+                throw std::runtime_error{"too many stream segments"};
+            this->m_offsets.push_back(this->m_rows);
+            this->m_x0.push_back(x0);
+            this->m_dx.push_back(dx);
+            this->m_dirty = true;
+        }
+
+        auto offset = this->m_buffer.size();
+        this->m_buffer.resize(offset + y.size());
+        auto values = this->m_buffer.data() + offset;
+        for (std::size_t i = 0; i < y.size(); ++i)
+            values[i] = toStorage<T>(y[i]);
+        this->m_rows += y.size();
+        this->writeIfFull();
+    }
+
+    void flush() override
+    {
+        DataSet<T>::flush();
+        this->writeSegments();
+    }
+
+    bool empty() const override { return DataSet<T>::empty() && !this->m_dirty; }
+    void setFlushOnWrite(bool enable) override { DataSet<T>::setFlushOnWrite(enable); }
+    void setFlushPolicy(const FlushPolicy& policy) override { DataSet<T>::setFlushPolicy(policy); }
+
+private:
+    bool continues(double x0, double dx) const
+    {
+        if (this->m_offsets.empty())
+            return false;
+        auto lastDx = this->m_dx.back();
+        auto next = this->m_x0.back() + static_cast<double>(this->m_rows - this->m_offsets.back()) * lastDx;
+        auto tolerance = 1e-6 * lastDx;
+        return std::abs(dx - lastDx) <= tolerance && std::abs(x0 - next) <= tolerance;
+    }
+
+    void writeSegments()
+    {
+        if (!this->m_dirty)
+            return;
+        this->m_dataset->setAttribute("offset", this->m_offsets);
+        this->m_dataset->setAttribute("x0", this->m_x0);
+        this->m_dataset->setAttribute("dx", this->m_dx);
+        this->m_dirty = false;
+    }
+
+    std::uint64_t m_rows;
+    bool m_dirty;
+    std::vector<std::uint64_t> m_offsets;
+    std::vector<double> m_x0;
+    std::vector<double> m_dx;
 };
 
 
-typedef struct
+class DataSetWaterfall
+{
+public:
+    virtual ~DataSetWaterfall() = default;
+
+    static std::unique_ptr<DataSetWaterfall> create(DataStorage& storage, const std::string& name, exa::StorageType type, std::size_t columns,
+                                                    ChunkCompressor* compressor = nullptr);
+
+    virtual void write(const std::vector<double>& row) = 0;
+
+    virtual void flush() = 0;
+    virtual bool empty() const = 0;
+    virtual void setFlushOnWrite(bool enable) = 0;
+    virtual void setFlushPolicy(const FlushPolicy& policy) = 0;
+};
+
+
+/**
+ * @brief Dataset of the rows pushed to a waterfall color map, in the order they were pushed (one
+ * dataset row per map row). The dataset is widened if a longer row is written; missing values are
+ * stored as NaN (or 0 for integer storage types).
+ * 
+ * @tparam T storage type
+ */
+template<typename T>
+class TypedDataSetWaterfall : public DataSetWaterfall, public DataSet<T>
+{
+public:
+    TypedDataSetWaterfall(DataStorage& storage, const std::string& name, std::size_t columns, ChunkCompressor* compressor = nullptr)
+        : DataSet<T>{
+            storage,
+            name + ".waterfall",
+            static_cast<hsize_t>(std::max<std::size_t>(columns, 1)),
+            storageDatatype<T>(),
+            compressor,
+            true,
+            // chunks of about 64k values
+            static_cast<hsize_t>(std::max<std::size_t>(65536 / std::max<std::size_t>(columns, 1), 1))
+        }
+    {
+    }
+
+    void write(const std::vector<double>& row) override
+    {
+        if (row.size() > this->m_rowElements)
+            this->setRowElements(row.size());
+
+        auto offset = this->m_buffer.size();
+        this->m_buffer.resize(offset + this->m_rowElements, toStorage<T>(std::numeric_limits<double>::quiet_NaN()));
+        auto values = this->m_buffer.data() + offset;
+        for (std::size_t i = 0; i < row.size(); ++i)
+            values[i] = toStorage<T>(row[i]);
+        this->writeIfFull();
+    }
+
+    void flush() override { DataSet<T>::flush(); }
+    bool empty() const override { return DataSet<T>::empty(); }
+    void setFlushOnWrite(bool enable) override { DataSet<T>::setFlushOnWrite(enable); }
+    void setFlushPolicy(const FlushPolicy& policy) override { DataSet<T>::setFlushPolicy(policy); }
+};
+
+
+template<typename T>
+struct CMCell
 {
     int x;
     int y;
-    double value;
-} CMData;
+    T value;
+};
+
+
+typedef CMCell<double> CMData;
 
 
-class DataSetCM : public DataSet<CMData>
+class DataSetCM
 {
 public:
-    DataSetCM(hid_t fileID, const std::string& name);
+    virtual ~DataSetCM() = default;
 
-    void write(int x, int y, double value);
-    void write(int y, const std::vector<double>& row);
-    void write(const std::vector<std::vector<double>>& frame);
+    static std::unique_ptr<DataSetCM> create(DataStorage& storage, const std::string& name, exa::StorageType type,
+                                             ChunkCompressor* compressor = nullptr);
+
+    virtual void write(int x, int y, double value) = 0;
+    virtual void write(int y, const std::vector<double>& row) = 0;
+    virtual void write(const std::vector<std::vector<double>>& frame) = 0;
+
+    virtual void flush() = 0;
+    virtual bool empty() const = 0;
+    virtual void setFlushOnWrite(bool enable) = 0;
+    virtual void setFlushPolicy(const FlushPolicy& policy) = 0;
 };
 
 
+template<typename T>
+class TypedDataSetCM : public DataSetCM, public DataSet<CMCell<T>>
+{
+public:
+    TypedDataSetCM(DataStorage& storage, const std::string& name, ChunkCompressor* compressor = nullptr)
+        : DataSet<CMCell<T>>{storage, name + ".colormap", 1, cmDatatype(), compressor}
+    {
+    }
+
+    void write(int x, int y, double value) override
+    {
+        this->m_buffer.push_back({
+            .x = x,
+            .y = y,
+            .value = toStorage<T>(value)
+        });
+        this->writeIfFull();
+    }
+
+    void write(int y, const std::vector<double>& row) override
+    {
+        this->append(y, row);
+        this->writeIfFull();
+    }
+
+    void write(const std::vector<std::vector<double>>& frame) override
+    {
+        int y = 0;
+        for (const auto& row : frame)
+            this->append(y++, row);
+        this->writeIfFull();
+    }
+
+    void flush() override { DataSet<CMCell<T>>::flush(); }
+    bool empty() const override { return DataSet<CMCell<T>>::empty(); }
+    void setFlushOnWrite(bool enable) override { DataSet<CMCell<T>>::setFlushOnWrite(enable); }
+    void setFlushPolicy(const FlushPolicy& policy) override { DataSet<CMCell<T>>::setFlushPolicy(policy); }
+
+private:
+    static hid_t cmDatatype()
+    {
+        std::lock_guard lock{HDF5Storage::mutex()};
+        auto datatype = H5Tcreate(H5T_COMPOUND, sizeof(CMCell<T>));
+        H5Tinsert(datatype, "x", HOFFSET(CMCell<T>, x), H5T_NATIVE_INT);
+        H5Tinsert(datatype, "y", HOFFSET(CMCell<T>, y), H5T_NATIVE_INT);
+        H5Tinsert(datatype, "z", HOFFSET(CMCell<T>, value), storageDatatype<T>());
+        return datatype;
+    }
+
+    void append(int y, const std::vector<double>& row)
+    {
+        auto offset = this->m_buffer.size();
+        this->m_buffer.resize(offset + row.size());
+        auto cells = this->m_buffer.data() + offset;
+        for (std::size_t x = 0; x < row.size(); ++x) {
+            cells[x].x = static_cast<int>(x);
+            cells[x].y = y;
+            cells[x].value = toStorage<T>(row[x]);
+        }
+    }
+};
+
+
+/**
+ * @brief The datasets of a plot. The stream and waterfall datasets are only created once such data
+ * is written to the plot (see `openStream` and `openWaterfall`), so `datasetStream` and
+ * `datasetWaterfall` may be null.
+ * 
+ */
 class DataSetGroup
 {
 public:
-    DataSetGroup(hid_t fileID, const std::string& name)
-        : m_dataset2D{new DataSet2D{fileID, name}}
-        , m_datasetCM{new DataSetCM{fileID, name}}
+    DataSetGroup(DataStorage& storage, const std::string& name, exa::StorageType type = exa::StorageType::FLOAT64,
+                 ChunkCompressor* compressor = nullptr, std::size_t summary = 0)
+        : m_storage{&storage}
+        , m_name{name}
+        , m_type{type}
+        , m_compressor{compressor}
+        , m_summary{summary}
+        , m_flushOnWrite{false}
+        , m_flushPolicy{}
+        , m_dataset2D{DataSet2D::create(storage, name, type, compressor, summary)}
+        , m_datasetCM{DataSetCM::create(storage, name, type, compressor)}
+        , m_waterfallRows{0}
     {}
     std::unique_ptr<DataSet2D>& dataset2D() { return this->m_dataset2D; }
     std::unique_ptr<DataSetCM>& datasetCM() { return this->m_datasetCM; }
+    std::unique_ptr<DataSetStream>& datasetStream() { return this->m_datasetStream; }
+    DataSetStream& openStream()
+    {
+        if (!this->m_datasetStream) {
+            this->m_datasetStream = DataSetStream::create(*this->m_storage, this->m_name, this->m_type, this->m_compressor);
+            this->m_datasetStream->setFlushOnWrite(this->m_flushOnWrite);
+            this->m_datasetStream->setFlushPolicy(this->m_flushPolicy);
+        }
+        return *this->m_datasetStream;
+    }
+    std::unique_ptr<DataSetWaterfall>& datasetWaterfall() { return this->m_datasetWaterfall; }
+    DataSetWaterfall& openWaterfall(std::size_t columns)
+    {
+        if (!this->m_datasetWaterfall) {
+            this->m_datasetWaterfall = DataSetWaterfall::create(
+                *this->m_storage, this->m_name, this->m_type, columns, this->m_compressor);
+            this->m_datasetWaterfall->setFlushOnWrite(this->m_flushOnWrite);
+            this->m_datasetWaterfall->setFlushPolicy(this->m_flushPolicy);
+        }
+        return *this->m_datasetWaterfall;
+    }
+    // index of the next waterfall row (over the run, i.e. not wrapped to the map's rows)
+    std::size_t nextWaterfallRow() { return this->m_waterfallRows++; }
+    const std::string& name() const { return this->m_name; }
+    /**
+     * @brief The group's counterpart in the next segment of a rotated data file: the same datasets
+     * and settings (the stream and waterfall datasets are again only created once written to), and
+     * the waterfall rows carry on from this group's.
+     * 
+     * @param storage 
+     * @param compressor 
+     * @return DataSetGroup 
+     */
+    DataSetGroup next(DataStorage& storage, ChunkCompressor* compressor) const
+    {
+        DataSetGroup group{storage, this->m_name, this->m_type, compressor, this->m_summary};
+        group.setFlushOnWrite(this->m_flushOnWrite);
+        group.setFlushPolicy(this->m_flushPolicy);
+        group.m_waterfallRows = this->m_waterfallRows;
+        return group;
+    }
+    void flush()
+    {
+        this->m_dataset2D->flush();
+        this->m_datasetCM->flush();
+        if (this->m_datasetStream)
+            this->m_datasetStream->flush();
+        if (this->m_datasetWaterfall)
+            this->m_datasetWaterfall->flush();
+    }
+    void setFlushOnWrite(bool enable)
+    {
+        this->m_flushOnWrite = enable;
+        this->m_dataset2D->setFlushOnWrite(enable);
+        this->m_datasetCM->setFlushOnWrite(enable);
+        if (this->m_datasetStream)
+            this->m_datasetStream->setFlushOnWrite(enable);
+        if (this->m_datasetWaterfall)
+            this->m_datasetWaterfall->setFlushOnWrite(enable);
+    }
+    void setFlushPolicy(const FlushPolicy& policy)
+    {
+        this->m_flushPolicy = policy;
+        this->m_dataset2D->setFlushPolicy(policy);
+        this->m_datasetCM->setFlushPolicy(policy);
+        if (this->m_datasetStream)
+            this->m_datasetStream->setFlushPolicy(policy);
+        if (this->m_datasetWaterfall)
+            this->m_datasetWaterfall->setFlushPolicy(policy);
+    }
 
 private:
+    DataStorage* m_storage;
+    std::string m_name;
+    exa::StorageType m_type;
+    ChunkCompressor* m_compressor;
+    std::size_t m_summary;          // factor of the 2D dataset's summary levels (0: none)
+    bool m_flushOnWrite;
+    FlushPolicy m_flushPolicy;
     std::unique_ptr<DataSet2D> m_dataset2D;
     std::unique_ptr<DataSetCM> m_datasetCM;
+    std::unique_ptr<DataSetStream> m_datasetStream;
+    std::unique_ptr<DataSetWaterfall> m_datasetWaterfall;
+    std::size_t m_waterfallRows;
+};
+
+
+class DataSetColumn
+{
+public:
+    virtual ~DataSetColumn() = default;
+
+    static std::unique_ptr<DataSetColumn> create(DataStorage& storage, const std::string& name, std::size_t type,
+                                                 ChunkCompressor* compressor = nullptr);
+
+    virtual void write(const exa::ColumnValues& values) = 0;
+
+    virtual void flush() = 0;
+    virtual bool empty() const = 0;
+    virtual void setFlushOnWrite(bool enable) = 0;
+    virtual void setFlushPolicy(const FlushPolicy& policy) = 0;
+};
+
+
+/**
+ * @brief Dataset of a record table column (one value per row, stored as the column's type).
+ * 
+ * @tparam T column type
+ */
+template<typename T>
+class TypedDataSetColumn : public DataSetColumn, public DataSet<T>
+{
+public:
+    TypedDataSetColumn(DataStorage& storage, const std::string& name, ChunkCompressor* compressor = nullptr)
+        : DataSet<T>{storage, name, 1, storageDatatype<T>(), compressor}
+    {
+    }
+
+    void write(const exa::ColumnValues& values) override
+    {
+        const auto& column = std::get<std::vector<T>>(values);
+        this->m_buffer.insert(this->m_buffer.end(), column.begin(), column.end());
+        this->writeIfFull();
+    }
+
+    void flush() override { DataSet<T>::flush(); }
+    bool empty() const override { return DataSet<T>::empty(); }
+    void setFlushOnWrite(bool enable) override { DataSet<T>::setFlushOnWrite(enable); }
+    void setFlushPolicy(const FlushPolicy& policy) override { DataSet<T>::setFlushPolicy(policy); }
+};
+
+
+/**
+ * @brief A record table: a group (named after the table) of column datasets, all of the same
+ * length. The columns and their types are those of the table's first record; the data manager's
+ * interface has already matched later records to them.
+ * 
+ */
+class DataTable
+{
+public:
+    DataTable(DataStorage& storage, const std::string& name, const std::vector<exa::RecordColumn>& columns,
+              ChunkCompressor* compressor = nullptr)
+    {
+        storage.createGroup(name);
+        for (const auto& column : columns) {
+            this->m_columns.push_back(
+                DataSetColumn::create(storage, name + "/" + column.name, column.values.index(), compressor));
+        }
+    }
+
+    DataTable(const DataTable&) = delete;
+    DataTable& operator=(const DataTable&) = delete;
+
+    void write(const std::vector<exa::RecordColumn>& columns)
+    {
+        if (columns.size() != this->m_columns.size())
+            throw std::runtime_error{"record doesn't match the table's columns"};
+        for (std::size_t i = 0; i < columns.size(); ++i)
+            this->m_columns[i]->write(columns[i].values);
+    }
+
+    void flush()
+    {
+        for (auto& column : this->m_columns)
+            column->flush();
+    }
+
+    bool empty() const
+    {
+        return std::all_of(this->m_columns.begin(), this->m_columns.end(), [](const auto& c) { return c->empty(); });
+    }
+
+    void setFlushPolicy(const FlushPolicy& policy)
+    {
+        for (auto& column : this->m_columns)
+            column->setFlushPolicy(policy);
+    }
+
+private:
+    std::vector<std::unique_ptr<DataSetColumn>> m_columns;
+};
+
+
+/**
+ * @brief A segment of the data file: the file and everything writing to it (in reverse order of
+ * destruction).
+ * 
+ */
+struct DataSegment
+{
+    std::unique_ptr<DataStorage> storage;
+    std::unique_ptr<ChunkCompressor> compressor;
+    std::vector<DataSetGroup> datasets;
+    std::map<std::string, DataTable> tables;
 };
 
 
@@ -218,6 +1088,8 @@ public:
     DataManager();
     ~DataManager();
 
+    DataQueue& queue() { return this->m_queue; }
+
 Q_SIGNALS:
     void error(const QString&);
     void resetCompleted(bool, const QString&);
@@ -232,17 +1104,56 @@ public Q_SLOTS:
 
     void write2D(std::size_t plotIdx, double x, double y);
     void write2DVec(std::size_t plotIdx, const std::vector<double>& x, const std::vector<double>& y);
+    void write2DMulti(std::size_t plotIdx, const std::vector<double>& x, const std::vector<std::vector<double>>& y);
+    void write2DStream(std::size_t plotIdx, const std::vector<double>& y, double x0, double dx);
 
     void writeCM(std::size_t plotIdx, int x, int y, double value);
     void writeCMVec(std::size_t plotIdx, int y, const std::vector<double>& row);
     void writeCMFrame(std::size_t plotIdx, const std::vector<std::vector<double>>& frame);
+    void writeCMPush(std::size_t plotIdx, const std::vector<double>& row);
+
+    void writeTable(const std::string& table, const std::vector<exa::RecordColumn>& columns);
 
     void flush(std::size_t plotIdx);
+    void drain();
+    void rotate();
 
 private:
+    // channel (ID) whose dataset group couldn't be created
+    constexpr static std::size_t NO_GROUP = std::numeric_limits<std::size_t>::max();
+
     void setEnabled(bool enabled);
+    void flushBuffered();
+    void rotateIfDue();
+    QString collectFinalised(bool wait);
+    void openChannel(const std::string& name);
+    bool swmr() const;
+    bool journaled(std::size_t plotIdx) const;
 
     bool m_enabled;
-    std::vector<DataSetGroup> m_datasets;
-    hid_t m_fileID;
+    bool m_swmr;
+    bool m_journalEnabled;
+    exa::StorageFormat m_format;
+    exa::StorageType m_storageType;
+    std::map<std::size_t, exa::StorageType> m_plotStorageTypes;
+    FlushPolicy m_flushPolicy;
+    int m_compression;                          // deflate level (0: no compression)
+    std::size_t m_compressionWorkers;
+    std::size_t m_segmentBytes;                 // rotation policy (0: no limit)
+    std::chrono::milliseconds m_segmentDuration;
+    std::size_t m_summary;                      // factor of the 2D datasets' summary levels (0: none)
+    QTimer m_flushTimer;
+    std::unique_ptr<ChunkCompressor> m_compressor;    // outlives the datasets
+    std::vector<DataSetGroup> m_datasets;     // the plots' dataset groups, followed by the channels'
+    std::vector<std::size_t> m_channels;        // data-only channel ID -> dataset group index (or NO_GROUP)
+    std::map<std::string, DataTable> m_tables;
+    std::unique_ptr<DataJournal> m_journal;
+    std::unique_ptr<DataStorage> m_storage;
+    std::filesystem::path m_path;               // of the first segment
+    std::size_t m_segment;                      // the segment being written
+    std::chrono::steady_clock::time_point m_segmentOpened;
+    bool m_segmentEmpty;
+    std::shared_ptr<SegmentIndex> m_index;      // (only for a segmented data file)
+    std::vector<std::future<std::string>> m_finalising;  // segments being closed in the background
+    DataQueue m_queue;
 };
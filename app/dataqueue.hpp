@@ -0,0 +1,159 @@
+/*
+ * ExaPlot
+ * data write queue
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "datarecord.hpp"
+
+
+/**
+ * @brief Data to be written to the data file (the fields used depend on the type). Writes to a
+ * data-only channel (`channel`) are addressed by channel ID rather than plot index.
+ * 
+ */
+struct DataWrite
+{
+    typedef enum
+    {
+        TWODIMEN,           // x, y
+        TWODIMEN_VEC,       // xs, ys
+        TWODIMEN_MULTI,     // xs, traces
+        TWODIMEN_STREAM,    // ys, x (x0), y (dx)
+        COLORMAP,           // col, row, x (value)
+        COLORMAP_VEC,       // row, ys
+        COLORMAP_FRAME,     // traces
+        COLORMAP_PUSH,      // ys
+        CHANNEL,            // name (creates the channel)
+        TABLE,              // name (table), columns
+        ROTATE,             // (starts the next segment of the data file)
+    } Type;
+
+    Type type = TWODIMEN;
+    std::size_t plotIdx = 0;
+    bool channel = false;
+    double x = 0.;
+    double y = 0.;
+    int col = 0;
+    int row = 0;
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<std::vector<double>> traces;
+    std::string name;
+    std::vector<exa::RecordColumn> columns;
+};
+
+
+/**
+ * @brief Lock-free (multi-producer, single-consumer) queue of data file writes.
+ * 
+ * This is how the script thread hands data to the data manager without going through any event
+ * loop: pushing a write is an allocation and an atomic exchange. The consumer is notified (through
+ * the callback) only when the queue goes from idle to having data, so a busy producer results in a
+ * single pending notification no matter how many writes it pushes.
+ * 
+ * The queue is unbounded: if the data manager can't keep up, writes accumulate in memory.
+ * 
+ */
+class DataQueue
+{
+public:
+    DataQueue()
+        : m_head{new Node}
+        , m_tail{m_head.load(std::memory_order_relaxed)}
+        , m_scheduled{false}
+        , m_notify{}
+    {
+    }
+
+    ~DataQueue()
+    {
+        while (this->m_tail) {
+            auto next = this->m_tail->next.load(std::memory_order_relaxed);
+            delete this->m_tail;
+            this->m_tail = next;
+        }
+    }
+
+    DataQueue(const DataQueue&) = delete;
+    DataQueue& operator=(const DataQueue&) = delete;
+
+    /**
+     * @brief Set the callback used to wake the consumer (called from the producing thread).
+     * 
+     * @param notify 
+     */
+    void setNotify(std::function<void()> notify) { this->m_notify = std::move(notify); }
+
+    void push(DataWrite&& write)
+    {
+        auto node = new Node;
+        node->write = std::move(write);
+        auto prev = this->m_head.exchange(node, std::memory_order_acq_rel);
+        // sequentially consistent (along with `idle`) so that the consumer can't both miss this
+        //   node and miss the notification
+        prev->next.store(node);
+
+        if (!this->m_scheduled.exchange(true) && this->m_notify)
+            this->m_notify();
+    }
+
+    /**
+     * @brief Take the next write off of the queue (consumer only).
+     * 
+     * @param write 
+     * @return true 
+     * @return false the queue is empty
+     */
+    bool pop(DataWrite& write)
+    {
+        auto tail = this->m_tail;
+        auto next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+        // the popped node becomes the new (empty) tail
+        write = std::move(next->write);
+        this->m_tail = next;
+        delete tail;
+        return true;
+    }
+
+    /**
+     * @brief Mark the consumer as idle once it has drained the queue (consumer only). Returns
+     * `false` if writes were pushed in the meantime without a notification, in which case the
+     * consumer is to keep draining.
+     * 
+     * @return true 
+     * @return false 
+     */
+    bool idle()
+    {
+        this->m_scheduled.store(false);
+        if (this->m_tail->next.load() == nullptr)
+            return true;
+        return this->m_scheduled.exchange(true);
+    }
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        DataWrite write;
+    };
+
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+    std::atomic_bool m_scheduled;
+    std::function<void()> m_notify;
+};
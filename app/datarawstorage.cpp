@@ -0,0 +1,455 @@
+/*
+ * ExaPlot
+ * raw (memory-mapped) data file storage
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "datarawstorage.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+static constexpr char MAGIC[] = "EXAPLOT RAW 1\n";
+// width of the (space-padded) rows and columns fields of the header
+static constexpr std::size_t FIELD_WIDTH = 20;
+// the map grows by at least this many bytes of data at a time
+static constexpr std::uint64_t MIN_GROWTH = 1 << 20;
+
+
+/**
+ * @brief Create the dataset's file, replacing any existing one.
+ * 
+ * @param path 
+ * @param datatype 
+ * @param rowElements 
+ * @param fill fill value of elements added by widening the rows (null for zero)
+ * @param size size of the data file, to which the dataset's header and rows are added (optional)
+ */
+RawDataset::RawDataset(const std::filesystem::path& path, hid_t datatype, std::size_t rowElements, const void* fill,
+                       std::uint64_t* size)
+    : m_path{path}
+    , m_elementSize{H5Tget_size(datatype)}
+    , m_rowElements{rowElements}
+    , m_fill(m_elementSize, 0)
+    , m_rows{0}
+    , m_capacity{0}
+    , m_rowsField{0}
+    , m_columnsField{0}
+    , m_attributes{}
+    , m_size{size}
+#if defined(_WIN32)
+    , m_file{INVALID_HANDLE_VALUE}
+    , m_mapping{NULL}
+#else
+    , m_file{-1}
+#endif
+    , m_view{nullptr}
+{
+    if (fill)
+        std::memcpy(this->m_fill.data(), fill, this->m_elementSize);
+
+    std::string header{MAGIC};
+    header.append("{\"rows\": ");
+    this->m_rowsField = header.size();
+    header.append(FIELD_WIDTH, ' ');
+    header.append(", \"columns\": ");
+    this->m_columnsField = header.size();
+    header.append(FIELD_WIDTH, ' ');
+    header.append(", \"dtype\": ").append(numpyType(datatype));
+    header.append(", \"offset\": ").append(std::to_string(HEADER_SIZE)).append("}");
+    if (header.size() >= HEADER_SIZE)
+        throw std::runtime_error{"raw dataset header too long"};
+    header.resize(HEADER_SIZE - 1, ' ');
+    header.push_back('\n');
+
+#if defined(_WIN32)
+    this->m_file = CreateFileW(
+        path.wstring().c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ,
+        NULL,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL
+    );
+    if (this->m_file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error{"failed to create raw dataset file"};
+#else
+    this->m_file = ::open(path.string().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (this->m_file == -1)
+        throw std::runtime_error{"failed to create raw dataset file"};
+#endif
+
+    try {
+        this->map(MIN_GROWTH);
+    } catch (const std::runtime_error&) {
+#if defined(_WIN32)
+        CloseHandle(this->m_file);
+#else
+        ::close(this->m_file);
+#endif
+        throw;
+    }
+    std::memcpy(this->m_view, header.data(), header.size());
+    this->writeField(this->m_rowsField, 0);
+    this->writeField(this->m_columnsField, rowElements);
+    if (this->m_size)
+        *this->m_size += HEADER_SIZE;
+}
+
+
+/**
+ * @brief Unmap the dataset and trim the file to its rows.
+ * 
+ */
+RawDataset::~RawDataset()
+{
+    this->unmap();
+    auto size = HEADER_SIZE + this->m_rows * this->m_rowElements * this->m_elementSize;
+#if defined(_WIN32)
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (SetFilePointerEx(this->m_file, fileSize, NULL, FILE_BEGIN))
+        SetEndOfFile(this->m_file);
+    CloseHandle(this->m_file);
+#else
+    [[maybe_unused]] auto status = ftruncate(this->m_file, static_cast<off_t>(size));
+    ::close(this->m_file);
+#endif
+}
+
+
+void
+RawDataset::append(const void* data, std::size_t rows)
+{
+    if (rows == 0)
+        return;
+    auto rowBytes = this->m_rowElements * this->m_elementSize;
+    this->reserve((this->m_rows + rows) * rowBytes);
+    std::memcpy(this->m_view + HEADER_SIZE + this->m_rows * rowBytes, data, rows * rowBytes);
+    this->m_rows += rows;
+    // readers go by the rows field, so the rows are written before it
+    std::atomic_thread_fence(std::memory_order_release);
+    this->writeField(this->m_rowsField, this->m_rows);
+    if (this->m_size)
+        *this->m_size += rows * rowBytes;
+}
+
+
+/**
+ * @brief Widen the rows in place (the rows are moved from the last to the first, so no row is
+ * overwritten before it's moved). Readers may see inconsistent rows while this happens.
+ * 
+ * @param elements 
+ */
+void
+RawDataset::setRowElements(std::size_t elements)
+{
+    if (elements <= this->m_rowElements)
+        return;
+    auto rowBytes = this->m_rowElements * this->m_elementSize;
+    auto newRowBytes = elements * this->m_elementSize;
+    this->reserve(this->m_rows * newRowBytes);
+
+    auto data = this->m_view + HEADER_SIZE;
+    for (auto row = this->m_rows; row-- > 0;) {
+        auto dest = data + row * newRowBytes;
+        std::memmove(dest, data + row * rowBytes, rowBytes);
+        for (auto offset = rowBytes; offset < newRowBytes; offset += this->m_elementSize)
+            std::memcpy(dest + offset, this->m_fill.data(), this->m_elementSize);
+    }
+    this->m_rowElements = elements;
+    std::atomic_thread_fence(std::memory_order_release);
+    this->writeField(this->m_columnsField, elements);
+    if (this->m_size)
+        *this->m_size += this->m_rows * (newRowBytes - rowBytes);
+}
+
+
+/**
+ * @brief Schedule the mapped pages to be written to disk (the data is already visible to readers
+ * and safe from the process being killed).
+ * 
+ */
+void
+RawDataset::flush()
+{
+    auto size = HEADER_SIZE + this->m_rows * this->m_rowElements * this->m_elementSize;
+#if defined(_WIN32)
+    FlushViewOfFile(this->m_view, size);
+#else
+    msync(this->m_view, size, MS_ASYNC);
+#endif
+}
+
+
+void
+RawDataset::setAttribute(const char* name, const std::vector<std::uint64_t>& values)
+{
+    std::string json{"["};
+    for (std::size_t i = 0; i < values.size(); ++i)
+        json.append(i ? ", " : "").append(std::to_string(values[i]));
+    this->m_attributes[name] = json.append("]");
+    this->writeAttributes();
+}
+
+
+void
+RawDataset::setAttribute(const char* name, const std::vector<double>& values)
+{
+    std::string json{"["};
+    char number[32];
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        // (JSON has no representation of non-finite numbers)
+        if (std::isfinite(values[i]))
+            std::snprintf(number, sizeof(number), "%.17g", values[i]);
+        else
+            std::strcpy(number, "null");
+        json.append(i ? ", " : "").append(number);
+    }
+    this->m_attributes[name] = json.append("]");
+    this->writeAttributes();
+}
+
+
+/**
+ * @brief NumPy dtype (as JSON) of an HDF5 datatype: a type string for numbers, or a dict of names,
+ * formats, offsets and item size for compound types.
+ * 
+ * @param datatype 
+ * @return std::string 
+ */
+std::string
+RawDataset::numpyType(hid_t datatype)
+{
+    auto size = H5Tget_size(datatype);
+    auto order = H5Tget_order(datatype) == H5T_ORDER_BE ? '>' : '<';
+    switch (H5Tget_class(datatype)) {
+    case H5T_FLOAT:
+        return std::string{"\""} + order + "f" + std::to_string(size) + "\"";
+    case H5T_INTEGER:
+        return std::string{"\""} + (size == 1 ? '|' : order) + (H5Tget_sign(datatype) == H5T_SGN_NONE ? "u" : "i")
+            + std::to_string(size) + "\"";
+    case H5T_COMPOUND: {
+        std::string names, formats, offsets;
+        auto members = H5Tget_nmembers(datatype);
+        for (int i = 0; i < members; ++i) {
+            auto name = H5Tget_member_name(datatype, static_cast<unsigned>(i));
+            auto memberType = H5Tget_member_type(datatype, static_cast<unsigned>(i));
+            auto separator = i ? ", " : "";
+            names.append(separator).append("\"").append(name).append("\"");
+            try {
+                formats.append(separator).append(numpyType(memberType));
+            } catch (const std::runtime_error&) {
+                H5free_memory(name);
+                H5Tclose(memberType);
+                throw;
+            }
+            offsets.append(separator).append(std::to_string(H5Tget_member_offset(datatype, static_cast<unsigned>(i))));
+            H5free_memory(name);
+            H5Tclose(memberType);
+        }
+        return "{\"names\": [" + names + "], \"formats\": [" + formats + "], \"offsets\": [" + offsets
+            + "], \"itemsize\": " + std::to_string(size) + "}";
+    }
+    default:
+        throw std::runtime_error{"unsupported raw dataset datatype"};
+    }
+}
+
+
+/**
+ * @brief Make room for the given number of bytes of data, growing the map (by at least doubling
+ * it) if needed.
+ * 
+ * @param bytes 
+ */
+void
+RawDataset::reserve(std::uint64_t bytes)
+{
+    if (bytes <= this->m_capacity)
+        return;
+    this->map(std::max({bytes, 2 * this->m_capacity, MIN_GROWTH}));
+}
+
+
+/**
+ * @brief Extend the file to hold the given number of bytes of data and map all of it.
+ * 
+ * @param capacity 
+ */
+void
+RawDataset::map(std::uint64_t capacity)
+{
+    this->unmap();
+    auto size = HEADER_SIZE + capacity;
+
+#if defined(_WIN32)
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(this->m_file, fileSize, NULL, FILE_BEGIN) || !SetEndOfFile(this->m_file))
+        throw std::runtime_error{"failed to extend raw dataset file"};
+    this->m_mapping = CreateFileMappingW(
+        this->m_file,
+        NULL,
+        PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+        static_cast<DWORD>(size & 0xFFFFFFFF),
+        NULL
+    );
+    if (this->m_mapping == NULL)
+        throw std::runtime_error{"failed to map raw dataset file"};
+    auto view = MapViewOfFile(this->m_mapping, FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(size));
+    if (view == NULL) {
+        CloseHandle(this->m_mapping);
+        this->m_mapping = NULL;
+        throw std::runtime_error{"failed to map raw dataset file"};
+    }
+#else
+    if (ftruncate(this->m_file, static_cast<off_t>(size)) < 0)
+        throw std::runtime_error{"failed to extend raw dataset file"};
+    auto view = mmap(NULL, static_cast<std::size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, this->m_file, 0);
+    if (view == MAP_FAILED)
+        throw std::runtime_error{"failed to map raw dataset file"};
+#endif
+
+    this->m_view = static_cast<std::uint8_t*>(view);
+    this->m_capacity = capacity;
+}
+
+
+void
+RawDataset::unmap()
+{
+    if (!this->m_view)
+        return;
+#if defined(_WIN32)
+    UnmapViewOfFile(this->m_view);
+    CloseHandle(this->m_mapping);
+    this->m_mapping = NULL;
+#else
+    munmap(this->m_view, static_cast<std::size_t>(HEADER_SIZE + this->m_capacity));
+#endif
+    this->m_view = nullptr;
+}
+
+
+/**
+ * @brief Rewrite a (space-padded) number field of the header.
+ * 
+ * @param offset 
+ * @param value 
+ */
+void
+RawDataset::writeField(std::size_t offset, std::uint64_t value)
+{
+    char field[FIELD_WIDTH];
+    std::memset(field, ' ', FIELD_WIDTH);
+    std::to_chars(field, field + FIELD_WIDTH, value);
+    std::memcpy(this->m_view + offset, field, FIELD_WIDTH);
+}
+
+
+void
+RawDataset::writeAttributes()
+{
+    std::ofstream output{std::filesystem::path{this->m_path}.concat(".json"), std::ios::trunc};
+    output << "{";
+    bool first = true;
+    for (const auto& [name, values] : this->m_attributes) {
+        output << (first ? "" : ", ") << "\"" << name << "\": " << values;
+        first = false;
+    }
+    output << "}\n";
+    if (!output)
+        throw std::runtime_error{"failed to write raw dataset attributes"};
+}
+
+
+RawStorage::RawStorage()
+    : m_path{}
+    , m_size{0}
+{
+}
+
+
+/**
+ * @brief Create the data file's directory. Raw datasets left in it by an earlier run (files with
+ * the raw dataset header, and their attributes) are removed; nothing else is touched.
+ * 
+ * @param path 
+ * @param swmr (unused: raw datasets can always be read while they're written)
+ */
+void
+RawStorage::open(const std::filesystem::path& path, [[maybe_unused]] bool swmr)
+{
+    std::error_code ec;
+    if (std::filesystem::exists(path, ec) && !std::filesystem::is_directory(path, ec))
+        throw std::runtime_error{"raw data file path exists and isn't a directory"};
+    if (!std::filesystem::create_directories(path, ec) && ec)
+        throw std::runtime_error{"failed to create raw data file directory"};
+
+    std::vector<std::filesystem::path> stale;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator{path, ec}) {
+        if (!entry.is_regular_file(ec))
+            continue;
+        char magic[sizeof(MAGIC) - 1] = {0};
+        std::ifstream file{entry.path(), std::ios::binary};
+        if (file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(magic)) == 0)
+            stale.push_back(entry.path());
+    }
+    for (const auto& dataset : stale) {
+        std::filesystem::remove(dataset, ec);
+        std::filesystem::remove(std::filesystem::path{dataset}.concat(".json"), ec);
+    }
+    this->m_path = path;
+    this->m_size = 0;
+}
+
+
+void
+RawStorage::close()
+{
+    this->m_path.clear();
+}
+
+
+void
+RawStorage::createGroup(const std::string& name)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(this->m_path / name, ec);
+    if (ec)
+        throw std::runtime_error{"failed to create group directory"};
+}
+
+
+std::unique_ptr<StoredDataset>
+RawStorage::createDataset(
+    const std::string& name,
+    hid_t datatype,
+    std::size_t rowElements,
+    [[maybe_unused]] bool growable,
+    const void* fill,
+    [[maybe_unused]] std::size_t chunkRows,
+    [[maybe_unused]] ChunkCompressor* compressor)
+{
+    return std::make_unique<RawDataset>(this->m_path / name, datatype, rowElements, fill, &this->m_size);
+}
@@ -0,0 +1,114 @@
+/*
+ * ExaPlot
+ * raw (memory-mapped) data file storage
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "datastorage.hpp"
+
+
+/**
+ * @brief Dataset of a raw data file: a file of fixed-width rows, mapped into memory, so that an
+ * append is a copy into the map. The file starts with a text header (`HEADER_SIZE` bytes): a
+ * magic line followed by a JSON object (padded with spaces) with the number of rows and columns,
+ * the NumPy dtype of the elements and the offset of the data, e.g.
+ * 
+ *     EXAPLOT RAW 1
+ *     {"rows": 1024, "columns": 2, "dtype": "<f8", "offset": 4096}
+ * 
+ * The rows field is updated in place after each append (the rows are always written first), so the
+ * file can be read at any time, e.g. with `numpy.memmap`. Attributes are written to a JSON file
+ * alongside the dataset (`<name>.json`).
+ * 
+ */
+class RawDataset : public StoredDataset
+{
+public:
+    constexpr static std::size_t HEADER_SIZE = 4096;
+
+    RawDataset(const std::filesystem::path& path, hid_t datatype, std::size_t rowElements, const void* fill,
+               std::uint64_t* size = nullptr);
+    ~RawDataset();
+
+    RawDataset(const RawDataset&) = delete;
+    RawDataset& operator=(const RawDataset&) = delete;
+
+    bool buffered() const override { return false; }
+    bool pending() const override { return false; }
+    void append(const void* data, std::size_t rows) override;
+    void setRowElements(std::size_t elements) override;
+    void flush() override;
+    void setAttribute(const char* name, const std::vector<std::uint64_t>& values) override;
+    void setAttribute(const char* name, const std::vector<double>& values) override;
+
+    static std::string numpyType(hid_t datatype);
+
+private:
+    void reserve(std::uint64_t rows);
+    void map(std::uint64_t capacity);
+    void unmap();
+    void writeField(std::size_t offset, std::uint64_t value);
+    void writeAttributes();
+
+    std::filesystem::path m_path;
+    std::size_t m_elementSize;
+    std::size_t m_rowElements;
+    std::vector<std::uint8_t> m_fill;
+    std::uint64_t m_rows;
+    std::uint64_t m_capacity;
+    std::size_t m_rowsField;
+    std::size_t m_columnsField;
+    std::map<std::string, std::string> m_attributes;
+    std::uint64_t* m_size;
+#if defined(_WIN32)
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_file;
+#endif
+    std::uint8_t* m_view;
+};
+
+
+/**
+ * @brief Raw data file: a directory with a file per dataset (see `RawDataset`); groups are
+ * subdirectories. Datasets are always readable while they're written, so there's no SWMR mode, and
+ * the data isn't compressed.
+ * 
+ */
+class RawStorage : public DataStorage
+{
+public:
+    RawStorage();
+
+    void open(const std::filesystem::path& path, bool swmr) override;
+    void close() override;
+    void startSWMR() override {}
+    bool frozen() const override { return false; }
+    std::uint64_t size() const override { return this->m_size; }
+    void createGroup(const std::string& name) override;
+    std::unique_ptr<StoredDataset> createDataset(
+        const std::string& name,
+        hid_t datatype,
+        std::size_t rowElements,
+        bool growable,
+        const void* fill,
+        std::size_t chunkRows,
+        ChunkCompressor* compressor) override;
+
+private:
+    std::filesystem::path m_path;
+    std::uint64_t m_size;       // of the datasets' headers and rows
+};
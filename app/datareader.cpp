@@ -0,0 +1,556 @@
+/*
+ * ExaPlot
+ * data file reader
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "datareader.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+
+typedef struct
+{
+    int x;
+    int y;
+} CMIndex;
+
+
+static hid_t
+cmIndexDatatype()
+{
+    auto datatype = H5Tcreate(H5T_COMPOUND, sizeof(CMIndex));
+    H5Tinsert(datatype, "x", HOFFSET(CMIndex, x), H5T_NATIVE_INT);
+    H5Tinsert(datatype, "y", HOFFSET(CMIndex, y), H5T_NATIVE_INT);
+    return datatype;
+}
+
+
+static hid_t
+cmDataDatatype()
+{
+    auto datatype = H5Tcreate(H5T_COMPOUND, sizeof(CMData));
+    H5Tinsert(datatype, "x", HOFFSET(CMData, x), H5T_NATIVE_INT);
+    H5Tinsert(datatype, "y", HOFFSET(CMData, y), H5T_NATIVE_INT);
+    H5Tinsert(datatype, "z", HOFFSET(CMData, value), H5T_NATIVE_DOUBLE);
+    return datatype;
+}
+
+
+/**
+ * @brief Retrieves the dimensions of a (two-dimensional) dataset.
+ * 
+ * @param dataset
+ * @param rows
+ * @param cols
+ */
+static void
+datasetDims(hid_t dataset, hsize_t& rows, hsize_t& cols)
+{
+    auto dataspaceID = H5Dget_space(dataset);
+    if (dataspaceID == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to get dataspace"};
+    hsize_t dims[2] = {0};
+    auto ndims = H5Sget_simple_extent_dims(dataspaceID, dims, NULL);
+    H5Sclose(dataspaceID);
+    if (ndims != 2)
+        throw std::runtime_error{"unexpected dataset dimensions"};
+    rows = dims[0];
+    cols = dims[1];
+}
+
+
+/**
+ * @brief Reads `count` rows starting at `row` into the given buffer using a hyperslab
+ * selection. The memory datatype determines the conversion performed by the library.
+ * 
+ * @param dataset
+ * @param memType
+ * @param row
+ * @param count
+ * @param cols
+ * @param buffer
+ */
+static void
+readRows(hid_t dataset, hid_t memType, hsize_t row, hsize_t count, hsize_t cols, void* buffer)
+{
+    auto dataspaceID = H5Dget_space(dataset);
+    if (dataspaceID == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to get dataspace"};
+    hsize_t start[] = {row, 0};
+    hsize_t counts[] = {count, cols};
+    if (H5Sselect_hyperslab(dataspaceID, H5S_SELECT_SET, start, NULL, counts, NULL) < 0) {
+        H5Sclose(dataspaceID);
+        throw std::runtime_error{"failed to select dataspace"};
+    }
+
+    auto memspaceID = H5Screate_simple(2, counts, NULL);
+    if (memspaceID == H5I_INVALID_HID) {
+        H5Sclose(dataspaceID);
+        throw std::runtime_error{"failed to create memory dataspace"};
+    }
+
+    auto status = H5Dread(dataset, memType, memspaceID, dataspaceID, H5P_DEFAULT, buffer);
+    H5Sclose(dataspaceID);
+    H5Sclose(memspaceID);
+    if (status < 0)
+        throw std::runtime_error{"failed to read dataset"};
+}
+
+
+static double
+readKey(hid_t dataset, hsize_t row)
+{
+    double key = 0;
+    readRows(dataset, H5T_NATIVE_DOUBLE, row, 1, 1, &key);
+    return key;
+}
+
+
+/**
+ * @brief Returns the first row in `[0, rows)` whose key is not less than (or, if `upper` is set,
+ * greater than) the given key. Keys are expected to be time-ordered (non-decreasing), which
+ * holds for any stream plotted against time or a sample counter.
+ * 
+ * @param dataset
+ * @param rows
+ * @param key
+ * @param upper
+ * @return hsize_t
+ */
+static hsize_t
+searchKey(hid_t dataset, hsize_t rows, double key, bool upper)
+{
+    hsize_t first = 0;
+    hsize_t count = rows;
+    while (count > 0) {
+        auto step = count / 2;
+        auto row = first + step;
+        auto rowKey = readKey(dataset, row);
+        if (upper ? rowKey <= key : rowKey < key) {
+            first = row + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+
+static hid_t
+openDataset(hid_t fileID, const std::string& name)
+{
+    if (H5Lexists(fileID, name.c_str(), H5P_DEFAULT) <= 0)
+        return H5I_INVALID_HID;
+    return H5Dopen(fileID, name.c_str(), H5P_DEFAULT);
+}
+
+
+DataReader::DataReader()
+    : QObject{nullptr}
+    , m_cancelled{false}
+    , m_fileID{H5I_INVALID_HID}
+{
+}
+
+
+DataReader::~DataReader()
+{
+    this->close();
+}
+
+
+/**
+ * @brief Aborts the replay currently in progress (if any). This is called directly from the
+ * application thread (rather than through a queued slot) since the reader's event loop is busy
+ * for the duration of a replay.
+ * 
+ */
+void
+DataReader::cancel()
+{
+    this->m_cancelled = true;
+}
+
+
+/**
+ * @brief Opens a data file, reports the datasets it contains and then streams each dataset
+ * (decimated) into its plot. The rows of a waterfall dataset are pushed to its color map in
+ * place of the map's cells (which refer to the rows displayed at the time they were written).
+ * 
+ * @param path
+ */
+void
+DataReader::open(const std::filesystem::path& path)
+{
+    this->m_cancelled = false;
+    this->close();
+
+    // files still being written in SWMR mode can only be opened as SWMR readers
+    H5E_BEGIN_TRY {
+        this->m_fileID = H5Fopen(path.string().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    } H5E_END_TRY;
+    if (this->m_fileID == H5I_INVALID_HID)
+        this->m_fileID = H5Fopen(path.string().c_str(), H5F_ACC_RDONLY | H5F_ACC_SWMR_READ, H5P_DEFAULT);
+    if (this->m_fileID == H5I_INVALID_HID) {
+        emit this->opened(true, "failed to open HDF5 file", {});
+        return;
+    }
+
+    std::vector<DatasetInfo> datasets;
+    try {
+        for (std::size_t i = 1; ; ++i) {
+            auto datasetName = std::string{"dataset"} + std::to_string(i);
+            auto dataset2D = openDataset(this->m_fileID, datasetName + ".twodimen");
+            auto datasetCM = openDataset(this->m_fileID, datasetName + ".colormap");
+            auto datasetWaterfall = openDataset(this->m_fileID, datasetName + ".waterfall");
+            if (dataset2D == H5I_INVALID_HID && datasetCM == H5I_INVALID_HID && datasetWaterfall == H5I_INVALID_HID)
+                break;
+            this->m_datasets.push_back({dataset2D, datasetCM, datasetWaterfall});
+
+            DatasetInfo info{.rows2D = 0, .rowsCM = 0, .rowsWaterfall = 0, .keyMin = 0, .keyMax = 0};
+            hsize_t cols = 0;
+            if (dataset2D != H5I_INVALID_HID) {
+                datasetDims(dataset2D, info.rows2D, cols);
+                if (info.rows2D > 0) {
+                    info.keyMin = readKey(dataset2D, 0);
+                    info.keyMax = readKey(dataset2D, info.rows2D - 1);
+                }
+            }
+            if (datasetCM != H5I_INVALID_HID)
+                datasetDims(datasetCM, info.rowsCM, cols);
+            if (datasetWaterfall != H5I_INVALID_HID)
+                datasetDims(datasetWaterfall, info.rowsWaterfall, cols);
+            datasets.push_back(info);
+        }
+    } catch (const std::runtime_error& e) {
+        this->close();
+        emit this->opened(true, QString{"error reading data file: "}.append(e.what()), {});
+        return;
+    }
+    if (datasets.empty()) {
+        this->close();
+        emit this->opened(true, "data file contains no datasets", {});
+        return;
+    }
+    emit this->opened(false, "", datasets);
+
+    try {
+        for (std::size_t i = 0; i < this->m_datasets.size(); ++i) {
+            if (datasets[i].rows2D > 0 && !this->load2D(i, this->m_datasets[i].twoDimen, 0, datasets[i].rows2D))
+                return;
+            if (datasets[i].rowsWaterfall > 0) {
+                if (!this->loadWaterfall(i, this->m_datasets[i].waterfall))
+                    return;
+            } else if (datasets[i].rowsCM > 0 && !this->loadCM(i, this->m_datasets[i].colorMap)) {
+                return;
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        emit this->loaded(true, QString{"error reading data file: "}.append(e.what()));
+        return;
+    }
+    emit this->loaded(false, "");
+}
+
+
+/**
+ * @brief Reloads the 2D datasets restricted to the keys (typically time) within `[from, to]`.
+ * The rows bounding the range are located with a binary search, so only the rows within the
+ * range are ever read.
+ * 
+ * @param from
+ * @param to
+ */
+void
+DataReader::seek(double from, double to)
+{
+    this->m_cancelled = false;
+    if (this->m_fileID == H5I_INVALID_HID)
+        return;
+
+    emit this->cleared();
+    try {
+        for (std::size_t i = 0; i < this->m_datasets.size(); ++i) {
+            auto dataset = this->m_datasets[i].twoDimen;
+            if (dataset == H5I_INVALID_HID)
+                continue;
+            hsize_t rows = 0;
+            hsize_t cols = 0;
+            datasetDims(dataset, rows, cols);
+            auto start = searchKey(dataset, rows, from, false);
+            auto end = searchKey(dataset, rows, to, true);
+            if (start < end && !this->load2D(i, dataset, start, end))
+                return;
+        }
+    } catch (const std::runtime_error& e) {
+        emit this->loaded(true, QString{"error reading data file: "}.append(e.what()));
+        return;
+    }
+    emit this->loaded(false, "");
+}
+
+
+void
+DataReader::close()
+{
+    for (const auto& datasets : this->m_datasets) {
+        if (datasets.twoDimen != H5I_INVALID_HID) H5Dclose(datasets.twoDimen);
+        if (datasets.colorMap != H5I_INVALID_HID) H5Dclose(datasets.colorMap);
+        if (datasets.waterfall != H5I_INVALID_HID) H5Dclose(datasets.waterfall);
+    }
+    this->m_datasets.clear();
+    if (this->m_fileID != H5I_INVALID_HID)
+        H5Fclose(this->m_fileID);
+    this->m_fileID = H5I_INVALID_HID;
+}
+
+
+/**
+ * @brief Streams rows `[start, end)` of a 2D dataset to its plot, one trace per y column. Ranges
+ * larger than twice the number of LOD buckets are decimated by emitting the minimum and maximum of
+ * each bucket (in key order), which preserves the envelope of each trace. Missing (NaN) values are
+ * skipped. Returns `false` if the replay was cancelled.
+ * 
+ * @param plotIdx
+ * @param dataset
+ * @param start
+ * @param end
+ * @return true
+ * @return false
+ */
+bool
+DataReader::load2D(std::size_t plotIdx, hid_t dataset, hsize_t start, hsize_t end)
+{
+    hsize_t rows = 0;
+    hsize_t cols = 0;
+    datasetDims(dataset, rows, cols);
+    if (cols < 2)
+        throw std::runtime_error{"2D dataset has too few columns"};
+
+    auto length = end - start;
+    auto bucketSize = length > 2 * LOD_BUCKETS ? (length + LOD_BUCKETS - 1) / LOD_BUCKETS : 1;
+
+    struct Trace
+    {
+        QVector<double> x;
+        QVector<double> y;
+        hsize_t bucketFill = 0;
+        double minKey = 0, minValue = std::numeric_limits<double>::infinity();
+        double maxKey = 0, maxValue = -std::numeric_limits<double>::infinity();
+        hsize_t minIdx = 0, maxIdx = 0;
+    };
+    std::vector<Trace> traces(cols - 1);
+    std::vector<double> buffer;
+
+    auto flushBucket = [](Trace& trace) {
+        if (trace.bucketFill == 0)
+            return;
+        if (trace.minIdx == trace.maxIdx) {
+            trace.x.push_back(trace.minKey);
+            trace.y.push_back(trace.minValue);
+        } else if (trace.minIdx < trace.maxIdx) {
+            trace.x.push_back(trace.minKey);
+            trace.y.push_back(trace.minValue);
+            trace.x.push_back(trace.maxKey);
+            trace.y.push_back(trace.maxValue);
+        } else {
+            trace.x.push_back(trace.maxKey);
+            trace.y.push_back(trace.maxValue);
+            trace.x.push_back(trace.minKey);
+            trace.y.push_back(trace.minValue);
+        }
+        trace.bucketFill = 0;
+        trace.minValue = std::numeric_limits<double>::infinity();
+        trace.maxValue = -std::numeric_limits<double>::infinity();
+    };
+
+    for (auto row = start; row < end; ) {
+        if (this->m_cancelled)
+            return false;
+
+        auto count = std::min(CHUNK_ROWS, end - row);
+        buffer.resize(count * cols);
+        readRows(dataset, H5T_NATIVE_DOUBLE, row, count, cols, buffer.data());
+
+        for (hsize_t i = 0; i < count; ++i) {
+            auto key = buffer[i * cols];
+            for (std::size_t t = 0; t < traces.size(); ++t) {
+                auto& trace = traces[t];
+                auto value = buffer[i * cols + 1 + t];
+                if (value != value)
+                    continue;
+                if (bucketSize == 1) {
+                    trace.x.push_back(key);
+                    trace.y.push_back(value);
+                    continue;
+                }
+                if (value < trace.minValue) {
+                    trace.minKey = key;
+                    trace.minValue = value;
+                    trace.minIdx = trace.bucketFill;
+                }
+                if (value > trace.maxValue) {
+                    trace.maxKey = key;
+                    trace.maxValue = value;
+                    trace.maxIdx = trace.bucketFill;
+                }
+                if (++trace.bucketFill == bucketSize)
+                    flushBucket(trace);
+            }
+        }
+        row += count;
+
+        for (std::size_t t = 0; t < traces.size(); ++t) {
+            auto& trace = traces[t];
+            if (row == end)
+                flushBucket(trace);
+            if (!trace.x.isEmpty()) {
+                emit this->data2D(plotIdx, t, trace.x, trace.y);
+                trace.x.clear();
+                trace.y.clear();
+            }
+        }
+    }
+    return true;
+}
+
+
+/**
+ * @brief Streams a colormap dataset to its plot. The map's dimensions are not stored in the data
+ * file, so a first pass reads only the cell indices to size the map before the cell values are
+ * streamed. Returns `false` if the replay was cancelled.
+ * 
+ * @param plotIdx
+ * @param dataset
+ * @return true
+ * @return false
+ */
+bool
+DataReader::loadCM(std::size_t plotIdx, hid_t dataset)
+{
+    hsize_t rows = 0;
+    hsize_t cols = 0;
+    datasetDims(dataset, rows, cols);
+
+    auto indexType = cmIndexDatatype();
+    int sizeX = 0;
+    int sizeY = 0;
+    try {
+        std::vector<CMIndex> indices;
+        for (hsize_t row = 0; row < rows; row += CHUNK_ROWS) {
+            if (this->m_cancelled) {
+                H5Tclose(indexType);
+                return false;
+            }
+            auto count = std::min(CHUNK_ROWS, rows - row);
+            indices.resize(count);
+            readRows(dataset, indexType, row, count, 1, indices.data());
+            for (const auto& index : indices) {
+                sizeX = std::max(sizeX, index.x + 1);
+                sizeY = std::max(sizeY, index.y + 1);
+            }
+        }
+    } catch (const std::runtime_error&) {
+        H5Tclose(indexType);
+        throw;
+    }
+    H5Tclose(indexType);
+    if (sizeX <= 0 || sizeY <= 0)
+        return true;
+    emit this->sizeCM(plotIdx, sizeX, sizeY);
+
+    auto dataType = cmDataDatatype();
+    try {
+        std::vector<CMData> cells;
+        for (hsize_t row = 0; row < rows; row += CHUNK_ROWS) {
+            if (this->m_cancelled) {
+                H5Tclose(dataType);
+                return false;
+            }
+            auto count = std::min(CHUNK_ROWS, rows - row);
+            cells.resize(count);
+            readRows(dataset, dataType, row, count, 1, cells.data());
+            emit this->dataCM(plotIdx, cells);
+        }
+    } catch (const std::runtime_error&) {
+        H5Tclose(dataType);
+        throw;
+    }
+    H5Tclose(dataType);
+    return true;
+}
+
+
+/**
+ * @brief Streams a waterfall dataset (the rows pushed to a waterfall color map, in push order) to
+ * its plot. Datasets of more than `WATERFALL_ROWS` rows are decimated by averaging buckets of
+ * consecutive rows (ignoring missing values), so the map holds the whole run with the newest rows
+ * at the top. Returns `false` if the replay was cancelled.
+ * 
+ * @param plotIdx
+ * @param dataset
+ * @return true
+ * @return false
+ */
+bool
+DataReader::loadWaterfall(std::size_t plotIdx, hid_t dataset)
+{
+    hsize_t rows = 0;
+    hsize_t cols = 0;
+    datasetDims(dataset, rows, cols);
+    if (rows == 0 || cols == 0)
+        return true;
+
+    auto bucketSize = (rows + WATERFALL_ROWS - 1) / WATERFALL_ROWS;
+    auto mapRows = (rows + bucketSize - 1) / bucketSize;
+    emit this->sizeCM(plotIdx, static_cast<int>(cols), static_cast<int>(mapRows));
+
+    // rows can be wide, so the reads are bounded by cells rather than rows
+    auto chunkRows = std::max<hsize_t>(1, CHUNK_ROWS / cols);
+    std::vector<double> buffer;
+    std::vector<double> sums(cols, 0);
+    std::vector<hsize_t> counts(cols, 0);
+    hsize_t bucketFill = 0;
+    std::vector<double> output;
+
+    for (hsize_t row = 0; row < rows; ) {
+        if (this->m_cancelled)
+            return false;
+
+        auto count = std::min(chunkRows, rows - row);
+        buffer.resize(count * cols);
+        readRows(dataset, H5T_NATIVE_DOUBLE, row, count, cols, buffer.data());
+        row += count;
+
+        for (hsize_t i = 0; i < count; ++i) {
+            for (hsize_t x = 0; x < cols; ++x) {
+                auto value = buffer[i * cols + x];
+                if (value != value)
+                    continue;
+                sums[x] += value;
+                ++counts[x];
+            }
+            if (++bucketFill < bucketSize && !(row == rows && i == count - 1))
+                continue;
+            for (hsize_t x = 0; x < cols; ++x) {
+                output.push_back(counts[x] > 0 ? sums[x] / counts[x] : std::numeric_limits<double>::quiet_NaN());
+                sums[x] = 0;
+                counts[x] = 0;
+            }
+            bucketFill = 0;
+        }
+
+        if (!output.empty()) {
+            emit this->rowsWaterfall(plotIdx, output, static_cast<std::size_t>(cols));
+            output.clear();
+        }
+    }
+    return true;
+}
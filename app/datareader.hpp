@@ -0,0 +1,86 @@
+/*
+ * ExaPlot
+ * data file reader
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include "hdf5.h"
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include "datamanager.hpp"
+
+
+/**
+ * @brief Streams the datasets of a previously recorded data file back into the plots.
+ * 
+ * Datasets are never loaded in full: rows are read in fixed-size hyperslabs, 2D data is decimated
+ * (min/max per bucket) down to a bounded number of points per dataset and waterfall rows are
+ * averaged down to a bounded number of map rows, so the memory and GUI cost of a replay is
+ * independent of the size of the file.
+ * 
+ */
+class DataReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef struct
+    {
+        hsize_t rows2D;
+        hsize_t rowsCM;
+        hsize_t rowsWaterfall;
+        double keyMin;
+        double keyMax;
+    } DatasetInfo;
+
+    constexpr static hsize_t CHUNK_ROWS = 65536;
+    constexpr static hsize_t LOD_BUCKETS = 4096;
+    constexpr static hsize_t WATERFALL_ROWS = 1024;
+
+    DataReader();
+    ~DataReader();
+
+    void cancel();
+
+Q_SIGNALS:
+    void opened(bool, const QString&, const std::vector<DataReader::DatasetInfo>&);
+    void loaded(bool, const QString&);
+    void cleared();
+    void data2D(std::size_t plotIdx, std::size_t trace, const QVector<double>& x, const QVector<double>& y);
+    void sizeCM(std::size_t plotIdx, int x, int y);
+    void dataCM(std::size_t plotIdx, const std::vector<CMData>& cells);
+    void rowsWaterfall(std::size_t plotIdx, const std::vector<double>& rows, std::size_t columns);
+
+public Q_SLOTS:
+    void open(const std::filesystem::path& path);
+    void seek(double from, double to);
+    void close();
+
+private:
+    typedef struct
+    {
+        hid_t twoDimen;
+        hid_t colorMap;
+        hid_t waterfall;
+    } Datasets;
+
+    bool load2D(std::size_t plotIdx, hid_t dataset, hsize_t start, hsize_t end);
+    bool loadCM(std::size_t plotIdx, hid_t dataset);
+    bool loadWaterfall(std::size_t plotIdx, hid_t dataset);
+
+    std::atomic_bool m_cancelled;
+    hid_t m_fileID;
+    std::vector<Datasets> m_datasets;
+};
@@ -0,0 +1,131 @@
+/*
+ * ExaPlot
+ * data file segment index
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "datasegments.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+
+static std::string
+jsonString(const std::string& value)
+{
+    std::string json{"\""};
+    for (auto c : value) {
+        if (c == '"' || c == '\\') {
+            json.push_back('\\');
+            json.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(c));
+            json.append(escape);
+        } else {
+            json.push_back(c);
+        }
+    }
+    return json.append("\"");
+}
+
+
+static std::string
+jsonTime(SegmentIndex::Time time)
+{
+    char number[32];
+    auto seconds = std::chrono::duration<double>{time.time_since_epoch()}.count();
+    std::snprintf(number, sizeof(number), "%.3f", seconds);
+    return number;
+}
+
+
+/**
+ * @brief Index of the segments of the data file at the given path (the first segment's).
+ * 
+ * @param path 
+ */
+SegmentIndex::SegmentIndex(const std::filesystem::path& path)
+    : m_path{std::filesystem::path{path}.concat(".segments.json")}
+    , m_mutex{}
+    , m_segments{}
+{
+}
+
+
+/**
+ * @brief Path of a segment of the data file at the given path: the first segment is the path
+ * itself, the segment after it `<stem>.0001<extension>` and so on (e.g. data.hdf5, data.0001.hdf5,
+ * data.0002.hdf5).
+ * 
+ * @param path 
+ * @param segment 
+ * @return std::filesystem::path 
+ */
+std::filesystem::path
+SegmentIndex::segmentPath(const std::filesystem::path& path, std::size_t segment)
+{
+    if (segment == 0)
+        return path;
+    char number[24];
+    std::snprintf(number, sizeof(number), ".%04zu", segment);
+    auto name = path.stem().concat(number).concat(path.extension().native());
+    return path.parent_path() / name;
+}
+
+
+void
+SegmentIndex::add(const std::filesystem::path& segment, Time start)
+{
+    std::lock_guard lock{this->m_mutex};
+    this->m_segments.push_back({segment.filename(), start, std::nullopt, false});
+    this->write();
+}
+
+
+void
+SegmentIndex::end(std::size_t segment, Time end)
+{
+    std::lock_guard lock{this->m_mutex};
+    this->m_segments.at(segment).end = end;
+    this->write();
+}
+
+
+void
+SegmentIndex::setClosed(std::size_t segment)
+{
+    std::lock_guard lock{this->m_mutex};
+    this->m_segments.at(segment).closed = true;
+    this->write();
+}
+
+
+void
+SegmentIndex::write()
+{
+    auto temporary = std::filesystem::path{this->m_path}.concat(".tmp");
+    {
+        std::ofstream output{temporary, std::ios::trunc};
+        output << "{\"segments\": [";
+        for (std::size_t i = 0; i < this->m_segments.size(); ++i) {
+            const auto& segment = this->m_segments[i];
+            output << (i ? ",\n  " : "\n  ")
+                << "{\"path\": " << jsonString(segment.path.u8string())
+                << ", \"start\": " << jsonTime(segment.start)
+                << ", \"end\": " << (segment.end ? jsonTime(*segment.end) : "null")
+                << ", \"closed\": " << (segment.closed ? "true" : "false") << "}";
+        }
+        output << "\n]}\n";
+        if (!output)
+            throw std::runtime_error{"failed to write data file segment index"};
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, this->m_path, ec);
+    if (ec)
+        throw std::runtime_error{"failed to replace data file segment index"};
+}
@@ -0,0 +1,62 @@
+/*
+ * ExaPlot
+ * data file segment index
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+
+/**
+ * @brief Index of the segments of a rotated data file: a JSON file next to the first segment
+ * (`<path>.segments.json`) listing the segments in order, with the (wall-clock) time range of the
+ * data written to each and whether it has been closed, e.g.
+ * 
+ *     {"segments": [
+ *       {"path": "data.hdf5", "start": 1718000000.125, "end": 1718003600.5, "closed": true},
+ *       {"path": "data.0001.hdf5", "start": 1718003600.5, "end": null, "closed": false}
+ *     ]}
+ * 
+ * Times are seconds since the Unix epoch; paths are relative to the index. The index is rewritten
+ * (through a temporary file, so readers never see a partial index) each time it changes. Segments
+ * are closed in the background, so the index is shared with the threads closing them.
+ * 
+ */
+class SegmentIndex
+{
+public:
+    typedef std::chrono::system_clock::time_point Time;
+
+    explicit SegmentIndex(const std::filesystem::path& path);
+
+    static std::filesystem::path segmentPath(const std::filesystem::path& path, std::size_t segment);
+
+    const std::filesystem::path& path() const { return this->m_path; }
+    void add(const std::filesystem::path& segment, Time start);
+    void end(std::size_t segment, Time end);
+    void setClosed(std::size_t segment);
+
+private:
+    struct Segment
+    {
+        std::filesystem::path path;
+        Time start;
+        std::optional<Time> end;
+        bool closed;
+    };
+
+    void write();
+
+    std::filesystem::path m_path;
+    std::mutex m_mutex;
+    std::vector<Segment> m_segments;
+};
@@ -0,0 +1,415 @@
+/*
+ * ExaPlot
+ * data file storage backends
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "datastorage.hpp"
+#include "datarawstorage.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+
+std::unique_ptr<DataStorage>
+DataStorage::create(exa::StorageFormat format)
+{
+    switch (format) {
+        case exa::StorageFormat::HDF5:
+            return std::make_unique<HDF5Storage>();
+        case exa::StorageFormat::RAW:
+            return std::make_unique<RawStorage>();
+    }
+    throw std::runtime_error{"invalid storage format"};
+}
+
+
+/**
+ * @brief Lock held by every call into the HDF5 library (recursive, so the backend's methods can call
+ * each other).
+ * 
+ * @return std::recursive_mutex& 
+ */
+std::recursive_mutex&
+HDF5Storage::mutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+
+HDF5Dataset::HDF5Dataset(hid_t dataset, hid_t datatype, std::size_t rowElements, std::size_t chunkRows,
+                         ChunkCompressor* compressor)
+    : m_dataset{dataset}
+    , m_datatype{datatype}
+    , m_elementSize{H5Tget_size(datatype)}
+    , m_rowElements{rowElements}
+    , m_compressor{compressor}
+    , m_chunkRows{static_cast<hsize_t>(chunkRows)}
+    , m_chunkElements{rowElements}
+    , m_chunks{}
+{
+}
+
+
+HDF5Dataset::~HDF5Dataset()
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    try {
+        this->writeChunks(true);
+    } catch (std::runtime_error const& e) {
+        std::cerr << "Failed to write chunks during destruction: " << e.what() << '\n';
+    }
+    H5Dclose(this->m_dataset);
+}
+
+
+void
+HDF5Dataset::append(const void* data, std::size_t rows)
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    if (rows == 0)
+        return;
+
+    auto dataspaceID = H5Dget_space(this->m_dataset);
+    if (dataspaceID == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to get dataspace (initial)"};
+
+    // retrieve current dataset dimensions
+    hsize_t currentDims[2] = {0};
+    int ndims = H5Sget_simple_extent_dims(dataspaceID, currentDims, NULL);
+    H5Sclose(dataspaceID);
+    if (ndims < 0)
+        throw std::runtime_error{"failed to retrieve dataset dimensions"};
+
+    auto length = static_cast<hsize_t>(rows);
+    auto bytes = static_cast<const std::uint8_t*>(data);
+    auto rowBytes = this->m_rowElements * this->m_elementSize;
+
+    // extend the dataset
+    hsize_t updatedDims[2] = {currentDims[0] + length, static_cast<hsize_t>(this->m_rowElements)};
+    if (H5Dset_extent(this->m_dataset, updatedDims) < 0)
+        throw std::runtime_error{"failed to extend dataset"};
+
+    hsize_t written = 0;
+    if (this->m_compressor && this->m_compressor->workers() && this->m_rowElements == this->m_chunkElements) {
+        // rows completing a chunk begun by an earlier write go through the filter pipeline
+        auto start = currentDims[0];
+        written = std::min((this->m_chunkRows - start % this->m_chunkRows) % this->m_chunkRows, length);
+        this->writeRows(start, bytes, written);
+
+        auto chunkBytes = static_cast<std::size_t>(this->m_chunkRows) * rowBytes;
+        for (; length - written >= this->m_chunkRows; written += this->m_chunkRows) {
+            auto chunk = bytes + written * rowBytes;
+            this->m_chunks.push_back({
+                start + written,
+                this->m_compressor->compress(ChunkCompressor::Chunk(chunk, chunk + chunkBytes), this->m_elementSize)
+            });
+        }
+    }
+    this->writeRows(currentDims[0] + written, bytes + written * rowBytes, length - written);
+    this->writeChunks(false);
+}
+
+
+void
+HDF5Dataset::setRowElements(std::size_t elements)
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    auto dataspaceID = H5Dget_space(this->m_dataset);
+    if (dataspaceID == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to get dataspace"};
+    hsize_t dims[2] = {0};
+    int ndims = H5Sget_simple_extent_dims(dataspaceID, dims, NULL);
+    H5Sclose(dataspaceID);
+    if (ndims < 0)
+        throw std::runtime_error{"failed to retrieve dataset dimensions"};
+
+    dims[1] = elements;
+    if (H5Dset_extent(this->m_dataset, dims) < 0)
+        throw std::runtime_error{"failed to widen dataset"};
+    this->m_rowElements = elements;
+}
+
+
+void
+HDF5Dataset::flush()
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    this->writeChunks(true);
+    if (H5Dflush(this->m_dataset) < 0)
+        throw std::runtime_error{"failed to flush dataset"};
+}
+
+
+void
+HDF5Dataset::setAttribute(const char* name, const std::vector<std::uint64_t>& values)
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    this->writeAttribute(name, H5T_STD_U64LE, H5T_NATIVE_UINT64, values.size(), values.data());
+}
+
+
+void
+HDF5Dataset::setAttribute(const char* name, const std::vector<double>& values)
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    this->writeAttribute(name, H5T_IEEE_F64LE, H5T_NATIVE_DOUBLE, values.size(), values.data());
+}
+
+
+/**
+ * @brief Write rows to the (already extended) dataset.
+ * 
+ * @param datasetRow first row of the dataset to write
+ * @param data 
+ * @param rows 
+ */
+void
+HDF5Dataset::writeRows(hsize_t datasetRow, const std::uint8_t* data, hsize_t rows)
+{
+    if (rows == 0)
+        return;
+
+    // select the extended region
+    auto dataspaceID = H5Dget_space(this->m_dataset);
+    if (dataspaceID == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to get dataspace (extended)"};
+    hsize_t start[] = {datasetRow, 0};
+    hsize_t count[] = {rows, static_cast<hsize_t>(this->m_rowElements)};
+    if (H5Sselect_hyperslab(dataspaceID, H5S_SELECT_SET, start, NULL, count, NULL) < 0)
+        throw std::runtime_error{"failed to select extended dataspace"};
+
+    auto memspaceID = H5Screate_simple(2, count, NULL);
+    if (memspaceID == H5I_INVALID_HID) {
+        H5Sclose(dataspaceID);
+        throw std::runtime_error{"failed to create memory dataspace"};
+    }
+
+    // write the rows to the extended region of the dataset
+    auto status = H5Dwrite(
+        this->m_dataset,
+        this->m_datatype,
+        memspaceID,
+        dataspaceID,
+        H5P_DEFAULT,
+        data
+    );
+
+    // TODO: check close returns?
+    H5Sclose(dataspaceID);
+    H5Sclose(memspaceID);
+    if (status < 0)
+        throw std::runtime_error{"failed to write buffer to dataset"};
+}
+
+
+/**
+ * @brief Write the chunks compressed by the compressor's workers to the dataset, in order, up to
+ * the first chunk still being compressed (or all of them, waiting on the workers). The number of
+ * chunks in flight is kept to twice the number of workers.
+ * 
+ * @param wait 
+ */
+void
+HDF5Dataset::writeChunks(bool wait)
+{
+    while (!this->m_chunks.empty()) {
+        auto& front = this->m_chunks.front();
+        if (!wait && this->m_chunks.size() <= 2 * this->m_compressor->workers()
+            && front.data.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+            break;
+        hsize_t offset[] = {front.row, 0};
+        auto data = std::move(front.data);
+        this->m_chunks.pop_front();
+
+        auto chunk = data.get();
+        if (H5Dwrite_chunk(this->m_dataset, H5P_DEFAULT, 0, offset, chunk.size(), chunk.data()) < 0)
+            throw std::runtime_error{"failed to write chunk to dataset"};
+    }
+}
+
+
+void
+HDF5Dataset::writeAttribute(const char* name, hid_t fileType, hid_t memType, std::size_t size, const void* data)
+{
+    if (H5Aexists(this->m_dataset, name) > 0 && H5Adelete(this->m_dataset, name) < 0)
+        throw std::runtime_error{"failed to replace attribute"};
+
+    hsize_t dim[] = {static_cast<hsize_t>(size)};
+    auto dataspace = H5Screate_simple(1, dim, NULL);
+    if (dataspace == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to create attribute dataspace"};
+    auto attribute = H5Acreate(this->m_dataset, name, fileType, dataspace, H5P_DEFAULT, H5P_DEFAULT);
+    H5Sclose(dataspace);
+    if (attribute == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to create attribute"};
+    auto status = H5Awrite(attribute, memType, data);
+    H5Aclose(attribute);
+    if (status < 0)
+        throw std::runtime_error{"failed to write attribute"};
+}
+
+
+HDF5Storage::HDF5Storage()
+    : m_fileID{H5I_INVALID_HID}
+    , m_owned{true}
+    , m_swmr{false}
+{
+}
+
+
+/**
+ * @brief Write to an already open HDF5 file (which is left open).
+ * 
+ * @param fileID 
+ */
+HDF5Storage::HDF5Storage(hid_t fileID)
+    : m_fileID{fileID}
+    , m_owned{false}
+    , m_swmr{false}
+{
+}
+
+
+HDF5Storage::~HDF5Storage()
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    if (this->m_owned && this->m_fileID != H5I_INVALID_HID)
+        H5Fclose(this->m_fileID);
+}
+
+
+/**
+ * @brief Create the HDF5 file. In SWMR mode, the file is created with the latest file format.
+ * 
+ * @param path 
+ * @param swmr 
+ */
+void
+HDF5Storage::open(const std::filesystem::path& path, bool swmr)
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    auto accessList = H5Pcreate(H5P_FILE_ACCESS);
+    if (accessList == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to create HDF5 file access property list"};
+    if (swmr && H5Pset_libver_bounds(accessList, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST) < 0) {
+        H5Pclose(accessList);
+        throw std::runtime_error{"failed to set HDF5 library version bounds"};
+    }
+    this->m_fileID = H5Fcreate(path.string().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, accessList);
+    H5Pclose(accessList);
+    if (this->m_fileID == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to create HDF5 file"};
+    this->m_owned = true;
+    this->m_swmr = false;
+}
+
+
+void
+HDF5Storage::close()
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    if (this->m_fileID == H5I_INVALID_HID)
+        return;
+    auto status = this->m_owned ? H5Fclose(this->m_fileID) : 0;
+    this->m_fileID = H5I_INVALID_HID;
+    this->m_swmr = false;
+    if (status < 0)
+        throw std::runtime_error{"failed to close HDF5 file"};
+}
+
+
+void
+HDF5Storage::startSWMR()
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    if (H5Fstart_swmr_write(this->m_fileID) < 0)
+        throw std::runtime_error{"failed to start SWMR write mode"};
+    this->m_swmr = true;
+}
+
+
+std::uint64_t
+HDF5Storage::size() const
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    hsize_t size = 0;
+    if (this->m_fileID == H5I_INVALID_HID || H5Fget_filesize(this->m_fileID, &size) < 0)
+        return 0;
+    return static_cast<std::uint64_t>(size);
+}
+
+
+void
+HDF5Storage::createGroup(const std::string& name)
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    auto group = H5Gcreate(this->m_fileID, name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (group == H5I_INVALID_HID)
+        throw std::runtime_error{"failed to create group"};
+    H5Gclose(group);
+}
+
+
+std::unique_ptr<StoredDataset>
+HDF5Storage::createDataset(
+    const std::string& name,
+    hid_t datatype,
+    std::size_t rowElements,
+    bool growable,
+    const void* fill,
+    std::size_t chunkRows,
+    ChunkCompressor* compressor)
+{
+    std::lock_guard lock{HDF5Storage::mutex()};
+    auto numElements = static_cast<hsize_t>(rowElements);
+    hsize_t chunkDim[] = {static_cast<hsize_t>(chunkRows), numElements};
+    auto propertyList = H5Pcreate(H5P_DATASET_CREATE);
+    if (propertyList == H5I_INVALID_HID) {
+        throw std::runtime_error{"error creating HDF5 property list"};
+    }
+    if (H5Pset_chunk(propertyList, 2, chunkDim) < 0) {
+        H5Pclose(propertyList);
+        throw std::runtime_error{"error setting chunk property"};
+    }
+    // (the shuffle filter goes first)
+    if (compressor && (H5Pset_shuffle(propertyList) < 0 || H5Pset_deflate(propertyList, compressor->level()) < 0)) {
+        H5Pclose(propertyList);
+        throw std::runtime_error{"error setting compression filters"};
+    }
+    // columns added to a growable dataset read as the fill value for the rows written before them
+    if (growable && fill && H5Pset_fill_value(propertyList, datatype, fill) < 0) {
+        H5Pclose(propertyList);
+        throw std::runtime_error{"error setting fill value property"};
+    }
+
+    hsize_t dim[] = {0, numElements};
+    hsize_t maxDim[] = {H5S_UNLIMITED, growable ? H5S_UNLIMITED : numElements};
+    auto dataspace = H5Screate_simple(2, dim, maxDim);
+    if (dataspace == H5I_INVALID_HID) {
+        H5Pclose(propertyList);
+        throw std::runtime_error{"error creating HDF5 dataspace"};
+    }
+
+    auto dataset = H5Dcreate(
+        this->m_fileID,
+        name.c_str(),
+        datatype,
+        dataspace,
+        H5P_DEFAULT,
+        propertyList,
+        H5P_DEFAULT
+    );
+    H5Sclose(dataspace);
+    H5Pclose(propertyList);
+    if (dataset == H5I_INVALID_HID) {
+        throw std::runtime_error{"error creating HDF5 dataset"};
+    }
+    return std::make_unique<HDF5Dataset>(dataset, datatype, rowElements, chunkRows, compressor);
+}
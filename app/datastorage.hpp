@@ -0,0 +1,238 @@
+/*
+ * ExaPlot
+ * data file storage backends
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include "hdf5.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dataconfig.hpp"
+#include "datacompressor.hpp"
+
+
+/**
+ * @brief A dataset of a data file: a growing list of rows of a fixed number of elements. Rows are
+ * appended in blocks by the dataset buffers (`DataSet`).
+ * 
+ */
+class StoredDataset
+{
+public:
+    virtual ~StoredDataset() = default;
+
+    /**
+     * @brief Whether data is to be buffered before it's appended (`false` for backends where an
+     * append is as cheap as copying to a buffer).
+     * 
+     * @return true 
+     * @return false 
+     */
+    virtual bool buffered() const = 0;
+
+    /**
+     * @brief Whether appended rows are still waiting to be written (see `flush`).
+     * 
+     * @return true 
+     * @return false 
+     */
+    virtual bool pending() const = 0;
+
+    /**
+     * @brief Append rows (of the dataset's current width) to the dataset.
+     * 
+     * @param data 
+     * @param rows 
+     */
+    virtual void append(const void* data, std::size_t rows) = 0;
+
+    /**
+     * @brief Widen the rows of a (growable) dataset; the rows already in the dataset read the fill
+     * value in the new elements.
+     * 
+     * @param elements 
+     */
+    virtual void setRowElements(std::size_t elements) = 0;
+
+    /**
+     * @brief Write any pending rows and flush the dataset to the file.
+     * 
+     */
+    virtual void flush() = 0;
+
+    virtual void setAttribute(const char* name, const std::vector<std::uint64_t>& values) = 0;
+    virtual void setAttribute(const char* name, const std::vector<double>& values) = 0;
+};
+
+
+/**
+ * @brief A data file, as written by one of the storage backends.
+ * 
+ */
+class DataStorage
+{
+public:
+    virtual ~DataStorage() = default;
+
+    static std::unique_ptr<DataStorage> create(exa::StorageFormat format);
+
+    /**
+     * @brief Create the data file (replacing any existing one).
+     * 
+     * @param path 
+     * @param swmr create the file such that it can be read while it's written (see `startSWMR`)
+     */
+    virtual void open(const std::filesystem::path& path, bool swmr) = 0;
+
+    /**
+     * @brief Close the data file. The datasets must have been destroyed beforehand.
+     * 
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief Allow readers to open the file while it's written. No datasets or groups may be
+     * created afterwards (see `frozen`).
+     * 
+     */
+    virtual void startSWMR() = 0;
+
+    /**
+     * @brief Whether datasets and groups can no longer be created.
+     * 
+     * @return true 
+     * @return false 
+     */
+    virtual bool frozen() const = 0;
+
+    /**
+     * @brief Size of the data file (so far), in bytes.
+     * 
+     * @return std::uint64_t 
+     */
+    virtual std::uint64_t size() const = 0;
+
+    virtual void createGroup(const std::string& name) = 0;
+
+    /**
+     * @brief Create an (empty) dataset.
+     * 
+     * @param name dataset name (relative to the file, i.e. may be within a group)
+     * @param datatype HDF5 datatype of the elements (as stored)
+     * @param rowElements 
+     * @param growable whether the rows can be widened
+     * @param fill fill value of elements added by widening the rows (null for zero)
+     * @param chunkRows rows per chunk (if the backend stores data in chunks)
+     * @param compressor chunk compressor (if the backend supports compression)
+     * @return std::unique_ptr<StoredDataset> 
+     */
+    virtual std::unique_ptr<StoredDataset> createDataset(
+        const std::string& name,
+        hid_t datatype,
+        std::size_t rowElements,
+        bool growable,
+        const void* fill,
+        std::size_t chunkRows,
+        ChunkCompressor* compressor) = 0;
+};
+
+
+/**
+ * @brief Dataset of an HDF5 file. With a compressor, the dataset is created with the shuffle and
+ * deflate filters and complete chunks are compressed by the compressor's workers and written as is
+ * (`H5Dwrite_chunk`); any other rows go through HDF5's filter pipeline. The chunks are written in
+ * order as they're completed, so appending only waits on the workers once too many chunks are in
+ * flight.
+ * 
+ */
+class HDF5Dataset : public StoredDataset
+{
+public:
+    HDF5Dataset(hid_t dataset, hid_t datatype, std::size_t rowElements, std::size_t chunkRows,
+                ChunkCompressor* compressor);
+    ~HDF5Dataset();
+
+    HDF5Dataset(const HDF5Dataset&) = delete;
+    HDF5Dataset& operator=(const HDF5Dataset&) = delete;
+
+    bool buffered() const override { return true; }
+    bool pending() const override { return !this->m_chunks.empty(); }
+    void append(const void* data, std::size_t rows) override;
+    void setRowElements(std::size_t elements) override;
+    void flush() override;
+    void setAttribute(const char* name, const std::vector<std::uint64_t>& values) override;
+    void setAttribute(const char* name, const std::vector<double>& values) override;
+
+private:
+    struct PendingChunk
+    {
+        hsize_t row;
+        std::future<ChunkCompressor::Chunk> data;
+    };
+
+    void writeRows(hsize_t datasetRow, const std::uint8_t* data, hsize_t rows);
+    void writeChunks(bool wait);
+    void writeAttribute(const char* name, hid_t fileType, hid_t memType, std::size_t size, const void* data);
+
+    hid_t m_dataset;
+    hid_t m_datatype;
+    std::size_t m_elementSize;
+    std::size_t m_rowElements;
+    ChunkCompressor* m_compressor;
+    hsize_t m_chunkRows;
+    std::size_t m_chunkElements;
+    std::deque<PendingChunk> m_chunks;
+};
+
+
+/**
+ * @brief HDF5 data file. The HDF5 library isn't built thread-safe, but the segments of a rotated
+ * data file are closed on other threads than the one writing the next segment, so every call into
+ * the library made by the HDF5 backend holds the backend's lock (see `mutex`).
+ * 
+ */
+class HDF5Storage : public DataStorage
+{
+public:
+    HDF5Storage();
+    explicit HDF5Storage(hid_t fileID);
+    ~HDF5Storage();
+
+    HDF5Storage(const HDF5Storage&) = delete;
+    HDF5Storage& operator=(const HDF5Storage&) = delete;
+
+    static std::recursive_mutex& mutex();
+
+    void open(const std::filesystem::path& path, bool swmr) override;
+    void close() override;
+    void startSWMR() override;
+    bool frozen() const override { return this->m_swmr; }
+    std::uint64_t size() const override;
+    void createGroup(const std::string& name) override;
+    std::unique_ptr<StoredDataset> createDataset(
+        const std::string& name,
+        hid_t datatype,
+        std::size_t rowElements,
+        bool growable,
+        const void* fill,
+        std::size_t chunkRows,
+        ChunkCompressor* compressor) override;
+
+private:
+    hid_t m_fileID;
+    bool m_owned;
+    bool m_swmr;
+};
@@ -0,0 +1,178 @@
+/*
+ * ExaPlot
+ * compact plot data store
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "columnstore.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+ColumnStore::ColumnStore(bool singlePrecision)
+    : m_singlePrecision{singlePrecision}
+    , m_chunks{}
+    , m_points{0}
+    , m_bytes{0}
+{
+}
+
+
+/**
+ * @brief Appends a block of points (in key order) as a chunk.
+ * 
+ * @param data 
+ * @param count 
+ * @param offset set to the offset (in points) of the block within the store
+ * @return true 
+ * @return false the block wouldn't be any smaller in the store
+ */
+bool
+ColumnStore::append(const QCPGraphData* data, std::size_t count, std::size_t& offset)
+{
+    if (count == 0)
+        return false;
+    Chunk chunk{this->m_points, count, 0., 0., {}, {}, {}};
+    auto implicit = uniform(data, count, chunk.x0, chunk.dx);
+    auto single = this->m_singlePrecision;
+    for (std::size_t i = 0; single && i < count; ++i) {
+        auto value = data[i].value;
+        if (std::isfinite(value) && std::abs(value) > std::numeric_limits<float>::max())
+            single = false;
+    }
+    if (!implicit && !single)
+        return false;
+
+    if (!implicit) {
+        chunk.keys.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+            chunk.keys[i] = data[i].key;
+    }
+    if (single) {
+        chunk.values32.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+            chunk.values32[i] = static_cast<float>(data[i].value);
+    } else {
+        chunk.values64.resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+            chunk.values64[i] = data[i].value;
+    }
+
+    this->m_bytes += sizeof(Chunk)
+        + chunk.keys.capacity() * sizeof(double)
+        + chunk.values32.capacity() * sizeof(float)
+        + chunk.values64.capacity() * sizeof(double);
+    this->m_chunks.push_back(std::move(chunk));
+    offset = this->m_points;
+    this->m_points += count;
+    return true;
+}
+
+
+/**
+ * @brief Expands a block of points back (replacing the contents of `data`). The block may span
+ * several chunks.
+ * 
+ * @param offset 
+ * @param count 
+ * @param data 
+ * @return true 
+ * @return false the block isn't in the store
+ */
+bool
+ColumnStore::read(std::size_t offset, std::size_t count, QVector<QCPGraphData>& data)
+{
+    if (count == 0 || offset + count > this->m_points)
+        return false;
+    data.resize(static_cast<qsizetype>(count));
+    auto out = data.data();
+    auto chunk = std::upper_bound(
+        this->m_chunks.cbegin(),
+        this->m_chunks.cend(),
+        offset,
+        [](std::size_t point, const Chunk& chunk) { return point < chunk.offset; }
+    ) - 1;
+    for (auto position = offset; position < offset + count; ++chunk) {
+        auto begin = position - chunk->offset;
+        auto end = std::min(chunk->count, offset + count - chunk->offset);
+        expand(*chunk, begin, end, out);
+        out += end - begin;
+        position = chunk->offset + end;
+    }
+    return true;
+}
+
+
+void
+ColumnStore::clear()
+{
+    this->m_chunks.clear();
+    this->m_points = 0;
+    this->m_bytes = 0;
+}
+
+
+std::size_t
+ColumnStore::memoryUsage() const
+{
+    return this->m_bytes;
+}
+
+
+bool
+ColumnStore::singlePrecision() const
+{
+    return this->m_singlePrecision;
+}
+
+
+/**
+ * @brief Whether the keys of a block are evenly spaced, i.e. each is within a millionth of the
+ * spacing of `x0 + i * dx` (which is far below what can be told apart on screen).
+ * 
+ * @param data 
+ * @param count 
+ * @param x0 set to the first key
+ * @param dx set to the spacing
+ * @return true 
+ * @return false 
+ */
+bool
+ColumnStore::uniform(const QCPGraphData* data, std::size_t count, double& x0, double& dx)
+{
+    x0 = data[0].key;
+    dx = count > 1 ? (data[count - 1].key - x0) / static_cast<double>(count - 1) : 0.;
+    if (!std::isfinite(x0) || !std::isfinite(dx) || dx < 0.)
+        return false;
+    auto tolerance = dx * 1e-6;
+    for (std::size_t i = 1; i < count; ++i) {
+        // (NaN keys fail the comparison)
+        if (!(std::abs(x0 + static_cast<double>(i) * dx - data[i].key) <= tolerance))
+            return false;
+    }
+    return true;
+}
+
+
+void
+ColumnStore::expand(const Chunk& chunk, std::size_t begin, std::size_t end, QCPGraphData* out)
+{
+    if (chunk.keys.empty()) {
+        for (auto i = begin; i < end; ++i)
+            out[i - begin].key = chunk.x0 + static_cast<double>(i) * chunk.dx;
+    } else {
+        for (auto i = begin; i < end; ++i)
+            out[i - begin].key = chunk.keys[i];
+    }
+    if (chunk.values32.empty()) {
+        for (auto i = begin; i < end; ++i)
+            out[i - begin].value = chunk.values64[i];
+    } else {
+        for (auto i = begin; i < end; ++i)
+            out[i - begin].value = static_cast<double>(chunk.values32[i]);
+    }
+}
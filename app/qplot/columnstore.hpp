@@ -0,0 +1,59 @@
+/*
+ * ExaPlot
+ * compact plot data store
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include "segmentstore.hpp"
+
+#include <vector>
+
+
+/**
+ * @brief In-memory store keeping 2D plot data in a compact, columnar form. Each appended block
+ * becomes a chunk with its keys and values in separate arrays (rather than QCP's `{key, value}`
+ * pairs), and is expanded back into points when read:
+ * - evenly spaced keys (the common case for sampled data) aren't stored at all, only the first key
+ *   and the spacing (`x0 + i * dx`)
+ * - with single precision, values are stored as `float` (blocks with values out of `float` range
+ *   are kept in double precision)
+ * 
+ * Blocks that wouldn't take less memory than their points (irregular keys in double precision) are
+ * refused.
+ * 
+ */
+class ColumnStore : public SegmentStore
+{
+public:
+    explicit ColumnStore(bool singlePrecision);
+
+    bool append(const QCPGraphData* data, std::size_t count, std::size_t& offset) override;
+    bool read(std::size_t offset, std::size_t count, QVector<QCPGraphData>& data) override;
+    void clear() override;
+    std::size_t memoryUsage() const override;
+    bool singlePrecision() const;
+
+private:
+    typedef struct
+    {
+        std::size_t offset;             // of the chunk's first point
+        std::size_t count;
+        double x0;
+        double dx;
+        std::vector<double> keys;       // empty if the keys are implicit
+        std::vector<float> values32;
+        std::vector<double> values64;   // (only one of the value arrays is used)
+    } Chunk;
+
+    static bool uniform(const QCPGraphData* data, std::size_t count, double& x0, double& dx);
+    static void expand(const Chunk& chunk, std::size_t begin, std::size_t end, QCPGraphData* out);
+
+    bool m_singlePrecision;
+    std::vector<Chunk> m_chunks;
+    std::size_t m_points;
+    std::size_t m_bytes;
+};
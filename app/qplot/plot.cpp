@@ -6,6 +6,10 @@
  * Copyright (C) 2024 bytemarx
  */
 
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+
 #include "plot.hpp"
 
 
@@ -82,6 +86,64 @@ Plot::widget()
 }
 
 
+/**
+ * @brief Select how the plot is drawn. The OpenGL renderer draws into a framebuffer object, which
+ * is only worth it with a hardware-accelerated context; without one (e.g. no display, or Mesa's
+ * llvmpipe on a headless machine) the plot stays on the raster renderer.
+ * 
+ * @param renderer 
+ */
+void
+Plot::setRenderer(Renderer renderer)
+{
+    this->m_plot->setOpenGl(renderer == OPENGL && Plot::hardwareOpenGl());
+}
+
+
+/**
+ * @brief The renderer actually in effect (QCustomPlot falls back to raster by itself if it fails to
+ * set up its OpenGL paint buffer).
+ * 
+ * @return Plot::Renderer 
+ */
+Plot::Renderer
+Plot::renderer() const
+{
+    return this->m_plot->openGl() ? OPENGL : RASTER;
+}
+
+
+/**
+ * @brief Whether an OpenGL context can be created and is backed by a hardware renderer (probed
+ * once).
+ * 
+ * @return bool 
+ */
+bool
+Plot::hardwareOpenGl()
+{
+    static const bool available = [] {
+        QOpenGLContext context;
+        if (!context.create())
+            return false;
+        QOffscreenSurface surface;
+        surface.setFormat(context.format());
+        surface.create();
+        if (!surface.isValid() || !context.makeCurrent(&surface))
+            return false;
+        auto name = QString::fromLatin1(
+            reinterpret_cast<const char*>(context.functions()->glGetString(GL_RENDERER))
+        );
+        context.doneCurrent();
+        return !name.isEmpty()
+            && !name.contains("llvmpipe", Qt::CaseInsensitive)
+            && !name.contains("softpipe", Qt::CaseInsensitive)
+            && !name.contains("software", Qt::CaseInsensitive);
+    }();
+    return available;
+}
+
+
 void
 Plot::doubleClick()
 {
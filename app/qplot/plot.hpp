@@ -24,11 +24,21 @@ public:
     };
     Q_ENUM(Type)
 
+    enum Renderer {
+        RASTER,
+        OPENGL,
+    };
+    Q_ENUM(Renderer)
+
     virtual ~Plot();
     virtual Type type() const = 0;
     virtual void clear() = 0;
     virtual void replot() = 0;
+    virtual std::size_t memoryUsage() const = 0;
     QCustomPlot* widget();
+    void setRenderer(Renderer renderer);
+    Renderer renderer() const;
+    static bool hardwareOpenGl();
 
 private Q_SLOTS:
     void doubleClick();
@@ -7,6 +7,710 @@
  */
 
 #include "plot2d.hpp"
+#include "columnstore.hpp"
+#include "spillfile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+GraphData::GraphData()
+    : QCPGraphDataContainer{}
+    , m_keyBounds{}
+    , m_valueBounds{}
+    , m_boundsValid{true}
+    , m_blocks{}
+    , m_blocksValid{true}
+    , m_segments{}
+    , m_store{}
+    , m_storage{FULL}
+{
+    this->resetBounds();
+}
+
+
+/**
+ * @brief Sets where the segments moved out of the container go. Segments already moved out are read
+ * back first.
+ * 
+ * @param storage 
+ */
+void
+GraphData::setStorage(Storage storage)
+{
+    if (storage == this->m_storage)
+        return;
+    this->unspill();
+    this->m_store.reset();
+    this->m_storage = storage;
+}
+
+
+GraphData::Storage
+GraphData::storage() const
+{
+    return this->m_storage;
+}
+
+
+/**
+ * @brief Appends a single point (see the block overload).
+ * 
+ * @param key 
+ * @param value 
+ */
+void
+GraphData::append(double key, double value)
+{
+    this->extendBounds(key, value);
+    if (!this->isEmpty() && key < (this->constEnd() - 1)->key) {
+        if (!this->m_segments.empty() && key < this->m_segments.back().upper)
+            this->unspill();
+        this->add(QCPGraphData{key, value});
+        this->m_blocksValid = false;
+        return;
+    }
+    this->reserveAppend(1);
+    this->extendBlocks(static_cast<std::size_t>(this->size()), value);
+    this->mData.append(QCPGraphData{key, value});
+}
+
+
+/**
+ * @brief Appends a block of points. Blocks that are in key order and start at or after the last
+ * key are copied straight to the end of the container: no temporary vector, no sort and no merge.
+ * Blocks that aren't are handed to the container's (sorting) `add`.
+ * 
+ * @param keys 
+ * @param values 
+ * @param length 
+ * @param sorted the keys are known to be non-decreasing (skips checking them)
+ */
+void
+GraphData::append(const double* keys, const double* values, std::size_t length, bool sorted)
+{
+    if (length == 0)
+        return;
+    sorted = sorted || std::is_sorted(keys, keys + length);
+    for (std::size_t i = 0; i < length; ++i)
+        this->extendBounds(keys[i], values[i]);
+
+    if (!sorted || (!this->isEmpty() && keys[0] < (this->constEnd() - 1)->key)) {
+        if (!this->m_segments.empty() && *std::min_element(keys, keys + length) < this->m_segments.back().upper)
+            this->unspill();
+        QVector<QCPGraphData> data(static_cast<qsizetype>(length));
+        for (std::size_t i = 0; i < length; ++i)
+            data[i] = {keys[i], values[i]};
+        this->add(data, sorted);
+        this->m_blocksValid = false;
+        return;
+    }
+
+    this->reserveAppend(length);
+    for (std::size_t i = 0; i < length; ++i) {
+        this->extendBlocks(static_cast<std::size_t>(this->size()), values[i]);
+        this->mData.append(QCPGraphData{keys[i], values[i]});
+    }
+}
+
+
+void
+GraphData::clear()
+{
+    QCPGraphDataContainer::clear();
+    this->resetBounds();
+    this->m_boundsValid = true;
+    this->m_blocks.clear();
+    this->m_blocksValid = true;
+    this->m_segments.clear();
+    if (this->m_store)
+        this->m_store->clear();
+}
+
+
+/**
+ * @brief Removes the points with keys less than `sortKey` (e.g. evicting the data that has
+ * scrolled out of a rolling window). Invalidates the bounds and the block bounds.
+ * 
+ * @param sortKey 
+ */
+void
+GraphData::removeBefore(double sortKey)
+{
+    this->unspill();
+    QCPGraphDataContainer::removeBefore(sortKey);
+    this->m_boundsValid = false;
+    this->m_blocksValid = false;
+}
+
+
+/**
+ * @brief Retrieves the key and value bounds of the data (NaN values are ignored). This is O(1)
+ * unless data has been removed since the last query.
+ * 
+ * @param keys 
+ * @param values 
+ * @return true 
+ * @return false there is no (non-NaN) data
+ */
+bool
+GraphData::bounds(QCPRange& keys, QCPRange& values)
+{
+    if (!this->m_boundsValid) {
+        this->resetBounds();
+        for (auto it = this->constBegin(); it != this->constEnd(); ++it)
+            this->extendBounds(it->key, it->value);
+        this->m_boundsValid = true;
+    }
+    if (this->m_keyBounds.lower > this->m_keyBounds.upper || this->m_valueBounds.lower > this->m_valueBounds.upper)
+        return false;
+    keys = this->m_keyBounds;
+    values = this->m_valueBounds;
+    return true;
+}
+
+
+/**
+ * @brief Retrieves the value bounds of each block of `BLOCK_SIZE` points (block `i` covers the points
+ * at `i * BLOCK_SIZE` up to `(i + 1) * BLOCK_SIZE`). Blocks of only NaN values have empty bounds
+ * (`lower > upper`). Rebuilt (once) if data was inserted out of order or removed since the last query.
+ * 
+ * @return const std::vector<GraphData::Block>& 
+ */
+const std::vector<GraphData::Block>&
+GraphData::blocks()
+{
+    if (!this->m_blocksValid) {
+        this->m_blocks.clear();
+        this->m_blocksValid = true;
+        std::size_t index = 0;
+        for (auto it = this->constBegin(); it != this->constEnd(); ++it)
+            this->extendBlocks(index++, it->value);
+    }
+    return this->m_blocks;
+}
+
+
+/**
+ * @brief Spills the oldest data to the segment store (the spill file, or the compact store), until
+ * at least `points` points' worth of memory has been freed (if there's that much to spill). Segments
+ * read back earlier go back to their summaries first, then new segments are spilled (always leaving
+ * the latest segment's worth of data). Segments that the given view needs in detail (see
+ * `GraphData::restore`) are left alone, as are segments the compact store can't make any smaller.
+ * 
+ * @param points 
+ * @param keys visible key range
+ * @param pixels width of the view
+ * @return std::size_t number of points' worth of memory freed
+ */
+std::size_t
+GraphData::spill(std::size_t points, const QCPRange& keys, double pixels)
+{
+    std::vector<Part> parts;
+    std::size_t start = 0;
+    std::size_t freed = 0;
+    for (auto& segment : this->m_segments) {
+        auto length = segment.resident ? segment.count : static_cast<std::size_t>(segment.summary.size());
+        auto release = segment.resident
+            && freed < points
+            && !needsDetail(segment.lower, segment.upper, segment.summary.size(), keys, pixels);
+        parts.push_back({length, release ? &segment.summary : nullptr});
+        if (release)
+            freed += segment.count - static_cast<std::size_t>(segment.summary.size());
+        start += length;
+    }
+
+    std::vector<Segment> added;
+    std::size_t spilled = 0;
+    auto available = static_cast<std::size_t>(this->size()) - start;
+    while (freed < points && available >= spilled + 2 * SPILL_SEGMENT_SIZE) {
+        auto begin = this->constBegin() + static_cast<qsizetype>(start + spilled);
+        auto last = begin + static_cast<qsizetype>(SPILL_SEGMENT_SIZE - 1);
+        auto summary = summarize(begin, SPILL_SEGMENT_SIZE);
+        if (needsDetail(begin->key, last->key, summary.size(), keys, pixels))
+            break;
+        if (!this->m_store) {
+            if (this->m_storage == FULL)
+                this->m_store = std::make_unique<SpillFile>();
+            else
+                this->m_store = std::make_unique<ColumnStore>(this->m_storage == COMPACT_FLOAT);
+        }
+        std::size_t offset = 0;
+        auto stored = this->m_store->memoryUsage();
+        if (!this->m_store->append(&*begin, SPILL_SEGMENT_SIZE, offset))
+            break;
+        stored = (this->m_store->memoryUsage() - stored + sizeof(QCPGraphData) - 1) / sizeof(QCPGraphData);
+        freed += SPILL_SEGMENT_SIZE - std::min(SPILL_SEGMENT_SIZE, static_cast<std::size_t>(summary.size()) + stored);
+        spilled += SPILL_SEGMENT_SIZE;
+        added.push_back({begin->key, last->key, offset, SPILL_SEGMENT_SIZE, summary, false});
+    }
+    if (freed == 0)
+        return 0;
+
+    for (const auto& segment : added)
+        parts.push_back({segment.count, &segment.summary});
+    this->rebuild(parts);
+    for (std::size_t i = 0; i < this->m_segments.size(); ++i)
+        if (parts[i].replacement != nullptr)
+            this->m_segments[i].resident = false;
+    this->m_segments.insert(this->m_segments.end(), added.begin(), added.end());
+    return freed;
+}
+
+
+/**
+ * @brief Reads back the spilled segments that the given view needs in detail: those overlapping the
+ * visible key range whose summary has less than two points per pixel (the view is zoomed in on them).
+ * 
+ * @param keys visible key range
+ * @param pixels width of the view
+ * @return std::size_t number of points read back into memory
+ */
+std::size_t
+GraphData::restore(const QCPRange& keys, double pixels)
+{
+    std::vector<Part> parts;
+    std::vector<QVector<QCPGraphData>> restored(this->m_segments.size());
+    std::size_t added = 0;
+    for (std::size_t i = 0; i < this->m_segments.size(); ++i) {
+        const auto& segment = this->m_segments[i];
+        auto length = segment.resident ? segment.count : static_cast<std::size_t>(segment.summary.size());
+        auto read = !segment.resident
+            && needsDetail(segment.lower, segment.upper, segment.summary.size(), keys, pixels)
+            && this->m_store->read(segment.offset, segment.count, restored[i]);
+        parts.push_back({length, read ? &restored[i] : nullptr});
+        if (read)
+            added += segment.count - length;
+    }
+    if (added == 0)
+        return 0;
+
+    this->rebuild(parts);
+    for (std::size_t i = 0; i < this->m_segments.size(); ++i)
+        if (parts[i].replacement != nullptr)
+            this->m_segments[i].resident = true;
+    return added;
+}
+
+
+/**
+ * @brief Memory held by the data (points, spill summaries, compacted segments and block bounds) in
+ * bytes.
+ * 
+ * @return std::size_t 
+ */
+std::size_t
+GraphData::memoryUsage() const
+{
+    auto points = static_cast<std::size_t>(this->size());
+    for (const auto& segment : this->m_segments)
+        points += static_cast<std::size_t>(segment.summary.size());
+    auto stored = this->m_store ? this->m_store->memoryUsage() : 0;
+    return points * sizeof(QCPGraphData) + stored + this->m_blocks.size() * sizeof(Block);
+}
+
+
+/**
+ * @brief Reads all spilled segments back and discards the spill file's contents (for changes that
+ * don't keep to the segments, i.e. out of order inserts or removals among the spilled data).
+ * 
+ */
+void
+GraphData::unspill()
+{
+    if (this->m_segments.empty())
+        return;
+    std::vector<Part> parts;
+    std::vector<QVector<QCPGraphData>> restored(this->m_segments.size());
+    for (std::size_t i = 0; i < this->m_segments.size(); ++i) {
+        const auto& segment = this->m_segments[i];
+        auto length = segment.resident ? segment.count : static_cast<std::size_t>(segment.summary.size());
+        // (a segment that can't be read back is left as its summary)
+        auto read = !segment.resident && this->m_store->read(segment.offset, segment.count, restored[i]);
+        parts.push_back({length, read ? &restored[i] : nullptr});
+    }
+    this->rebuild(parts);
+    this->m_segments.clear();
+    this->m_store->clear();
+}
+
+
+/**
+ * @brief Replaces the container's data: the container is split into consecutive parts (followed by
+ * whatever remains), each of which is either kept or replaced.
+ * 
+ * @param parts 
+ */
+void
+GraphData::rebuild(const std::vector<Part>& parts)
+{
+    auto it = this->constBegin();
+    std::size_t size = static_cast<std::size_t>(this->size());
+    for (const auto& part : parts) {
+        if (part.replacement != nullptr)
+            size = size - part.length + static_cast<std::size_t>(part.replacement->size());
+    }
+
+    QVector<QCPGraphData> data(static_cast<qsizetype>(size));
+    auto out = data.begin();
+    for (const auto& part : parts) {
+        auto end = it + static_cast<qsizetype>(part.length);
+        if (part.replacement != nullptr)
+            out = std::copy(part.replacement->constBegin(), part.replacement->constEnd(), out);
+        else
+            out = std::copy(it, end, out);
+        it = end;
+    }
+    std::copy(it, this->constEnd(), out);
+
+    this->mData.swap(data);
+    this->mPreallocSize = 0;
+    this->m_blocksValid = false;
+}
+
+
+/**
+ * @brief Summary of a segment: its first and last points, and the points with the minimum and
+ * maximum value of every `SPILL_BUCKET_SIZE` points (in key order). Buckets with NaN values keep
+ * their first NaN point, so breaks in the line survive.
+ * 
+ * @param begin 
+ * @param count 
+ * @return QVector<QCPGraphData> 
+ */
+QVector<QCPGraphData>
+GraphData::summarize(QCPGraphDataContainer::const_iterator begin, std::size_t count)
+{
+    std::vector<std::size_t> indices{0, count - 1};
+    for (std::size_t bucket = 0; bucket < count; bucket += SPILL_BUCKET_SIZE) {
+        auto end = std::min(bucket + SPILL_BUCKET_SIZE, count);
+        std::size_t min = end, max = end, gap = end;
+        for (auto i = bucket; i < end; ++i) {
+            auto value = (begin + static_cast<qsizetype>(i))->value;
+            if (value != value) {
+                gap = std::min(gap, i);
+                continue;
+            }
+            if (min == end || value < (begin + static_cast<qsizetype>(min))->value)
+                min = i;
+            if (max == end || value > (begin + static_cast<qsizetype>(max))->value)
+                max = i;
+        }
+        for (auto i : {min, max, gap})
+            if (i != end)
+                indices.push_back(i);
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    QVector<QCPGraphData> summary;
+    summary.reserve(static_cast<qsizetype>(indices.size()));
+    for (auto i : indices)
+        summary.append(*(begin + static_cast<qsizetype>(i)));
+    return summary;
+}
+
+
+/**
+ * @brief Whether a segment (its key range and summary size) is shown in more detail than its summary
+ * has, i.e. it overlaps the view and its summary has less than two points per pixel of it.
+ * 
+ * @param lower 
+ * @param upper 
+ * @param summary 
+ * @param keys visible key range
+ * @param pixels width of the view
+ * @return true 
+ * @return false 
+ */
+bool
+GraphData::needsDetail(double lower, double upper, std::size_t summary, const QCPRange& keys, double pixels)
+{
+    if (upper < keys.lower || lower > keys.upper || keys.size() <= 0)
+        return false;
+    return static_cast<double>(summary) < 2 * pixels * (upper - lower) / keys.size();
+}
+
+
+void
+GraphData::extendBounds(double key, double value)
+{
+    // a point only counts towards the bounds if both of its coordinates are numbers (as in QCP)
+    if (key != key || value != value)
+        return;
+    this->m_keyBounds.lower = std::min(this->m_keyBounds.lower, key);
+    this->m_keyBounds.upper = std::max(this->m_keyBounds.upper, key);
+    this->m_valueBounds.lower = std::min(this->m_valueBounds.lower, value);
+    this->m_valueBounds.upper = std::max(this->m_valueBounds.upper, value);
+}
+
+
+/**
+ * @brief Extends the bounds of the block of the point at `index` (the points must be visited in
+ * index order).
+ * 
+ * @param index 
+ * @param value 
+ */
+void
+GraphData::extendBlocks(std::size_t index, double value)
+{
+    if (!this->m_blocksValid)
+        return;
+    if (index % BLOCK_SIZE == 0) {
+        constexpr auto inf = std::numeric_limits<double>::infinity();
+        this->m_blocks.push_back({inf, -inf, false});
+    }
+    auto& block = this->m_blocks.back();
+    if (value != value) {
+        block.gap = true;
+        return;
+    }
+    block.lower = std::min(block.lower, value);
+    block.upper = std::max(block.upper, value);
+}
+
+
+void
+GraphData::resetBounds()
+{
+    // (empty ranges can't be constructed as such, QCPRange's constructor normalizes them)
+    constexpr auto inf = std::numeric_limits<double>::infinity();
+    this->m_keyBounds.lower = inf;
+    this->m_keyBounds.upper = -inf;
+    this->m_valueBounds.lower = inf;
+    this->m_valueBounds.upper = -inf;
+}
+
+
+/**
+ * @brief Grows the storage geometrically ahead of an append, so that appending point by point is
+ * amortised O(1) with a bounded number of reallocations.
+ * 
+ * @param length 
+ */
+void
+GraphData::reserveAppend(std::size_t length)
+{
+    auto required = this->mData.size() + static_cast<qsizetype>(length);
+    if (required > this->mData.capacity())
+        this->mData.reserve(std::max<qsizetype>(required, 2 * this->mData.capacity()));
+}
+
+
+Graph::Graph(QCPAxis* keyAxis, QCPAxis* valueAxis, QSharedPointer<GraphData> data)
+    : QCPGraph{keyAxis, valueAxis}
+    , m_data{data}
+    , m_symbol{QCPScatterStyle::ssNone, 0, QPen{}, QBrush{}, 0, false, 0, QPixmap{}}
+{
+    this->setData(data);
+}
+
+
+/**
+ * @brief Line data of the visible key range, with the blocks outside of the visible value range
+ * reduced to their first and last points (the segments between points on one side of the viewport
+ * never cross it, while the segments to the neighbouring points are kept). The rest goes through
+ * QCP's optimization (adaptive sampling). Impulses are drawn from the baseline, so they're left as is.
+ * 
+ * @param lineData 
+ * @param begin 
+ * @param end 
+ */
+void
+Graph::getOptimizedLineData(
+    QVector<QCPGraphData>* lineData,
+    const QCPGraphDataContainer::const_iterator& begin,
+    const QCPGraphDataContainer::const_iterator& end) const
+{
+    if (!lineData || begin == end || this->mLineStyle == lsImpulse) {
+        QCPGraph::getOptimizedLineData(lineData, begin, end);
+        return;
+    }
+
+    const auto& blocks = this->m_data->blocks();
+    auto visible = this->visibleValues();
+    auto first = this->m_data->constBegin();
+    auto beginIndex = static_cast<std::size_t>(begin - first);
+    auto endIndex = static_cast<std::size_t>(end - first);
+
+    auto runBegin = begin;
+    QVector<QCPGraphData> run;
+    auto addRun = [&](QCPGraphDataContainer::const_iterator runEnd) {
+        if (runBegin == runEnd)
+            return;
+        // (QCP's optimization overwrites its output)
+        QCPGraph::getOptimizedLineData(&run, runBegin, runEnd);
+        lineData->append(run);
+        run.clear();
+    };
+    for (auto block = beginIndex / GraphData::BLOCK_SIZE; block * GraphData::BLOCK_SIZE < endIndex; ++block) {
+        const auto& bounds = blocks[block];
+        if (bounds.gap || (bounds.upper >= visible.lower && bounds.lower <= visible.upper))
+            continue;
+        auto blockBegin = first + static_cast<qsizetype>(std::max(block * GraphData::BLOCK_SIZE, beginIndex));
+        auto blockEnd = first + static_cast<qsizetype>(std::min((block + 1) * GraphData::BLOCK_SIZE, endIndex));
+        addRun(blockBegin);
+        lineData->append(*blockBegin);
+        if (blockEnd - blockBegin > 1)
+            lineData->append(*(blockEnd - 1));
+        runBegin = blockEnd;
+    }
+    if (runBegin == begin)
+        QCPGraph::getOptimizedLineData(lineData, begin, end);
+    else
+        addRun(end);
+}
+
+
+/**
+ * @brief Scatter data of the visible key range, without the blocks outside of the visible value
+ * range. The rest goes through QCP's optimization.
+ * 
+ * @param scatterData 
+ * @param begin 
+ * @param end 
+ */
+void
+Graph::getOptimizedScatterData(
+    QVector<QCPGraphData>* scatterData,
+    QCPGraphDataContainer::const_iterator begin,
+    QCPGraphDataContainer::const_iterator end) const
+{
+    if (!scatterData || begin == end) {
+        QCPGraph::getOptimizedScatterData(scatterData, begin, end);
+        return;
+    }
+
+    const auto& blocks = this->m_data->blocks();
+    auto visible = this->visibleValues();
+    auto first = this->m_data->constBegin();
+    auto beginIndex = static_cast<std::size_t>(begin - first);
+    auto endIndex = static_cast<std::size_t>(end - first);
+
+    auto runBegin = begin;
+    for (auto block = beginIndex / GraphData::BLOCK_SIZE; block * GraphData::BLOCK_SIZE < endIndex; ++block) {
+        const auto& bounds = blocks[block];
+        auto blockBegin = first + static_cast<qsizetype>(std::max(block * GraphData::BLOCK_SIZE, beginIndex));
+        auto blockEnd = first + static_cast<qsizetype>(std::min((block + 1) * GraphData::BLOCK_SIZE, endIndex));
+        if (bounds.upper >= visible.lower && bounds.lower <= visible.upper)
+            continue;
+        if (runBegin != blockBegin)
+            QCPGraph::getOptimizedScatterData(scatterData, runBegin, blockBegin);
+        runBegin = blockEnd;
+    }
+    if (runBegin != end)
+        QCPGraph::getOptimizedScatterData(scatterData, runBegin, end);
+}
+
+
+/**
+ * @brief Draws the scatters by blitting the style's symbol, rendered once (see `Graph::symbol`).
+ * Scatters landing on the pixel of a scatter already drawn are skipped, which for dense data is
+ * most of them. Vectorized output (e.g. PDF export) and pixmap/custom shapes are drawn as usual.
+ * 
+ * @param painter 
+ * @param scatters 
+ * @param style 
+ */
+void
+Graph::drawScatterPlot(QCPPainter* painter, const QVector<QPointF>& scatters, const QCPScatterStyle& style) const
+{
+    if (painter->modes().testFlag(QCPPainter::pmVectorized)
+        || style.shape() == QCPScatterStyle::ssPixmap
+        || style.shape() == QCPScatterStyle::ssCustom) {
+        QCPGraph::drawScatterPlot(painter, scatters, style);
+        return;
+    }
+
+    this->applyScattersAntialiasingHint(painter);
+    const auto& symbol = this->symbol(painter, style);
+    auto offset = symbol.extent / 2;
+
+    // one bit per pixel of the axis rect (scatters outside of it are rare, and just drawn)
+    auto rect = this->mKeyAxis->axisRect()->rect();
+    auto width = static_cast<std::size_t>(std::max(rect.width(), 0));
+    auto height = static_cast<std::size_t>(std::max(rect.height(), 0));
+    std::vector<bool> drawn(width * height, false);
+    for (const auto& scatter : scatters) {
+        auto x = static_cast<long long>(std::floor(scatter.x())) - rect.left();
+        auto y = static_cast<long long>(std::floor(scatter.y())) - rect.top();
+        if (x >= 0 && y >= 0 && static_cast<std::size_t>(x) < width && static_cast<std::size_t>(y) < height) {
+            auto pixel = static_cast<std::size_t>(y) * width + static_cast<std::size_t>(x);
+            if (drawn[pixel])
+                continue;
+            drawn[pixel] = true;
+        }
+        painter->drawPixmap(QPointF{scatter.x() - offset, scatter.y() - offset}, symbol.pixmap);
+    }
+}
+
+
+/**
+ * @brief The symbol of a scatter style, rendered at the painter's device pixel ratio with the
+ * current antialiasing. The last symbol is cached until any of these change.
+ * 
+ * @param painter 
+ * @param style 
+ * @return const Graph::Symbol& 
+ */
+const Graph::Symbol&
+Graph::symbol(QCPPainter* painter, const QCPScatterStyle& style) const
+{
+    auto pen = style.isPenDefined() ? style.pen() : this->mPen;
+    auto ratio = painter->device()->devicePixelRatioF();
+    auto antialiased = painter->antialiasing();
+    auto& symbol = this->m_symbol;
+    if (!symbol.pixmap.isNull()
+        && symbol.shape == style.shape()
+        && symbol.size == style.size()
+        && symbol.pen == pen
+        && symbol.brush == style.brush()
+        && symbol.ratio == ratio
+        && symbol.antialiased == antialiased)
+        return symbol;
+
+    // room for the shape, its outline and a pixel of antialiasing on either side
+    auto extent = std::ceil(style.size() + std::max(pen.widthF(), 1.0)) + 2;
+    QPixmap pixmap{static_cast<int>(std::ceil(extent * ratio)), static_cast<int>(std::ceil(extent * ratio))};
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+    QCPPainter symbolPainter{&pixmap};
+    // (not `QCPPainter::setAntialiasing`, whose half-pixel shift is already applied by the plot's painter)
+    symbolPainter.setRenderHint(QPainter::Antialiasing, antialiased);
+    style.applyTo(&symbolPainter, this->mPen);
+    style.drawShape(&symbolPainter, extent / 2, extent / 2);
+    symbolPainter.end();
+
+    symbol = {style.shape(), style.size(), pen, style.brush(), ratio, antialiased, extent, pixmap};
+    return symbol;
+}
+
+
+/**
+ * @brief The visible value range, padded by the size of a scatter (or the pen width) so that points
+ * just outside of it which are still partly drawn aren't culled.
+ * 
+ * @return QCPRange 
+ */
+QCPRange
+Graph::visibleValues() const
+{
+    auto axis = this->mValueAxis.data();
+    auto rect = axis->axisRect()->rect();
+    auto pad = std::max(this->mScatterStyle.size(), this->mPen.widthF()) + 1;
+    double a, b;
+    if (axis->orientation() == Qt::Vertical) {
+        a = axis->pixelToCoord(rect.top() - pad);
+        b = axis->pixelToCoord(rect.bottom() + pad);
+    } else {
+        a = axis->pixelToCoord(rect.left() - pad);
+        b = axis->pixelToCoord(rect.right() + pad);
+    }
+    // (normalized by the constructor, the value axis may be reversed)
+    return QCPRange{a, b};
+}
 
 
 Plot2D::Plot2D(
@@ -21,16 +725,22 @@ Plot2D::Plot2D(
     bool rescaleAxes
 )
     : Plot{title, labelX, labelY}
-    , m_graph{m_plot->addGraph()}
+    , m_traces{}
     , m_rescaleAxes{rescaleAxes}
+    , m_antialiasMaxPoints{ANTIALIAS_MAX_POINTS}
+    , m_storage{GraphData::FULL}
 {
-    if (this->m_graph == nullptr)
-        throw std::runtime_error{"Failed to add graph"};
+    this->m_traces.push_back(this->addTrace());
     this->m_plot->xAxis->setRange(rangeX);
     this->m_plot->yAxis->setRange(rangeY);
-    this->m_graph->setLineStyle(lineStyle);
-    this->m_graph->setScatterStyle(scatStyle);
-    this->m_graph->setPen(pen);
+    this->m_traces.front().graph->setLineStyle(lineStyle);
+    this->m_traces.front().graph->setScatterStyle(scatStyle);
+    this->m_traces.front().graph->setPen(pen);
+
+    QObject::connect(
+        this->m_plot->xAxis, qOverload<const QCPRange&>(&QCPAxis::rangeChanged),
+        this, &Plot2D::restore
+    );
 }
 
 
@@ -44,16 +754,58 @@ Plot2D::type() const
 void
 Plot2D::clear()
 {
-    this->m_graph->data()->clear();
+    for (auto& trace : this->m_traces)
+        trace.data->clear();
 }
 
 
 void
 Plot2D::replot()
 {
-    this->m_plot->replot(QCustomPlot::rpQueuedReplot);
+    this->compact();
     if (this->m_rescaleAxes)
-        this->m_plot->rescaleAxes();
+        this->rescaleAxes();
+    this->updateAntialiasing();
+    this->m_plot->replot(QCustomPlot::rpQueuedReplot);
+}
+
+
+std::size_t
+Plot2D::memoryUsage() const
+{
+    std::size_t bytes = 0;
+    for (const auto& trace : this->m_traces)
+        bytes += trace.data->memoryUsage();
+    return bytes;
+}
+
+
+/**
+ * @brief Spills the oldest data of the traces (largest first) to disk (or compacts it, see
+ * `Plot2D::setStorage`), leaving what the current view shows in detail (see `GraphData::spill`).
+ * 
+ * @param bytes memory to free
+ * @return std::size_t memory freed in bytes
+ */
+std::size_t
+Plot2D::spill(std::size_t bytes)
+{
+    auto points = (bytes + sizeof(QCPGraphData) - 1) / sizeof(QCPGraphData);
+    auto keys = this->m_plot->xAxis->range();
+    auto pixels = static_cast<double>(this->m_plot->axisRect()->width());
+
+    std::vector<GraphData*> traces;
+    for (const auto& trace : this->m_traces)
+        traces.push_back(trace.data.data());
+    std::sort(traces.begin(), traces.end(), [](const GraphData* a, const GraphData* b) { return a->size() > b->size(); });
+
+    std::size_t freed = 0;
+    for (auto data : traces) {
+        if (freed >= points)
+            break;
+        freed += data->spill(points - freed, keys, pixels);
+    }
+    return freed * sizeof(QCPGraphData);
 }
 
 
@@ -88,56 +840,121 @@ Plot2D::rangeY() const
 void
 Plot2D::setLineStyle(QCPGraph::LineStyle style)
 {
-    this->m_graph->setLineStyle(style);
+    for (auto& trace : this->m_traces)
+        trace.graph->setLineStyle(style);
 }
 
 
 QCPGraph::LineStyle
 Plot2D::lineStyle() const
 {
-    return this->m_graph->lineStyle();
+    return this->m_traces.front().graph->lineStyle();
 }
 
 
 void
 Plot2D::setScatStyle(const QCPScatterStyle& style)
 {
-    this->m_graph->setScatterStyle(style);
+    for (auto& trace : this->m_traces)
+        trace.graph->setScatterStyle(style);
 }
 
 
 QCPScatterStyle
 Plot2D::scatStyle() const
 {
-    return this->m_graph->scatterStyle();
+    return this->m_traces.front().graph->scatterStyle();
 }
 
 
 void
 Plot2D::setPen(const QPen& pen)
 {
-    this->m_graph->setPen(pen);
+    this->m_traces.front().graph->setPen(pen);
+    for (std::size_t i = 1; i < this->m_traces.size(); ++i)
+        this->m_traces[i].graph->setPen(this->tracePen(i));
 }
 
 
 QPen
 Plot2D::pen() const
 {
-    return this->m_graph->pen();
+    return this->m_traces.front().graph->pen();
 }
 
 
 void
 Plot2D::addData(double x, double y)
 {
-    this->m_graph->addData(x, y);
+    this->m_traces.front().data->append(x, y);
 }
 
 
+/**
+ * @brief Appends a block of data to the primary trace.
+ * 
+ * @param x 
+ * @param y 
+ * @param sorted the x-values are known to be non-decreasing (skips checking them)
+ */
 void
-Plot2D::addData(const QVector<double>& x, const QVector<double>& y)
+Plot2D::addData(const QVector<double>& x, const QVector<double>& y, bool sorted)
 {
-    this->m_graph->addData(x, y);
+    this->addData(0, x, y, sorted);
+}
+
+
+void
+Plot2D::addData(const std::vector<double>& x, const std::vector<double>& y, bool sorted)
+{
+    auto length = std::min(x.size(), y.size());
+    this->m_traces.front().data->append(x.data(), y.data(), length, sorted);
+}
+
+
+void
+Plot2D::addData(std::size_t trace, const QVector<double>& x, const QVector<double>& y, bool sorted)
+{
+    auto length = static_cast<std::size_t>(std::min(x.size(), y.size()));
+    this->trace(trace).data->append(x.constData(), y.constData(), length, sorted);
+}
+
+
+/**
+ * @brief Appends a block of data to multiple traces sharing the same x-values. Traces are added
+ * as needed (the styles of additional traces follow the primary trace's, with their own colors).
+ * The x-values are only checked for order once for all of the traces.
+ * 
+ * @param x 
+ * @param y one set of y-values per trace
+ * @param sorted the x-values are known to be non-decreasing (skips checking them)
+ */
+void
+Plot2D::addData(const std::vector<double>& x, const std::vector<std::vector<double>>& y, bool sorted)
+{
+    sorted = sorted || std::is_sorted(x.cbegin(), x.cend());
+    for (std::size_t i = 0; i < y.size(); ++i) {
+        auto length = std::min(x.size(), y[i].size());
+        this->trace(i).data->append(x.data(), y[i].data(), length, sorted);
+    }
+}
+
+
+/**
+ * @brief Appends a block of uniformly sampled data to the primary trace (the x-value of `y[i]` is
+ * `x0 + i * dx`).
+ * 
+ * @param x0 
+ * @param dx greater than zero (i.e. the keys are sorted)
+ * @param y 
+ */
+void
+Plot2D::addData(double x0, double dx, const std::vector<double>& y)
+{
+    std::vector<double> x(y.size());
+    for (std::size_t i = 0; i < x.size(); ++i)
+        x[i] = x0 + static_cast<double>(i) * dx;
+    this->m_traces.front().data->append(x.data(), y.data(), y.size(), dx > 0.0);
 }
 
 
@@ -146,3 +963,182 @@ Plot2D::setRescaleAxes(bool rescaleAxes)
 {
     this->m_rescaleAxes = rescaleAxes;
 }
+
+
+/**
+ * @brief Set the number of points (over all traces) above which the traces are drawn without
+ * antialiasing, which is most of the cost of drawing a dense plot.
+ * 
+ * @param points 0 for no limit
+ */
+void
+Plot2D::setAntialiasMaxPoints(std::size_t points)
+{
+    this->m_antialiasMaxPoints = points;
+}
+
+
+std::size_t
+Plot2D::antialiasMaxPoints() const
+{
+    return this->m_antialiasMaxPoints;
+}
+
+
+/**
+ * @brief Set how the traces store their data. With compact storage, the data out of the (detailed)
+ * view is kept in a compact columnar form: evenly spaced keys are implicit and, with
+ * `GraphData::COMPACT_FLOAT`, values are single precision, halving to quartering the memory per point.
+ * 
+ * @param storage 
+ */
+void
+Plot2D::setStorage(GraphData::Storage storage)
+{
+    this->m_storage = storage;
+    for (auto& trace : this->m_traces)
+        trace.data->setStorage(storage);
+}
+
+
+GraphData::Storage
+Plot2D::storage() const
+{
+    return this->m_storage;
+}
+
+
+/**
+ * @brief Fits the axes to the data of all traces using the bounds maintained by the traces' data
+ * containers (rather than `QCustomPlot::rescaleAxes`, which scans every point).
+ * 
+ */
+void
+Plot2D::rescaleAxes()
+{
+    QCPRange keys, values;
+    bool found = false;
+    for (auto& trace : this->m_traces) {
+        QCPRange traceKeys, traceValues;
+        if (!trace.data->bounds(traceKeys, traceValues))
+            continue;
+        if (found) {
+            keys.expand(traceKeys);
+            values.expand(traceValues);
+        } else {
+            keys = traceKeys;
+            values = traceValues;
+            found = true;
+        }
+    }
+    if (!found)
+        return;
+
+    // as with `QCPAxis::rescale`, a zero-size range keeps the current size, centered on the data
+    auto fit = [](QCPAxis* axis, QCPRange range) {
+        if (range.size() == 0) {
+            auto center = range.lower;
+            auto size = axis->range().size();
+            range = QCPRange{center - size / 2, center + size / 2};
+        }
+        axis->setRange(range);
+    };
+    fit(this->m_plot->xAxis, keys);
+    fit(this->m_plot->yAxis, values);
+}
+
+
+/**
+ * @brief Compacts the segments of the traces' data that are out of the current view (a no-op with
+ * full storage, where data is only spilled to stay within the memory budget).
+ * 
+ */
+void
+Plot2D::compact()
+{
+    if (this->m_storage == GraphData::FULL)
+        return;
+    auto keys = this->m_plot->xAxis->range();
+    auto pixels = static_cast<double>(this->m_plot->axisRect()->width());
+    for (auto& trace : this->m_traces)
+        trace.data->spill(std::numeric_limits<std::size_t>::max(), keys, pixels);
+}
+
+
+/**
+ * @brief Reads back the spilled data that a new view of the plot shows in detail.
+ * 
+ * @param keys 
+ */
+void
+Plot2D::restore(const QCPRange& keys)
+{
+    auto pixels = static_cast<double>(this->m_plot->axisRect()->width());
+    for (auto& trace : this->m_traces)
+        trace.data->restore(keys, pixels);
+}
+
+
+void
+Plot2D::updateAntialiasing()
+{
+    std::size_t points = 0;
+    for (const auto& trace : this->m_traces)
+        points += static_cast<std::size_t>(trace.data->size());
+
+    const QCP::AntialiasedElements traces = QCP::aePlottables | QCP::aeScatters;
+    if (this->m_antialiasMaxPoints > 0 && points > this->m_antialiasMaxPoints) {
+        this->m_plot->setNotAntialiasedElements(traces);
+    } else {
+        this->m_plot->setNotAntialiasedElements(QCP::aeNone);
+        // the OpenGL renderer antialiases everything (see `QCustomPlot::setOpenGl`)
+        if (this->m_plot->openGl())
+            this->m_plot->setAntialiasedElements(QCP::aeAll);
+    }
+}
+
+
+Plot2D::Trace&
+Plot2D::trace(std::size_t index)
+{
+    while (this->m_traces.size() <= index) {
+        auto trace = this->addTrace();
+        trace.graph->setLineStyle(this->m_traces.front().graph->lineStyle());
+        trace.graph->setScatterStyle(this->m_traces.front().graph->scatterStyle());
+        this->m_traces.push_back(trace);
+        trace.graph->setPen(this->tracePen(this->m_traces.size() - 1));
+    }
+    return this->m_traces[index];
+}
+
+
+/**
+ * @brief Adds a graph to the plot, backed by a `GraphData` container.
+ * 
+ * @return Plot2D::Trace 
+ */
+Plot2D::Trace
+Plot2D::addTrace()
+{
+    // (registers itself with the plot, as `QCustomPlot::addGraph` would)
+    QSharedPointer<GraphData> data{new GraphData};
+    data->setStorage(this->m_storage);
+    auto graph = new Graph{this->m_plot->xAxis, this->m_plot->yAxis, data};
+    return {graph, data};
+}
+
+
+/**
+ * @brief Pen of an additional trace: the primary trace's pen with a color spread around the hue
+ * circle (by the golden angle, so neighbouring traces stay distinguishable for any trace count).
+ * 
+ * @param index 
+ * @return QPen 
+ */
+QPen
+Plot2D::tracePen(std::size_t index) const
+{
+    auto pen = this->m_traces.front().graph->pen();
+    pen.setColor(QColor::fromHsv(static_cast<int>((index * 137) % 360), 200, 200));
+    return pen;
+}
@@ -10,12 +10,163 @@
 
 #include <QVector>
 
+#include <memory>
+#include <vector>
+
 #include "plot.hpp"
+#include "segmentstore.hpp"
+
+
+/**
+ * @brief Graph data container with an append path for data arriving in key order (which is the
+ * case for nearly all streamed data, e.g. data plotted against time). Sorted data is appended in
+ * amortised O(1) per point straight into the container's storage; anything else falls back to the
+ * container's sorting insert.
+ * 
+ * The container also keeps the bounds of its data up to date as points are appended, so the axes
+ * can be rescaled without scanning the data. Removing data invalidates the bounds, which are then
+ * recomputed (once) on the next query. Likewise for the value bounds of each block of `BLOCK_SIZE`
+ * points, which index the data for culling (see `Graph`).
+ * 
+ * To bound the memory held by a plot, the oldest data can be spilled to a temporary file in segments
+ * of `SPILL_SEGMENT_SIZE` points. A spilled segment is replaced in the container by a summary (the
+ * minimum and maximum of every `SPILL_BUCKET_SIZE` points), which stays in memory and is what gets
+ * drawn while the segment is zoomed out of; the segment itself is read back when the view needs more
+ * detail than its summary has.
+ * 
+ * With compact storage, segments are kept in memory in a columnar form instead (see `ColumnStore`):
+ * rather than waiting for the memory budget, every segment the view doesn't need in detail is
+ * compacted as soon as it's complete. The points QCP draws are still its `{key, value}` pairs; only
+ * the data out of (detailed) view is compacted.
+ * 
+ */
+class GraphData : public QCPGraphDataContainer
+{
+public:
+    constexpr static std::size_t BLOCK_SIZE = 1024;
+    constexpr static std::size_t SPILL_SEGMENT_SIZE = 1 << 16;
+    constexpr static std::size_t SPILL_BUCKET_SIZE = 256;
+
+    enum Storage
+    {
+        FULL,               // spilled segments go to disk
+        COMPACT,            // segments are compacted in memory (with implicit keys)
+        COMPACT_FLOAT,      // as above, with values in single precision
+    };
+
+    typedef struct
+    {
+        double lower;
+        double upper;
+        bool gap;       // the block has NaN values (i.e. breaks in the line)
+    } Block;
+
+    GraphData();
+    void setStorage(Storage);
+    Storage storage() const;
+    void append(double key, double value);
+    void append(const double* keys, const double* values, std::size_t length, bool sorted = false);
+    void clear();
+    void removeBefore(double sortKey);
+    bool bounds(QCPRange& keys, QCPRange& values);
+    const std::vector<Block>& blocks();
+    std::size_t spill(std::size_t points, const QCPRange& keys, double pixels);
+    std::size_t restore(const QCPRange& keys, double pixels);
+    std::size_t memoryUsage() const;
+
+private:
+    typedef struct
+    {
+        double lower;
+        double upper;
+        std::size_t offset;                 // in the segment store (in points)
+        std::size_t count;
+        QVector<QCPGraphData> summary;
+        bool resident;                      // the segment's points are in the container (rather than its summary)
+    } Segment;
+
+    typedef struct
+    {
+        std::size_t length;                             // of the part of the container
+        const QVector<QCPGraphData>* replacement;       // nullptr to keep the part as is
+    } Part;
+
+    void unspill();
+    void rebuild(const std::vector<Part>& parts);
+    static QVector<QCPGraphData> summarize(QCPGraphDataContainer::const_iterator begin, std::size_t count);
+    static bool needsDetail(double lower, double upper, std::size_t summary, const QCPRange& keys, double pixels);
+    void reserveAppend(std::size_t length);
+    void extendBounds(double key, double value);
+    void extendBlocks(std::size_t index, double value);
+    void resetBounds();
+
+    QCPRange m_keyBounds;
+    QCPRange m_valueBounds;
+    bool m_boundsValid;
+    std::vector<Block> m_blocks;
+    bool m_blocksValid;
+    std::vector<Segment> m_segments;
+    std::unique_ptr<SegmentStore> m_store;
+    Storage m_storage;
+};
+
+
+/**
+ * @brief Graph that culls its data to the visible value range before drawing it. QCP already limits
+ * drawing to the visible key range (by binary search over the sorted keys, keeping one neighbour on
+ * either side); on top of that, blocks of points lying entirely above or below the visible value
+ * range are found from the block bounds of the `GraphData` and skipped, so a zoomed-in replot only
+ * goes through the points around the viewport.
+ * 
+ * Scatters are drawn by blitting a pre-rendered symbol (rather than by drawing the shape for every
+ * point), skipping points that land on an already drawn pixel.
+ * 
+ */
+class Graph : public QCPGraph
+{
+public:
+    Graph(QCPAxis* keyAxis, QCPAxis* valueAxis, QSharedPointer<GraphData> data);
+
+protected:
+    void getOptimizedLineData(
+        QVector<QCPGraphData>* lineData,
+        const QCPGraphDataContainer::const_iterator& begin,
+        const QCPGraphDataContainer::const_iterator& end
+    ) const override;
+    void getOptimizedScatterData(
+        QVector<QCPGraphData>* scatterData,
+        QCPGraphDataContainer::const_iterator begin,
+        QCPGraphDataContainer::const_iterator end
+    ) const override;
+    void drawScatterPlot(QCPPainter* painter, const QVector<QPointF>& scatters, const QCPScatterStyle& style) const override;
+
+private:
+    typedef struct
+    {
+        QCPScatterStyle::ScatterShape shape;
+        double size;
+        QPen pen;
+        QBrush brush;
+        qreal ratio;
+        bool antialiased;
+        double extent;
+        QPixmap pixmap;
+    } Symbol;
+
+    QCPRange visibleValues() const;
+    const Symbol& symbol(QCPPainter* painter, const QCPScatterStyle& style) const;
+
+    QSharedPointer<GraphData> m_data;
+    mutable Symbol m_symbol;
+};
 
 
 class Plot2D : public Plot
 {
 public:
+    // point count above which lines and scatters are drawn without antialiasing
+    constexpr static std::size_t ANTIALIAS_MAX_POINTS = 100000;
+
     Plot2D(
         const QString& title = QString{},
         const QString& labelX = QString{},
@@ -30,6 +181,8 @@ public:
     Type type() const override;
     void clear() override;
     void replot() override;
+    std::size_t memoryUsage() const override;
+    std::size_t spill(std::size_t bytes);
     void setRangeX(const QCPRange&);
     const QCPRange rangeX() const;
     void setRangeY(const QCPRange&);
@@ -41,10 +194,35 @@ public:
     void setPen(const QPen&);
     QPen pen() const;
     void addData(double x, double y);
-    void addData(const QVector<double>& x, const QVector<double>& y);
+    void addData(const QVector<double>& x, const QVector<double>& y, bool sorted = false);
+    void addData(const std::vector<double>& x, const std::vector<double>& y, bool sorted = false);
+    void addData(std::size_t trace, const QVector<double>& x, const QVector<double>& y, bool sorted = false);
+    void addData(const std::vector<double>& x, const std::vector<std::vector<double>>& y, bool sorted = false);
+    void addData(double x0, double dx, const std::vector<double>& y);
     void setRescaleAxes(bool);
+    void setAntialiasMaxPoints(std::size_t);
+    std::size_t antialiasMaxPoints() const;
+    void setStorage(GraphData::Storage);
+    GraphData::Storage storage() const;
 
 private:
-    QCPGraph* m_graph;
+    typedef struct
+    {
+        QCPGraph* graph;
+        QSharedPointer<GraphData> data;
+    } Trace;
+
+    void rescaleAxes();
+    void updateAntialiasing();
+    void compact();
+    void restore(const QCPRange& keys);
+    Trace& trace(std::size_t);
+    Trace addTrace();
+    QPen tracePen(std::size_t) const;
+
+    // the first trace is the plot's primary trace; the rest are added by multi-trace data
+    std::vector<Trace> m_traces;
     bool m_rescaleAxes;
+    std::size_t m_antialiasMaxPoints;
+    GraphData::Storage m_storage;
 };
@@ -8,6 +8,232 @@
 
 #include "plotcolormap.hpp"
 
+#include <algorithm>
+
+
+WaterfallMap::WaterfallMap(QCPAxis* keyAxis, QCPAxis* valueAxis)
+    : QCPColorMap{keyAxis, valueAxis}
+    , m_waterfall{false}
+    , m_head{0}
+    , m_dirty{true}
+    , m_dirtyRows{}
+    , m_row{}
+    , m_image{}
+{
+}
+
+
+/**
+ * @brief Enable/disable waterfall mode. The map's current rows become the initial contents of the
+ * ring; when disabled, the rows are put back in display order.
+ * 
+ * @param enable 
+ */
+void
+WaterfallMap::setWaterfall(bool enable)
+{
+    if (enable == this->m_waterfall)
+        return;
+    if (!enable) {
+        this->unrotate();
+        this->mMapImageInvalidated = true;
+    }
+    this->m_waterfall = enable;
+    this->rewind();
+}
+
+
+bool
+WaterfallMap::waterfall() const
+{
+    return this->m_waterfall;
+}
+
+
+/**
+ * @brief Replace the oldest row with a new one. Missing values are filled with the lower end of the
+ * data range (as the map is cleared); extra values are dropped.
+ * 
+ * @param values 
+ * @param count 
+ */
+void
+WaterfallMap::pushRow(const double* values, std::size_t count)
+{
+    auto rows = this->mMapData->valueSize();
+    auto cols = this->mMapData->keySize();
+    if (rows == 0)
+        return;
+    auto row = this->m_head;
+    for (int x = 0; x < cols; ++x)
+        this->mMapData->setCell(x, row, static_cast<std::size_t>(x) < count ? values[x] : this->mDataRange.lower);
+    this->m_head = (this->m_head + 1) % rows;
+    this->invalidateRow(row);
+}
+
+
+/**
+ * @brief Data (storage) row of a displayed row.
+ * 
+ * @param row displayed row (from the bottom)
+ * @return int 
+ */
+int
+WaterfallMap::storageRow(int row) const
+{
+    auto rows = this->mMapData->valueSize();
+    if (!this->m_waterfall || rows == 0)
+        return row;
+    return (this->m_head + row) % rows;
+}
+
+
+/**
+ * @brief Mark a (storage) row to be colorized on the next replot.
+ * 
+ * @param row 
+ */
+void
+WaterfallMap::invalidateRow(int row)
+{
+    if (this->m_dirty)
+        return;
+    if (this->m_dirtyRows.size() >= static_cast<std::size_t>(this->mMapData->valueSize())) {
+        // cheaper to redo the whole image at this point
+        this->m_dirty = true;
+        this->m_dirtyRows.clear();
+        return;
+    }
+    this->m_dirtyRows.push_back(row);
+}
+
+
+/**
+ * @brief Restart the ring at the first row (e.g. after the map is cleared or resized).
+ * 
+ */
+void
+WaterfallMap::rewind()
+{
+    this->m_head = 0;
+    this->m_dirty = true;
+    this->m_dirtyRows.clear();
+}
+
+
+void
+WaterfallMap::draw(QCPPainter* painter)
+{
+    // the plots' maps always have horizontal key axes, which is all the rotated drawing handles
+    if (!this->m_waterfall || !this->mKeyAxis || !this->mValueAxis
+        || this->keyAxis()->orientation() != Qt::Horizontal) {
+        QCPColorMap::draw(painter);
+        return;
+    }
+    if (this->mMapData->isEmpty())
+        return;
+    this->applyDefaultAntialiasingHint(painter);
+
+    auto cols = this->mMapData->keySize();
+    auto rows = this->mMapData->valueSize();
+    if (this->m_image.width() != cols || this->m_image.height() != rows) {
+        this->m_image = QImage{cols, rows, QImage::Format_ARGB32_Premultiplied};
+        this->m_dirty = true;
+    }
+    if (this->m_dirty || this->mMapImageInvalidated) {
+        for (int row = 0; row < rows; ++row)
+            this->colorizeRow(row);
+        this->m_dirty = false;
+        this->mMapImageInvalidated = false;
+    } else {
+        for (auto row : this->m_dirtyRows)
+            this->colorizeRow(row);
+    }
+    this->m_dirtyRows.clear();
+
+    // cells are centered on the map range boundary (as drawn by QCP)
+    auto keyRange = this->mMapData->keyRange();
+    auto valueRange = this->mMapData->valueRange();
+    auto keyStep = cols > 1 ? keyRange.size() / (cols - 1) : 0.0;
+    auto valueStep = rows > 1 ? valueRange.size() / (rows - 1) : 0.0;
+    auto keyLower = keyRange.lower - 0.5 * keyStep;
+    auto keyUpper = keyRange.upper + 0.5 * keyStep;
+    auto valueAt = [&](int row) { return valueRange.lower + (row - 0.5) * valueStep; };
+
+    auto mirrorX = this->keyAxis()->rangeReversed();
+    auto mirrorY = this->valueAxis()->rangeReversed();
+    const auto& image = mirrorX || mirrorY ? this->m_image.mirrored(mirrorX, mirrorY) : this->m_image;
+
+    auto smoothBackup = painter->renderHints().testFlag(QPainter::SmoothPixmapTransform);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, this->mInterpolate);
+    QRegion clipBackup;
+    if (this->mTightBoundary) {
+        clipBackup = painter->clipRegion();
+        painter->setClipRect(QRectF{
+            this->coordsToPixels(keyRange.lower, valueRange.lower),
+            this->coordsToPixels(keyRange.upper, valueRange.upper)
+        }.normalized(), Qt::IntersectClip);
+    }
+
+    // displayed row `d` is storage row `(head + d) % rows` (scanline `rows - 1 - row` of the image):
+    //   the storage rows from the head up are displayed at the bottom, the ones below it at the top
+    auto bottomRows = rows - this->m_head;
+    auto drawRows = [&](int displayed, int count, int scanline) {
+        if (count <= 0)
+            return;
+        auto lower = rows > 1 ? valueAt(displayed) : valueRange.lower;
+        auto upper = rows > 1 ? valueAt(displayed + count) : valueRange.upper;
+        QRectF target{this->coordsToPixels(keyLower, lower), this->coordsToPixels(keyUpper, upper)};
+        painter->drawImage(target.normalized(), image, QRectF{0, static_cast<qreal>(scanline), static_cast<qreal>(cols), static_cast<qreal>(count)});
+    };
+    drawRows(0, bottomRows, mirrorY ? this->m_head : 0);
+    drawRows(bottomRows, this->m_head, mirrorY ? 0 : bottomRows);
+
+    if (this->mTightBoundary)
+        painter->setClipRegion(clipBackup);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, smoothBackup);
+}
+
+
+void
+WaterfallMap::colorizeRow(int row)
+{
+    auto cols = this->mMapData->keySize();
+    auto rows = this->mMapData->valueSize();
+    if (row < 0 || row >= rows)
+        return;
+    this->m_row.resize(static_cast<std::size_t>(cols));
+    for (int x = 0; x < cols; ++x)
+        this->m_row[x] = this->mMapData->cell(x, row);
+    auto pixels = reinterpret_cast<QRgb*>(this->m_image.scanLine(rows - 1 - row));
+    this->mGradient.colorize(this->m_row.data(), this->mDataRange, pixels, cols, 1,
+                             this->mDataScaleType == QCPAxis::stLogarithmic);
+}
+
+
+/**
+ * @brief Move the rows back into display order (the oldest row first).
+ * 
+ */
+void
+WaterfallMap::unrotate()
+{
+    auto cols = this->mMapData->keySize();
+    auto rows = this->mMapData->valueSize();
+    if (this->m_head == 0 || rows == 0)
+        return;
+    std::vector<double> cells(static_cast<std::size_t>(cols) * rows);
+    for (int row = 0; row < rows; ++row) {
+        auto source = (this->m_head + row) % rows;
+        for (int x = 0; x < cols; ++x)
+            cells[static_cast<std::size_t>(row) * cols + x] = this->mMapData->cell(x, source);
+    }
+    for (int row = 0; row < rows; ++row) {
+        for (int x = 0; x < cols; ++x)
+            this->mMapData->setCell(x, row, cells[static_cast<std::size_t>(row) * cols + x]);
+    }
+}
+
 
 PlotColorMap::PlotColorMap(
     const QString& title,
@@ -24,7 +250,7 @@ PlotColorMap::PlotColorMap(
     bool rescaleData
 )
     : Plot{title, labelX, labelY}
-    , m_map{new QCPColorMap{m_plot->xAxis, m_plot->yAxis}}
+    , m_map{new WaterfallMap{m_plot->xAxis, m_plot->yAxis}}
     , m_colorScale{new QCPColorScale{m_plot}}
     , m_rescaleAxes{rescaleAxes}
     , m_rescaleData{rescaleData}
@@ -60,6 +286,7 @@ void
 PlotColorMap::clear()
 {
     this->m_map->data()->fill(this->m_colorScale->dataRange().lower);
+    this->m_map->rewind();
 }
 
 
@@ -74,6 +301,20 @@ PlotColorMap::replot()
 }
 
 
+/**
+ * @brief Memory held by the map's cells in bytes.
+ * 
+ * @return std::size_t 
+ */
+std::size_t
+PlotColorMap::memoryUsage() const
+{
+    auto data = this->m_map->data();
+    auto cells = static_cast<std::size_t>(data->keySize()) * static_cast<std::size_t>(data->valueSize());
+    return cells * sizeof(double) + (this->m_map->waterfall() ? cells * sizeof(QRgb) : 0);
+}
+
+
 void
 PlotColorMap::setRangeX(const QCPRange& range)
 {
@@ -122,6 +363,7 @@ void
 PlotColorMap::setDataSize(int x, int y)
 {
     this->m_map->data()->setSize(x, y);
+    this->m_map->rewind();
 }
 
 
@@ -156,7 +398,17 @@ PlotColorMap::colorGradient() const
 void
 PlotColorMap::setCell(int x, int y, double z)
 {
-    this->m_map->data()->setCell(x, y, z);
+    auto row = this->m_map->storageRow(y);
+    this->m_map->data()->setCell(x, row, z);
+    if (this->m_map->waterfall())
+        this->m_map->invalidateRow(row);
+}
+
+
+double
+PlotColorMap::cell(int x, int y) const
+{
+    return this->m_map->data()->cell(x, this->m_map->storageRow(y));
 }
 
 
@@ -172,3 +424,30 @@ PlotColorMap::setRescaleData(bool rescaleData)
 {
     this->m_rescaleData = rescaleData;
 }
+
+
+/**
+ * @brief Set waterfall mode: rows are pushed with `pushRow` (the newest row at the top) and
+ * `setCell` addresses the displayed rows.
+ * 
+ * @param waterfall 
+ */
+void
+PlotColorMap::setWaterfall(bool waterfall)
+{
+    this->m_map->setWaterfall(waterfall);
+}
+
+
+bool
+PlotColorMap::waterfall() const
+{
+    return this->m_map->waterfall();
+}
+
+
+void
+PlotColorMap::pushRow(const std::vector<double>& values)
+{
+    this->m_map->pushRow(values.data(), values.size());
+}
@@ -11,6 +11,43 @@
 #include "plot.hpp"
 
 #include <optional>
+#include <vector>
+
+
+/**
+ * @brief Color map that can act as a waterfall: rows pushed with `pushRow` go into a ring buffer of
+ * the map's rows (overwriting the oldest row), and the image is drawn rotated by the ring's head
+ * (in two pieces) rather than by shifting every cell. Only the rows changed since the last replot
+ * are colorized; the whole image is only redone when the data range, gradient or size changes. A
+ * new row therefore costs O(columns) however many rows are kept. The newest row is at the top.
+ * 
+ */
+class WaterfallMap : public QCPColorMap
+{
+public:
+    WaterfallMap(QCPAxis* keyAxis, QCPAxis* valueAxis);
+
+    void setWaterfall(bool);
+    bool waterfall() const;
+    void pushRow(const double* values, std::size_t count);
+    int storageRow(int row) const;
+    void invalidateRow(int row);
+    void rewind();
+
+protected:
+    void draw(QCPPainter* painter) override;
+
+private:
+    void colorizeRow(int row);
+    void unrotate();
+
+    bool m_waterfall;
+    int m_head;
+    bool m_dirty;
+    std::vector<int> m_dirtyRows;
+    std::vector<double> m_row;
+    QImage m_image;
+};
 
 
 class PlotColorMap : public Plot
@@ -33,6 +70,7 @@ public:
     Type type() const override;
     void clear() override;
     void replot() override;
+    std::size_t memoryUsage() const override;
     void setRangeX(const QCPRange&);
     QCPRange rangeX() const;
     void setRangeY(const QCPRange&);
@@ -45,11 +83,15 @@ public:
     void setColorGradient(const QCPColorGradient&);
     QCPColorGradient colorGradient() const;
     void setCell(int, int, double);
+    double cell(int, int) const;
     void setRescaleAxes(bool);
     void setRescaleData(bool);
+    void setWaterfall(bool);
+    bool waterfall() const;
+    void pushRow(const std::vector<double>&);
 
 private:
-    QCPColorMap* m_map;
+    WaterfallMap* m_map;
     QCPColorScale* m_colorScale;
     bool m_rescaleAxes;
     bool m_rescaleData;
@@ -138,6 +138,42 @@ QPlot::type() const
 }
 
 
+void
+QPlot::setRenderer(Plot::Renderer renderer)
+{
+    this->m_plot2D->setRenderer(renderer);
+    this->m_plotColorMap->setRenderer(renderer);
+    this->m_queued = true;
+}
+
+
+Plot::Renderer
+QPlot::renderer() const
+{
+    return this->plot()->renderer();
+}
+
+
+std::size_t
+QPlot::memoryUsage() const
+{
+    return this->m_plot2D->memoryUsage() + this->m_plotColorMap->memoryUsage();
+}
+
+
+/**
+ * @brief Moves old 2D plot data out of memory (color map data always stays in memory).
+ * 
+ * @param bytes 
+ * @return std::size_t memory freed in bytes
+ */
+std::size_t
+QPlot::spill(std::size_t bytes)
+{
+    return this->m_plot2D->spill(bytes);
+}
+
+
 Plot2D*
 QPlot::plot2D()
 {
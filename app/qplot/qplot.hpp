@@ -68,6 +68,10 @@ public:
     QString labelY() const;
     void setType(Plot::Type plot);
     Plot::Type type() const;
+    void setRenderer(Plot::Renderer renderer);
+    Plot::Renderer renderer() const;
+    std::size_t memoryUsage() const;
+    std::size_t spill(std::size_t bytes);
     Plot2D* plot2D();
     const Plot2D* plot2D() const;
     PlotColorMap* plotColorMap();
@@ -0,0 +1,33 @@
+/*
+ * ExaPlot
+ * plot data segment store
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include <QVector>
+
+#include "qcustomplot.h"
+
+#include <cstddef>
+
+
+/**
+ * @brief Storage for the segments of 2D plot data that have been moved out of a graph's container
+ * (see `GraphData::spill`). Segments are appended and read back by their offset (in points).
+ * 
+ */
+class SegmentStore
+{
+public:
+    virtual ~SegmentStore() = default;
+
+    virtual bool append(const QCPGraphData* data, std::size_t count, std::size_t& offset) = 0;
+    virtual bool read(std::size_t offset, std::size_t count, QVector<QCPGraphData>& data) = 0;
+    virtual void clear() = 0;
+    // memory held by the store in bytes
+    virtual std::size_t memoryUsage() const = 0;
+};
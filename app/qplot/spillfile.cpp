@@ -0,0 +1,102 @@
+/*
+ * ExaPlot
+ * plot data spill file
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include <QDir>
+
+#include "spillfile.hpp"
+
+#include <cstring>
+
+
+SpillFile::SpillFile()
+    : m_file{QDir::tempPath() + "/exaplot-XXXXXX.spill"}
+    , m_points{0}
+{
+}
+
+
+/**
+ * @brief Appends a block of points.
+ * 
+ * @param data 
+ * @param count 
+ * @param offset set to the offset (in points) of the block within the file
+ * @return true 
+ * @return false the file couldn't be created or written (e.g. the disk is full)
+ */
+bool
+SpillFile::append(const QCPGraphData* data, std::size_t count, std::size_t& offset)
+{
+    if (!this->open())
+        return false;
+    auto size = static_cast<qint64>(count * sizeof(QCPGraphData));
+    if (!this->m_file.seek(static_cast<qint64>(this->m_points * sizeof(QCPGraphData)))
+        || this->m_file.write(reinterpret_cast<const char*>(data), size) != size
+        || !this->m_file.flush())
+        return false;
+    offset = this->m_points;
+    this->m_points += count;
+    return true;
+}
+
+
+/**
+ * @brief Reads a block of points back (replacing the contents of `data`).
+ * 
+ * @param offset 
+ * @param count 
+ * @param data 
+ * @return true 
+ * @return false the block isn't in the file or couldn't be mapped
+ */
+bool
+SpillFile::read(std::size_t offset, std::size_t count, QVector<QCPGraphData>& data)
+{
+    if (!this->m_file.isOpen() || offset + count > this->m_points)
+        return false;
+    auto size = static_cast<qint64>(count * sizeof(QCPGraphData));
+    auto view = this->m_file.map(static_cast<qint64>(offset * sizeof(QCPGraphData)), size);
+    if (view == nullptr)
+        return false;
+    data.resize(static_cast<qsizetype>(count));
+    std::memcpy(data.data(), view, static_cast<std::size_t>(size));
+    this->m_file.unmap(view);
+    return true;
+}
+
+
+/**
+ * @brief Discards the contents of the file.
+ * 
+ */
+void
+SpillFile::clear()
+{
+    if (this->m_file.isOpen())
+        this->m_file.resize(0);
+    this->m_points = 0;
+}
+
+
+/**
+ * @brief The points are on disk, so the file holds no memory of its own.
+ * 
+ * @return std::size_t 
+ */
+std::size_t
+SpillFile::memoryUsage() const
+{
+    return 0;
+}
+
+
+bool
+SpillFile::open()
+{
+    return this->m_file.isOpen() || this->m_file.open();
+}
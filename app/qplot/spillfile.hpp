@@ -0,0 +1,40 @@
+/*
+ * ExaPlot
+ * plot data spill file
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+#include <QTemporaryFile>
+
+#include "segmentstore.hpp"
+
+
+/**
+ * @brief Temporary file holding 2D plot data that has been moved out of memory. Points are
+ * appended in blocks and read back by mapping the block's part of the file. The file is removed
+ * with the object.
+ * 
+ */
+class SpillFile : public SegmentStore
+{
+public:
+    SpillFile();
+
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    bool append(const QCPGraphData* data, std::size_t count, std::size_t& offset) override;
+    bool read(std::size_t offset, std::size_t count, QVector<QCPGraphData>& data) override;
+    void clear() override;
+    std::size_t memoryUsage() const override;
+
+private:
+    bool open();
+
+    QTemporaryFile m_file;
+    std::size_t m_points;
+};
@@ -3,6 +3,13 @@
 #include "gtest/gtest.h"
 #include "qplot.hpp"
 
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
 
 namespace testing {
 
@@ -38,6 +45,603 @@ TEST(BasicTest, CycleTypes) {
 }
 
 
+TEST(GraphDataTest, SortedAppend) {
+    GraphData data;
+    std::vector<double> keys{0, 1, 2, 2, 3};
+    std::vector<double> values{0, 10, 20, 21, 30};
+    data.append(keys.data(), values.data(), keys.size());
+    data.append(4, 40);
+    ASSERT_EQ(data.size(), 6);
+    EXPECT_EQ((data.constEnd() - 1)->key, 4);
+
+    // out of order data still ends up sorted
+    data.append(1.5, 15);
+    std::vector<double> unsortedKeys{3.5, 0.5};
+    std::vector<double> unsortedValues{35, 5};
+    data.append(unsortedKeys.data(), unsortedValues.data(), unsortedKeys.size());
+    ASSERT_EQ(data.size(), 9);
+    double last = -1;
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        EXPECT_LE(last, it->key);
+        last = it->key;
+    }
+}
+
+
+TEST(GraphDataTest, Bounds) {
+    GraphData data;
+    QCPRange keys, values;
+    EXPECT_FALSE(data.bounds(keys, values));
+
+    std::vector<double> blockKeys{0, 1, 2, 3};
+    std::vector<double> blockValues{5, -2, std::numeric_limits<double>::quiet_NaN(), 7};
+    data.append(blockKeys.data(), blockValues.data(), blockKeys.size());
+    data.append(-1, 1);
+    ASSERT_TRUE(data.bounds(keys, values));
+    EXPECT_EQ(keys.lower, -1);
+    EXPECT_EQ(keys.upper, 3);
+    EXPECT_EQ(values.lower, -2);
+    EXPECT_EQ(values.upper, 7);
+
+    // evicting data recomputes the bounds from what's left
+    data.removeBefore(2.5);
+    ASSERT_TRUE(data.bounds(keys, values));
+    EXPECT_EQ(keys.lower, 3);
+    EXPECT_EQ(values.lower, 7);
+
+    data.clear();
+    EXPECT_FALSE(data.bounds(keys, values));
+}
+
+
+TEST(GraphDataTest, Blocks) {
+    constexpr auto BLOCK = GraphData::BLOCK_SIZE;
+    GraphData data;
+    for (std::size_t i = 0; i < 2 * BLOCK + 1; ++i)
+        data.append(i, i < BLOCK ? 1.0 : -1.0);
+    ASSERT_EQ(data.blocks().size(), 3u);
+    EXPECT_EQ(data.blocks()[0].lower, 1);
+    EXPECT_EQ(data.blocks()[0].upper, 1);
+    EXPECT_EQ(data.blocks()[1].lower, -1);
+    EXPECT_FALSE(data.blocks()[2].gap);
+
+    data.append(2 * BLOCK + 1, std::numeric_limits<double>::quiet_NaN());
+    EXPECT_TRUE(data.blocks()[2].gap);
+
+    // inserting in front of the data shifts every block
+    data.append(-1, 5);
+    ASSERT_EQ(data.blocks().size(), 3u);
+    EXPECT_EQ(data.blocks()[0].upper, 5);
+    EXPECT_EQ(data.blocks()[1].upper, 1);
+
+    data.removeBefore(BLOCK);
+    ASSERT_EQ(data.blocks().size(), 2u);
+    EXPECT_EQ(data.blocks()[0].upper, -1);
+
+    data.clear();
+    EXPECT_TRUE(data.blocks().empty());
+}
+
+
+TEST(GraphDataTest, Spill) {
+    constexpr auto SEGMENT = GraphData::SPILL_SEGMENT_SIZE;
+    constexpr std::size_t POINTS = 4 * SEGMENT + 10;
+    auto value = [](double key) { return std::sin(key * 1e-3); };
+    GraphData data;
+    for (std::size_t i = 0; i < POINTS; ++i)
+        data.append(i, value(i));
+
+    // zoomed out, everything but the latest segment's worth is spilled (to its summary)
+    QCPRange all{0, POINTS};
+    auto usage = data.memoryUsage();
+    auto freed = data.spill(POINTS, all, 500);
+    EXPECT_GT(freed, 2 * SEGMENT);
+    EXPECT_EQ(static_cast<std::size_t>(data.size()), POINTS - freed);
+    EXPECT_LT(data.memoryUsage(), usage / 2);
+    QCPRange keys, values;
+    ASSERT_TRUE(data.bounds(keys, values));
+    EXPECT_EQ(keys.upper, POINTS - 1);
+
+    // zooming in on a spilled segment reads it back
+    QCPRange zoomed{1.2 * SEGMENT, 1.4 * SEGMENT};
+    EXPECT_EQ(data.restore(all, 500), 0u);
+    EXPECT_GT(data.restore(zoomed, 500), 0u);
+    std::size_t restored = 0;
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        if (it->key >= SEGMENT && it->key < 2 * SEGMENT) {
+            EXPECT_EQ(it->value, value(it->key));
+            ++restored;
+        }
+    }
+    EXPECT_EQ(restored, SEGMENT);
+
+    // ...and keeps it while it's in view
+    EXPECT_EQ(data.spill(POINTS, zoomed, 500), 0u);
+    EXPECT_GT(data.spill(POINTS, all, 500), 0u);
+
+    // out of order data among the spilled data brings all of it back
+    data.append(0.5, 0);
+    EXPECT_EQ(static_cast<std::size_t>(data.size()), POINTS + 1);
+    double last = -1;
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        EXPECT_LE(last, it->key);
+        last = it->key;
+    }
+}
+
+
+TEST(GraphDataTest, Compact) {
+    constexpr auto SEGMENT = GraphData::SPILL_SEGMENT_SIZE;
+    constexpr std::size_t POINTS = 4 * SEGMENT + 10;
+    auto value = [](double key) { return std::sin(key * 1e-3); };
+    GraphData data;
+    data.setStorage(GraphData::COMPACT_FLOAT);
+    for (std::size_t i = 0; i < POINTS; ++i)
+        data.append(0.5 * i, value(0.5 * i));
+
+    // evenly spaced keys and single precision values take a quarter of the memory of the points
+    QCPRange all{0, 0.5 * POINTS};
+    auto usage = data.memoryUsage();
+    auto freed = data.spill(std::numeric_limits<std::size_t>::max(), all, 500);
+    EXPECT_GT(freed, 2 * SEGMENT);
+    EXPECT_LT(data.memoryUsage(), usage / 2);
+
+    // zooming in expands the segment again
+    QCPRange zoomed{0.5 * 1.2 * SEGMENT, 0.5 * 1.4 * SEGMENT};
+    EXPECT_GT(data.restore(zoomed, 500), 0u);
+    std::size_t restored = 0;
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        if (it->key >= 0.5 * SEGMENT && it->key < 0.5 * 2 * SEGMENT) {
+            EXPECT_EQ(it->key, 0.5 * static_cast<double>(SEGMENT + restored));
+            EXPECT_EQ(it->value, static_cast<double>(static_cast<float>(value(it->key))));
+            ++restored;
+        }
+    }
+    EXPECT_EQ(restored, SEGMENT);
+
+    // unevenly spaced keys in double precision don't get any smaller
+    GraphData irregular;
+    irregular.setStorage(GraphData::COMPACT);
+    for (std::size_t i = 0; i < POINTS; ++i)
+        irregular.append(i + (i % 3) * 0.25, value(i));
+    QCPRange keys{0, POINTS};
+    EXPECT_EQ(irregular.spill(std::numeric_limits<std::size_t>::max(), keys, 500), 0u);
+    EXPECT_EQ(static_cast<std::size_t>(irregular.size()), POINTS);
+}
+
+
+/**
+ * @brief Appends 10M sorted points one at a time and in blocks, comparing against QCPGraph's own
+ * `addData`. Disabled by default; run with `--gtest_also_run_disabled_tests`.
+ * 
+ */
+TEST(Plot2DBenchmark, DISABLED_SortedAppend) {
+    constexpr int POINTS = 10'000'000;
+    constexpr int BLOCK = 4096;
+    using clock = std::chrono::steady_clock;
+    auto report = [](const char* name, clock::time_point start) {
+        auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        std::cout << name << ": " << elapsed << " s (" << elapsed / POINTS * 1e9 << " ns/point)\n";
+    };
+
+    {
+        QCustomPlot plot;
+        auto graph = plot.addGraph();
+        auto start = clock::now();
+        for (int i = 0; i < POINTS; ++i)
+            graph->addData(i, i);
+        report("QCPGraph::addData (point)", start);
+    }
+    {
+        GraphData data;
+        auto start = clock::now();
+        for (int i = 0; i < POINTS; ++i)
+            data.append(i, i);
+        report("GraphData::append (point)", start);
+        EXPECT_EQ(data.size(), POINTS);
+    }
+
+    QVector<double> keys(BLOCK);
+    QVector<double> values(BLOCK);
+    {
+        QCustomPlot plot;
+        auto graph = plot.addGraph();
+        auto start = clock::now();
+        for (int i = 0; i < POINTS; i += BLOCK) {
+            for (int j = 0; j < BLOCK; ++j)
+                keys[j] = values[j] = i + j;
+            graph->addData(keys, values);
+        }
+        report("QCPGraph::addData (block)", start);
+    }
+    {
+        GraphData data;
+        auto start = clock::now();
+        for (int i = 0; i < POINTS; i += BLOCK) {
+            for (int j = 0; j < BLOCK; ++j)
+                keys[j] = values[j] = i + j;
+            data.append(keys.constData(), values.constData(), BLOCK);
+        }
+        report("GraphData::append (block)", start);
+    }
+    {
+        GraphData data;
+        auto start = clock::now();
+        for (int i = 0; i < POINTS; i += BLOCK) {
+            for (int j = 0; j < BLOCK; ++j)
+                keys[j] = values[j] = i + j;
+            data.append(keys.constData(), values.constData(), BLOCK, true);
+        }
+        report("GraphData::append (block, sorted)", start);
+    }
+}
+
+
+TEST(Plot2DTest, AntialiasThreshold) {
+    const QCP::AntialiasedElements traces = QCP::aePlottables | QCP::aeScatters;
+    Plot2D plot;
+    plot.setAntialiasMaxPoints(100);
+    plot.addData(std::vector<double>(100, 1.0), std::vector<double>(100, 1.0), true);
+    plot.replot();
+    EXPECT_FALSE(plot.widget()->notAntialiasedElements() & traces);
+
+    plot.addData(2.0, 2.0);
+    plot.replot();
+    EXPECT_EQ(plot.widget()->notAntialiasedElements() & traces, traces);
+
+    plot.setAntialiasMaxPoints(0);
+    plot.replot();
+    EXPECT_FALSE(plot.widget()->notAntialiasedElements() & traces);
+}
+
+
+TEST(Plot2DTest, RendererFallback) {
+    Plot2D plot;
+    EXPECT_EQ(plot.renderer(), Plot::RASTER);
+    plot.setRenderer(Plot::OPENGL);
+    if (!Plot::hardwareOpenGl())
+        EXPECT_EQ(plot.renderer(), Plot::RASTER);
+    plot.setRenderer(Plot::RASTER);
+    EXPECT_EQ(plot.renderer(), Plot::RASTER);
+}
+
+
+/**
+ * @brief `Graph` with its (protected) optimization and drawing methods exposed to the tests.
+ * 
+ */
+class TestGraph : public Graph
+{
+public:
+    using Graph::Graph;
+    using Graph::getOptimizedLineData;
+    using Graph::getOptimizedScatterData;
+    using Graph::drawScatterPlot;
+
+    void
+    drawReferenceScatterPlot(QCPPainter* painter, const QVector<QPointF>& scatters, const QCPScatterStyle& style) const
+    {
+        QCPGraph::drawScatterPlot(painter, scatters, style);
+    }
+};
+
+
+static std::vector<std::pair<double, double>>
+points(const QVector<QCPGraphData>& data)
+{
+    std::vector<std::pair<double, double>> result;
+    for (const auto& point : data)
+        result.push_back({point.key, point.value});
+    return result;
+}
+
+
+TEST(Plot2DTest, CulledData) {
+    constexpr auto BLOCK = GraphData::BLOCK_SIZE;
+    auto value = [](std::size_t i) {
+        switch (i / BLOCK) {
+        case 0: return 100.0;
+        case 2: return -100.0;
+        default: return 0.5 * std::sin(i * 0.1);
+        }
+    };
+    QCustomPlot widget;
+    widget.resize(400, 300);
+    QSharedPointer<GraphData> data{new GraphData};
+    // blocks above, within, below and within the visible value range
+    for (std::size_t i = 0; i < 4 * BLOCK; ++i)
+        data->append(i, value(i));
+    auto graph = new TestGraph{widget.xAxis, widget.yAxis, data};
+    // (so that QCP passes every point through)
+    graph->setAdaptiveSampling(false);
+    widget.xAxis->setRange(0, 4 * BLOCK);
+    widget.yAxis->setRange(-1, 1);
+    widget.replot(QCustomPlot::rpImmediateRefresh);
+
+    // off-screen blocks are reduced to their first and last points (so that the lines into and out
+    //   of the viewport are still drawn), every point of an on-screen block is kept
+    std::vector<std::pair<double, double>> expected;
+    auto keep = [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+            expected.push_back({static_cast<double>(i), value(i)});
+    };
+    keep(0, 1);
+    keep(BLOCK - 1, 2 * BLOCK);
+    keep(2 * BLOCK, 2 * BLOCK + 1);
+    keep(3 * BLOCK - 1, 4 * BLOCK);
+    QVector<QCPGraphData> lineData;
+    graph->getOptimizedLineData(&lineData, data->constBegin(), data->constEnd());
+    EXPECT_EQ(points(lineData), expected);
+
+    // ...also for a block only partly within the key range
+    lineData.clear();
+    graph->getOptimizedLineData(&lineData, data->constBegin() + BLOCK / 2, data->constEnd());
+    ASSERT_EQ(static_cast<std::size_t>(lineData.size()), expected.size());
+    EXPECT_EQ(lineData[0].key, BLOCK / 2);
+    EXPECT_EQ(lineData[1].key, BLOCK - 1);
+
+    // scatters of off-screen blocks are dropped altogether
+    expected.clear();
+    keep(BLOCK, 2 * BLOCK);
+    keep(3 * BLOCK, 4 * BLOCK);
+    QVector<QCPGraphData> scatterData;
+    graph->getOptimizedScatterData(&scatterData, data->constBegin(), data->constEnd());
+    EXPECT_EQ(points(scatterData), expected);
+}
+
+
+/**
+ * @brief Renders scatters into an image of the plot's viewport, either through the graph's symbol
+ * pixmap or through QCP's drawing of each scatter.
+ * 
+ */
+static QImage
+renderScatters(const TestGraph* graph, const QVector<QPointF>& scatters, const QCPScatterStyle& style, bool reference)
+{
+    QImage image{graph->parentPlot()->viewport().size(), QImage::Format_ARGB32_Premultiplied};
+    image.fill(Qt::transparent);
+    QCPPainter painter{&image};
+    if (reference)
+        graph->drawReferenceScatterPlot(&painter, scatters, style);
+    else
+        graph->drawScatterPlot(&painter, scatters, style);
+    painter.end();
+    return image;
+}
+
+
+TEST(Plot2DTest, ScatterSymbols) {
+    QCustomPlot widget;
+    widget.resize(400, 300);
+    QSharedPointer<GraphData> data{new GraphData};
+    auto graph = new TestGraph{widget.xAxis, widget.yAxis, data};
+    // (aliased and at whole pixels, so that both paths rasterize the same shapes)
+    graph->setAntialiasedScatters(false);
+    widget.replot(QCustomPlot::rpImmediateRefresh);
+
+    auto rect = widget.axisRect()->rect();
+    QVector<QPointF> scatters;
+    for (int i = 1; i <= 4; ++i)
+        scatters.append(QPointF(rect.left() + 20 * i, rect.top() + 15 * i));
+
+    // each style change has to re-render the cached symbol, or its scatters come out as the last one's
+    QCPScatterStyle styles[] = {
+        {QCPScatterStyle::ssDisc, Qt::red, 7},
+        {QCPScatterStyle::ssDisc, Qt::blue, 7},
+        {QCPScatterStyle::ssDisc, Qt::blue, 11},
+        {QCPScatterStyle::ssSquare, Qt::blue, 11},
+        {QCPScatterStyle::ssCross, Qt::blue, 11},
+    };
+    QImage last;
+    for (const auto& style : styles) {
+        auto image = renderScatters(graph, scatters, style, false);
+        EXPECT_EQ(image, renderScatters(graph, scatters, style, true)) << "shape " << style.shape();
+        EXPECT_NE(image, last) << "shape " << style.shape();
+        last = image;
+    }
+}
+
+
+TEST(Plot2DTest, ScatterPixelsDrawnOnce) {
+    QCustomPlot widget;
+    widget.resize(400, 300);
+    QSharedPointer<GraphData> data{new GraphData};
+    auto graph = new TestGraph{widget.xAxis, widget.yAxis, data};
+    graph->setAntialiasedScatters(false);
+    widget.replot(QCustomPlot::rpImmediateRefresh);
+
+    // (translucent, so that a symbol drawn twice shows)
+    QCPScatterStyle style{QCPScatterStyle::ssDisc, QColor{255, 0, 0, 128}, 7};
+    QPointF point = widget.axisRect()->rect().topLeft() + QPointF{50, 50};
+    auto single = renderScatters(graph, {point}, style, false);
+    ASSERT_NE(single, renderScatters(graph, {point, point}, style, true));
+
+    EXPECT_EQ(renderScatters(graph, {point, point}, style, false), single);
+    EXPECT_EQ(renderScatters(graph, {point, point + QPointF{0.2, 0.7}}, style, false), single);
+    EXPECT_NE(renderScatters(graph, {point, point + QPointF{1, 0}}, style, false), single);
+}
+
+
+TEST(PlotColorMapTest, Waterfall) {
+    PlotColorMap plot;
+    plot.setRangeZ({0, 10});
+    plot.setDataSize(4, 3);
+    plot.clear();
+    plot.setWaterfall(true);
+    plot.pushRow({1, 1, 1, 1});
+    plot.pushRow({2, 2, 2, 2});
+    plot.pushRow({3});
+    plot.pushRow({4, 4, 4, 4});
+    plot.replot();
+
+    // the oldest row is at the bottom, the newest at the top (short rows are padded with the lower
+    //   end of the data range)
+    EXPECT_EQ(plot.cell(0, 0), 2);
+    EXPECT_EQ(plot.cell(0, 1), 3);
+    EXPECT_EQ(plot.cell(3, 1), 0);
+    EXPECT_EQ(plot.cell(3, 2), 4);
+
+    plot.setCell(1, 0, 5);
+    EXPECT_EQ(plot.cell(1, 0), 5);
+
+    // leaving waterfall mode keeps the displayed order
+    plot.setWaterfall(false);
+    EXPECT_EQ(plot.cell(0, 0), 2);
+    EXPECT_EQ(plot.cell(1, 0), 5);
+    EXPECT_EQ(plot.cell(3, 2), 4);
+}
+
+
+/**
+ * @brief Pushes rows into waterfalls of increasing depth, replotting after each row. The time per
+ * row should stay flat as the depth grows. Disabled by default.
+ * 
+ */
+TEST(PlotColorMapBenchmark, DISABLED_WaterfallPush) {
+    constexpr int COLUMNS = 1024;
+    constexpr int PUSHES = 200;
+    using clock = std::chrono::steady_clock;
+
+    std::vector<double> row(COLUMNS);
+    for (int x = 0; x < COLUMNS; ++x)
+        row[x] = std::sin(x * 0.01);
+
+    for (auto depth : {256, 2048, 16384}) {
+        PlotColorMap plot;
+        plot.widget()->resize(1280, 720);
+        plot.setRescaleData(false);
+        plot.setRangeZ({-1, 1});
+        plot.setDataSize(COLUMNS, depth);
+        plot.setWaterfall(true);
+        plot.pushRow(row);
+        plot.widget()->replot(QCustomPlot::rpImmediateRefresh);
+
+        auto start = clock::now();
+        for (int i = 0; i < PUSHES; ++i) {
+            plot.pushRow(row);
+            plot.widget()->replot(QCustomPlot::rpImmediateRefresh);
+        }
+        auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        std::cout << COLUMNS << "x" << depth << ": " << elapsed / PUSHES * 1e3 << " ms/row\n";
+    }
+}
+
+
+TEST(Plot2DBenchmark, DISABLED_DenseReplot) {
+    constexpr int POINTS = 1'000'000;
+    constexpr int REPLOTS = 20;
+    using clock = std::chrono::steady_clock;
+
+    std::vector<double> x(POINTS), y(POINTS);
+    for (int i = 0; i < POINTS; ++i) {
+        x[i] = i;
+        y[i] = std::sin(i * 0.001) + (i % 7) * 0.01;
+    }
+
+    for (auto renderer : {Plot::RASTER, Plot::OPENGL}) {
+        for (auto antialias : {true, false}) {
+            Plot2D plot{{}, {}, {}, {0, POINTS}, {-2, 2}, QCPGraph::lsLine};
+            plot.widget()->resize(1280, 720);
+            plot.setRenderer(renderer);
+            plot.setAntialiasMaxPoints(antialias ? 0 : Plot2D::ANTIALIAS_MAX_POINTS);
+            plot.addData(x, y, true);
+            plot.replot();
+            plot.widget()->replot(QCustomPlot::rpImmediateRefresh);
+
+            auto start = clock::now();
+            for (int i = 0; i < REPLOTS; ++i)
+                plot.widget()->replot(QCustomPlot::rpImmediateRefresh);
+            auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+            std::cout << (plot.renderer() == Plot::OPENGL ? "opengl" : "raster")
+                << (renderer != plot.renderer() ? " (fallback)" : "")
+                << (antialias ? ", antialiased" : ", aliased")
+                << ": " << elapsed / REPLOTS * 1e3 << " ms/replot\n";
+        }
+    }
+}
+
+
+/**
+ * @brief Replots 200k scatters of several shapes, drawn from the symbol atlas, next to the same
+ * scatters drawn shape by shape (QCPGraph). Disabled by default.
+ * 
+ */
+TEST(Plot2DBenchmark, DISABLED_ScatterReplot) {
+    constexpr int POINTS = 200'000;
+    constexpr int REPLOTS = 10;
+    using clock = std::chrono::steady_clock;
+
+    QVector<double> x(POINTS), y(POINTS);
+    for (int i = 0; i < POINTS; ++i) {
+        x[i] = i;
+        y[i] = std::sin(i * 1e-3) + (i % 13) * 0.05;
+    }
+
+    for (auto shape : {QCPScatterStyle::ssCircle, QCPScatterStyle::ssStar, QCPScatterStyle::ssCross}) {
+        QCPScatterStyle style{shape, 6};
+        Plot2D plot{{}, {}, {}, {0, POINTS}, {-2, 2}, QCPGraph::lsNone, style};
+        plot.widget()->resize(1280, 720);
+        plot.addData(x, y, true);
+        plot.replot();
+
+        QCustomPlot reference;
+        reference.resize(1280, 720);
+        auto graph = reference.addGraph();
+        graph->setLineStyle(QCPGraph::lsNone);
+        graph->setScatterStyle(style);
+        graph->setData(x, y, true);
+        reference.rescaleAxes();
+
+        for (auto [name, widget] : {std::pair{"atlas", plot.widget()}, std::pair{"shapes", &reference}}) {
+            widget->replot(QCustomPlot::rpImmediateRefresh);
+            auto start = clock::now();
+            for (int i = 0; i < REPLOTS; ++i)
+                widget->replot(QCustomPlot::rpImmediateRefresh);
+            auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+            std::cout << "shape " << shape << ", " << name << ": " << elapsed / REPLOTS * 1e3 << " ms/replot\n";
+        }
+    }
+}
+
+
+/**
+ * @brief Replots a window of a 10M-point scatter trace zoomed in on both axes, which should cost the
+ * same regardless of the total data size. Disabled by default.
+ * 
+ */
+TEST(Plot2DBenchmark, DISABLED_ZoomedReplot) {
+    constexpr int POINTS = 10'000'000;
+    constexpr int REPLOTS = 20;
+    using clock = std::chrono::steady_clock;
+
+    Plot2D plot{{}, {}, {}, {0, POINTS}, {-2, 2}, QCPGraph::lsLine, QCPScatterStyle{QCPScatterStyle::ssCircle, 4}};
+    plot.widget()->resize(1280, 720);
+    plot.setRescaleAxes(false);
+    std::vector<double> x(POINTS), y(POINTS);
+    for (int i = 0; i < POINTS; ++i) {
+        x[i] = i;
+        y[i] = std::sin(i * 1e-5);
+    }
+    plot.addData(x, y, true);
+
+    for (auto [keys, values] : {
+        std::pair{QCPRange{0, POINTS}, QCPRange{-2, 2}},
+        std::pair{QCPRange{POINTS / 2, POINTS / 2 + 1e6}, QCPRange{-2, 2}},
+        std::pair{QCPRange{POINTS / 2, POINTS / 2 + 1e6}, QCPRange{0.9, 1.0}},
+    }) {
+        plot.setRangeX(keys);
+        plot.setRangeY(values);
+        plot.widget()->replot(QCustomPlot::rpImmediateRefresh);
+        auto start = clock::now();
+        for (int i = 0; i < REPLOTS; ++i)
+            plot.widget()->replot(QCustomPlot::rpImmediateRefresh);
+        auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        std::cout << "x " << keys.lower << ".." << keys.upper << ", y " << values.lower << ".." << values.upper
+            << ": " << elapsed / REPLOTS * 1e3 << " ms/replot\n";
+    }
+}
+
+
 }
 
 
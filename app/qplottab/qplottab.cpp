@@ -44,6 +44,7 @@ QPlotTab::ToolTips QPlotTab::toolTips = {
             .size = PlotProperty::toStr(PlotProperty::TWODIMEN_POINTS_SIZE),
         },
         .autoRescaleAxes = PlotProperty::toStr(PlotProperty::TWODIMEN_AUTORS_AXES),
+        .storage = PlotProperty::toStr(PlotProperty::TWODIMEN_STORAGE),
     },
     .colorMap = {
         .xRange = {
@@ -68,6 +69,7 @@ QPlotTab::ToolTips QPlotTab::toolTips = {
         },
         .autoRescaleAxes = PlotProperty::toStr(PlotProperty::COLORMAP_AUTORS_AXES),
         .autoRescaleData = PlotProperty::toStr(PlotProperty::COLORMAP_AUTORS_DATA),
+        .waterfall = PlotProperty::toStr(PlotProperty::COLORMAP_WATERFALL),
     },
 };
 
@@ -192,6 +194,7 @@ QPlotTab::SubTab2D::setCache(const QPlotTab::SubTab2D::Cache& cache)
     this->lineBox()->setCache(cache.line);
     this->pointsBox()->setCache(cache.points);
     this->setAutoRescaleAxes(cache.autoRescaleAxes);
+    this->setStorage(cache.storage);
 }
 
 
@@ -204,6 +207,7 @@ QPlotTab::SubTab2D::cache() const
         .line = this->lineBox()->cache(),
         .points = this->pointsBox()->cache(),
         .autoRescaleAxes = this->autoRescaleAxes(),
+        .storage = this->storage(),
     };
 }
 
@@ -217,6 +221,7 @@ void QPlotTab::SubTabColorMap::setCache(const QPlotTab::SubTabColorMap::Cache& c
     this->colorBox()->setCache(cache.color);
     this->setAutoRescaleAxes(cache.autoRescaleAxes);
     this->setAutoRescaleData(cache.autoRescaleData);
+    this->setWaterfall(cache.waterfall);
 }
 
 
@@ -231,6 +236,7 @@ QPlotTab::SubTabColorMap::cache() const
         .color = this->colorBox()->cache(),
         .autoRescaleAxes = this->autoRescaleAxes(),
         .autoRescaleData = this->autoRescaleData(),
+        .waterfall = this->waterfall(),
     };
 }
 
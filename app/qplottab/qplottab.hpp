@@ -172,6 +172,7 @@ public:
             LineBox::Cache line;
             PointsBox::Cache points;
             bool autoRescaleAxes;
+            GraphData::Storage storage;
         } Cache;
         typedef struct
         {
@@ -180,6 +181,7 @@ public:
             LineBox::ToolTips line;
             PointsBox::ToolTips points;
             QString autoRescaleAxes;
+            QString storage;
         } ToolTips;
         void setCache(const Cache&);
         Cache cache() const;
@@ -193,6 +195,8 @@ public:
         virtual const PointsBox* pointsBox() const = 0;
         virtual void setAutoRescaleAxes(bool) = 0;
         virtual bool autoRescaleAxes() const = 0;
+        virtual void setStorage(GraphData::Storage) = 0;
+        virtual GraphData::Storage storage() const = 0;
     };
 
     class SubTabColorMap
@@ -207,6 +211,7 @@ public:
             ColorBox::Cache color;
             bool autoRescaleAxes;
             bool autoRescaleData;
+            bool waterfall;
         } Cache;
         typedef struct
         {
@@ -217,6 +222,7 @@ public:
             ColorBox::ToolTips color;
             QString autoRescaleAxes;
             QString autoRescaleData;
+            QString waterfall;
         } ToolTips;
         void setCache(const Cache&);
         Cache cache() const;
@@ -234,6 +240,8 @@ public:
         virtual bool autoRescaleAxes() const = 0;
         virtual void setAutoRescaleData(bool) = 0;
         virtual bool autoRescaleData() const = 0;
+        virtual void setWaterfall(bool) = 0;
+        virtual bool waterfall() const = 0;
     };
 
     typedef struct
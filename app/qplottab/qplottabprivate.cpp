@@ -128,7 +128,7 @@ MinSizeFramePrivate::height() const
 }
 
 
-AutoRescalePrivate::AutoRescalePrivate(
+CheckBoxPrivate::CheckBoxPrivate(
     QWidget* parent,
     const QString& label,
     bool checked)
@@ -145,21 +145,61 @@ AutoRescalePrivate::AutoRescalePrivate(
 
 
 void
-AutoRescalePrivate::set(bool checked)
+CheckBoxPrivate::set(bool checked)
 {
     this->m_checkBox->setChecked(checked);
 }
 
 
 bool
-AutoRescalePrivate::get() const
+CheckBoxPrivate::get() const
 {
     return this->m_checkBox->isChecked();
 }
 
 
 void
-AutoRescalePrivate::setToolTip(const QString& text)
+CheckBoxPrivate::setToolTip(const QString& text)
+{
+    this->m_label->setToolTip(text);
+}
+
+
+StoragePrivate::StoragePrivate(QWidget* parent, const QString& label)
+    : QGroupBox{parent}
+    , m_layout{new QHBoxLayout{this}}
+    , m_label{new QLabel{label, this}}
+    , m_comboBox{new QComboBox{this}}
+{
+    // (in `GraphData::Storage` order)
+    this->m_comboBox->addItems({
+        "Full",
+        "Compact",
+        "Compact Float"
+    });
+    this->m_layout->addWidget(this->m_label);
+    this->m_layout->addWidget(this->m_comboBox);
+}
+
+
+void
+StoragePrivate::set(GraphData::Storage storage)
+{
+    auto index = static_cast<int>(storage);
+    if (index < 0 || index > 2) return;
+    this->m_comboBox->setCurrentIndex(index);
+}
+
+
+GraphData::Storage
+StoragePrivate::get() const
+{
+    return static_cast<GraphData::Storage>(this->m_comboBox->currentIndex());
+}
+
+
+void
+StoragePrivate::setToolTip(const QString& text)
 {
     this->m_label->setToolTip(text);
 }
@@ -655,7 +695,8 @@ SubTab2DPrivate::SubTab2DPrivate(QWidget* parent)
     , m_rangeBox_y{new RangeBoxPrivate{m_contents, "Y-Range", -10, 10}}
     , m_lineBox{new LineBoxPrivate{m_contents, "Line"}}
     , m_pointsBox{new PointsBoxPrivate{m_contents, "Points"}}
-    , m_autoRescaleAxes{new AutoRescalePrivate{m_contents, "Auto-Rescale Axes"}}
+    , m_autoRescaleAxes{new CheckBoxPrivate{m_contents, "Auto-Rescale Axes"}}
+    , m_storage{new StoragePrivate{m_contents, "Storage"}}
     , m_spacer{new QSpacerItem{0, 0, QSizePolicy::Minimum, QSizePolicy::Expanding}}
 {
     this->m_rangeBox_x->setMinToolTip(QPlotTab::toolTips.twoDimen.xRange.min);
@@ -669,6 +710,7 @@ SubTab2DPrivate::SubTab2DPrivate(QWidget* parent)
     this->m_pointsBox->setColorToolTip(QPlotTab::toolTips.twoDimen.points.color);
     this->m_pointsBox->setSizeToolTip(QPlotTab::toolTips.twoDimen.points.size);
     this->m_autoRescaleAxes->setToolTip(QPlotTab::toolTips.twoDimen.autoRescaleAxes);
+    this->m_storage->setToolTip(QPlotTab::toolTips.twoDimen.storage);
     this->m_scrollArea->setFrameShape(QFrame::NoFrame);
     this->m_scrollArea->setWidgetResizable(true);
     this->m_layout_contents->addWidget(this->m_rangeBox_x);
@@ -676,6 +718,7 @@ SubTab2DPrivate::SubTab2DPrivate(QWidget* parent)
     this->m_layout_contents->addWidget(this->m_lineBox);
     this->m_layout_contents->addWidget(this->m_pointsBox);
     this->m_layout_contents->addWidget(this->m_autoRescaleAxes);
+    this->m_layout_contents->addWidget(this->m_storage);
     this->m_layout_contents->addItem(this->m_spacer);
     this->m_scrollArea->setWidget(this->m_contents);
     this->m_layout->setContentsMargins(0, 0, 0, 0);
@@ -753,6 +796,20 @@ SubTab2DPrivate::autoRescaleAxes() const
 }
 
 
+void
+SubTab2DPrivate::setStorage(GraphData::Storage storage)
+{
+    this->m_storage->set(storage);
+}
+
+
+GraphData::Storage
+SubTab2DPrivate::storage() const
+{
+    return this->m_storage->get();
+}
+
+
 SubTabColorMapPrivate::SubTabColorMapPrivate(QWidget* parent)
     : QWidget{parent}
     , m_layout{new QVBoxLayout{this}}
@@ -764,8 +821,9 @@ SubTabColorMapPrivate::SubTabColorMapPrivate(QWidget* parent)
     , m_rangeBox_z{new RangeBoxPrivate{m_contents, "Z-Range", 0, 1}}
     , m_dataSizeBox{new DataSizeBoxPrivate{m_contents, "Data Size", 21, 21}}
     , m_colorBox{new ColorBoxPrivate{m_contents, "Color"}}
-    , m_autoRescaleAxes{new AutoRescalePrivate{m_contents, "Auto-Rescale Axes"}}
-    , m_autoRescaleData{new AutoRescalePrivate{m_contents, "Auto-Rescale Data"}}
+    , m_autoRescaleAxes{new CheckBoxPrivate{m_contents, "Auto-Rescale Axes"}}
+    , m_autoRescaleData{new CheckBoxPrivate{m_contents, "Auto-Rescale Data"}}
+    , m_waterfall{new CheckBoxPrivate{m_contents, "Waterfall"}}
     , m_spacer{new QSpacerItem{0, 0, QSizePolicy::Minimum, QSizePolicy::Expanding}}
 {
     this->m_rangeBox_x->setMinToolTip(QPlotTab::toolTips.colorMap.xRange.min);
@@ -780,6 +838,7 @@ SubTabColorMapPrivate::SubTabColorMapPrivate(QWidget* parent)
     this->m_colorBox->setMaxToolTip(QPlotTab::toolTips.colorMap.color.max);
     this->m_autoRescaleAxes->setToolTip(QPlotTab::toolTips.colorMap.autoRescaleAxes);
     this->m_autoRescaleData->setToolTip(QPlotTab::toolTips.colorMap.autoRescaleData);
+    this->m_waterfall->setToolTip(QPlotTab::toolTips.colorMap.waterfall);
     this->m_scrollArea->setFrameShape(QFrame::NoFrame);
     this->m_scrollArea->setWidgetResizable(true);
     this->m_layout_contents->addWidget(this->m_rangeBox_x);
@@ -789,6 +848,7 @@ SubTabColorMapPrivate::SubTabColorMapPrivate(QWidget* parent)
     this->m_layout_contents->addWidget(this->m_colorBox);
     this->m_layout_contents->addWidget(this->m_autoRescaleAxes);
     this->m_layout_contents->addWidget(this->m_autoRescaleData);
+    this->m_layout_contents->addWidget(this->m_waterfall);
     this->m_layout_contents->addItem(this->m_spacer);
     this->m_scrollArea->setWidget(this->m_contents);
     this->m_layout->setContentsMargins(0, 0, 0, 0);
@@ -892,3 +952,17 @@ SubTabColorMapPrivate::autoRescaleData() const
 {
     return this->m_autoRescaleData->get();
 }
+
+
+void
+SubTabColorMapPrivate::setWaterfall(bool checked)
+{
+    this->m_waterfall->set(checked);
+}
+
+
+bool
+SubTabColorMapPrivate::waterfall() const
+{
+    return this->m_waterfall->get();
+}
@@ -94,12 +94,12 @@ private:
 };
 
 
-class AutoRescalePrivate : public QGroupBox
+class CheckBoxPrivate : public QGroupBox
 {
     Q_OBJECT
 
 public:
-    explicit AutoRescalePrivate(QWidget* parent, const QString& label, bool checked = false);
+    explicit CheckBoxPrivate(QWidget* parent, const QString& label, bool checked = false);
 
     void set(bool);
     bool get() const;
@@ -112,6 +112,24 @@ private:
 };
 
 
+class StoragePrivate : public QGroupBox
+{
+    Q_OBJECT
+
+public:
+    StoragePrivate(QWidget* parent, const QString& label);
+
+    void set(GraphData::Storage);
+    GraphData::Storage get() const;
+    void setToolTip(const QString&);
+
+private:
+    QHBoxLayout* m_layout;
+    QLabel* m_label;
+    QComboBox* m_comboBox;
+};
+
+
 class RangeBoxPrivate : public QGroupBox, public QPlotTab::RangeBox
 {
     Q_OBJECT
@@ -268,6 +286,8 @@ public:
     const QPlotTab::PointsBox* pointsBox() const override;
     void setAutoRescaleAxes(bool) override;
     bool autoRescaleAxes() const override;
+    void setStorage(GraphData::Storage) override;
+    GraphData::Storage storage() const override;
 
 private:
     QVBoxLayout* m_layout;
@@ -278,7 +298,8 @@ private:
     RangeBoxPrivate* m_rangeBox_y;
     LineBoxPrivate* m_lineBox;
     PointsBoxPrivate* m_pointsBox;
-    AutoRescalePrivate* m_autoRescaleAxes;
+    CheckBoxPrivate* m_autoRescaleAxes;
+    StoragePrivate* m_storage;
     QSpacerItem* m_spacer;
 };
 
@@ -304,6 +325,8 @@ public:
     bool autoRescaleAxes() const override;
     void setAutoRescaleData(bool) override;
     bool autoRescaleData() const override;
+    void setWaterfall(bool) override;
+    bool waterfall() const override;
 
 private:
     QVBoxLayout* m_layout;
@@ -315,7 +338,8 @@ private:
     RangeBoxPrivate* m_rangeBox_z;
     DataSizeBoxPrivate* m_dataSizeBox;
     ColorBoxPrivate* m_colorBox;
-    AutoRescalePrivate* m_autoRescaleAxes;
-    AutoRescalePrivate* m_autoRescaleData;
+    CheckBoxPrivate* m_autoRescaleAxes;
+    CheckBoxPrivate* m_autoRescaleData;
+    CheckBoxPrivate* m_waterfall;
     QSpacerItem* m_spacer;
 };
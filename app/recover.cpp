@@ -0,0 +1,43 @@
+/*
+ * ExaPlot
+ * data file recovery tool entry point
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#include "datajournal.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3) {
+        std::cerr << "usage: " << argv[0] << " JOURNAL [OUTPUT]\n"
+            << "Rebuild a data file from the journal of an interrupted run.\n"
+            << "OUTPUT defaults to the journal's data file path with a '.recovered.hdf5' suffix.\n";
+        return 2;
+    }
+
+    std::filesystem::path journal{argv[1]};
+    std::filesystem::path output;
+    if (argc == 3) {
+        output = argv[2];
+    } else {
+        // "data.hdf5.journal" -> "data.hdf5.recovered.hdf5"
+        output = journal;
+        output.replace_extension(".recovered.hdf5");
+    }
+
+    try {
+        auto records = DataJournal::recover(journal, output);
+        std::cout << "Recovered " << records << " records to " << output.string() << '\n';
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Recovery failed: " << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,980 @@
+#include "gtest/gtest.h"
+#include "datamanager.hpp"
+#include "datajournal.hpp"
+#include "datarawstorage.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+namespace testing {
+
+
+namespace datamanager {
+
+
+static hsize_t
+datasetRows(hid_t fileID, const std::string& name)
+{
+    hsize_t dims[2] = {0};
+    auto dataset = H5Dopen(fileID, name.c_str(), H5P_DEFAULT);
+    auto dataspace = H5Dget_space(dataset);
+    H5Sget_simple_extent_dims(dataspace, dims, NULL);
+    H5Sclose(dataspace);
+    H5Dclose(dataset);
+    return dims[0];
+}
+
+
+/**
+ * @brief Gives each test a directory of its own under the system's temporary directory. The file
+ * opened by the test (if still open) and everything written to the directory are removed once the
+ * test ends, including when an assertion fails partway through.
+ * 
+ */
+class DataManagerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+    hid_t createFile(const std::string& name);
+    hid_t openFile(const std::filesystem::path& path);
+
+    std::filesystem::path directory;
+    hid_t fileID = H5I_INVALID_HID;
+};
+
+
+using DataManagerBenchmark = DataManagerTest;
+
+
+void
+DataManagerTest::SetUp()
+{
+    auto test = ::testing::UnitTest::GetInstance()->current_test_info();
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    this->directory = std::filesystem::temp_directory_path()
+        / (std::string{"exaplot-"} + test->test_suite_name() + "-" + test->name() + "-" + std::to_string(stamp));
+    std::filesystem::create_directories(this->directory);
+}
+
+
+void
+DataManagerTest::TearDown()
+{
+    if (this->fileID != H5I_INVALID_HID)
+        H5Fclose(this->fileID);
+    this->fileID = H5I_INVALID_HID;
+    std::error_code error;
+    std::filesystem::remove_all(this->directory, error);
+}
+
+
+/**
+ * @brief Creates (or truncates) a file in the test's directory, closing the one previously opened
+ * by the test.
+ * 
+ * @param name 
+ * @return hid_t the file's ID (H5I_INVALID_HID on failure)
+ */
+hid_t
+DataManagerTest::createFile(const std::string& name)
+{
+    if (this->fileID != H5I_INVALID_HID)
+        H5Fclose(this->fileID);
+    auto path = this->directory / name;
+    this->fileID = H5Fcreate(path.string().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    return this->fileID;
+}
+
+
+/**
+ * @brief Opens a file (read-only), closing the one previously opened by the test.
+ * 
+ * @param path 
+ * @return hid_t the file's ID (H5I_INVALID_HID on failure)
+ */
+hid_t
+DataManagerTest::openFile(const std::filesystem::path& path)
+{
+    if (this->fileID != H5I_INVALID_HID)
+        H5Fclose(this->fileID);
+    this->fileID = H5Fopen(path.string().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    return this->fileID;
+}
+
+
+TEST_F(DataManagerTest, FlushPolicyLimits)
+{
+    auto fileID = this->createFile("flush.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    HDF5Storage storage{fileID};
+
+    {
+        auto rows = DataSet2D::create(storage, "rows", exa::StorageType::FLOAT64);
+        rows->setFlushPolicy({.rows = 10, .bytes = 0, .age = {}});
+        for (int i = 0; i < 25; ++i)
+            rows->write(i, i);
+        EXPECT_EQ(datasetRows(fileID, "rows.twodimen"), 20u);
+        EXPECT_FALSE(rows->empty());
+
+        // float64 2D rows are 16 bytes, so a 48 byte limit writes every 3 rows
+        auto bytes = DataSet2D::create(storage, "bytes", exa::StorageType::FLOAT64);
+        bytes->setFlushPolicy({.rows = 4096, .bytes = 48, .age = {}});
+        for (int i = 0; i < 10; ++i)
+            bytes->write(i, i);
+        EXPECT_EQ(datasetRows(fileID, "bytes.twodimen"), 9u);
+
+        rows->flush();
+        EXPECT_TRUE(rows->empty());
+        EXPECT_EQ(datasetRows(fileID, "rows.twodimen"), 25u);
+    }
+}
+
+
+TEST_F(DataManagerTest, StorageTypes)
+{
+    auto fileID = this->createFile("dtype.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    HDF5Storage storage{fileID};
+
+    {
+        DataSetGroup group{storage, "int16", exa::StorageType::INT16};
+        group.dataset2D()->write(
+            {0, 1.4, -1.6, 40000, -40000},
+            {std::numeric_limits<double>::quiet_NaN(), 2.5, -2.5, 32767, -32768}
+        );
+        group.datasetCM()->write(0, {0.4, 65535});
+        group.dataset2D()->flush();
+        group.datasetCM()->flush();
+
+        auto dataset = H5Dopen(fileID, "int16.twodimen", H5P_DEFAULT);
+        auto datatype = H5Dget_type(dataset);
+        EXPECT_TRUE(H5Tequal(datatype, H5T_STD_I16LE) > 0);
+        H5Tclose(datatype);
+        std::vector<std::int16_t> values(10);
+        EXPECT_GE(H5Dread(dataset, H5T_NATIVE_INT16, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()), 0);
+        std::vector<std::int16_t> expected{0, 0, 1, 3, -2, -3, 32767, 32767, -32768, -32768};
+        EXPECT_EQ(values, expected);
+        H5Dclose(dataset);
+
+        // colormap values are converted back to double by the reader
+        dataset = H5Dopen(fileID, "int16.colormap", H5P_DEFAULT);
+        auto memtype = H5Tcreate(H5T_COMPOUND, sizeof(CMData));
+        H5Tinsert(memtype, "x", HOFFSET(CMData, x), H5T_NATIVE_INT);
+        H5Tinsert(memtype, "y", HOFFSET(CMData, y), H5T_NATIVE_INT);
+        H5Tinsert(memtype, "z", HOFFSET(CMData, value), H5T_NATIVE_DOUBLE);
+        std::vector<CMData> cells(2);
+        EXPECT_GE(H5Dread(dataset, memtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, cells.data()), 0);
+        EXPECT_EQ(cells[0].value, 0);
+        EXPECT_EQ(cells[1].x, 1);
+        EXPECT_EQ(cells[1].value, 32767);
+        H5Tclose(memtype);
+        H5Dclose(dataset);
+    }
+}
+
+
+TEST_F(DataManagerTest, MultiTraceLayout)
+{
+    auto fileID = this->createFile("traces.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    HDF5Storage storage{fileID};
+
+    {
+        auto dataset = DataSet2D::create(storage, "traces", exa::StorageType::FLOAT64);
+        dataset->write(0, 1);
+        dataset->write({1, 2}, {{2, 3}, {20, 30}, {200, 300}});
+        dataset->write(3, 4);
+        EXPECT_EQ(dataset->traces(), 3u);
+        dataset->flush();
+    }
+
+    auto dataset = H5Dopen(fileID, "traces.twodimen", H5P_DEFAULT);
+    auto dataspace = H5Dget_space(dataset);
+    hsize_t dims[2] = {0};
+    H5Sget_simple_extent_dims(dataspace, dims, NULL);
+    H5Sclose(dataspace);
+    EXPECT_EQ(dims[0], 4u);
+    EXPECT_EQ(dims[1], 4u);
+
+    // rows written with fewer traces are padded with NaN
+    std::vector<double> values(16);
+    EXPECT_GE(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()), 0);
+    std::vector<double> expected{1, 2, 20, 200, 2, 3, 30, 300};
+    EXPECT_EQ(std::vector<double>(values.begin() + 4, values.begin() + 12), expected);
+    EXPECT_EQ(values[0], 0);
+    EXPECT_EQ(values[1], 1);
+    EXPECT_TRUE(std::isnan(values[2]) && std::isnan(values[3]));
+    EXPECT_EQ(values[12], 3);
+    EXPECT_TRUE(std::isnan(values[14]) && std::isnan(values[15]));
+    H5Dclose(dataset);
+}
+
+
+static std::vector<double>
+readAttribute(hid_t dataset, const char* name)
+{
+    auto attribute = H5Aopen(dataset, name, H5P_DEFAULT);
+    auto dataspace = H5Aget_space(attribute);
+    std::vector<double> values(static_cast<std::size_t>(H5Sget_simple_extent_npoints(dataspace)));
+    H5Aread(attribute, H5T_NATIVE_DOUBLE, values.data());
+    H5Sclose(dataspace);
+    H5Aclose(attribute);
+    return values;
+}
+
+
+TEST_F(DataManagerTest, StreamSegments)
+{
+    auto fileID = this->createFile("stream.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    HDF5Storage storage{fileID};
+
+    {
+        DataSetGroup group{storage, "stream"};
+        EXPECT_EQ(group.datasetStream(), nullptr);
+        group.openStream().write({1, 2, 3}, 0.5, 0.25);
+        // continues the first segment (the next x-value is 1.25)
+        group.openStream().write({4, 5}, 1.25, 0.25);
+        group.openStream().write({6}, 10, 0.25);
+        group.openStream().write({7, 8}, 10.25, 1);
+        ASSERT_NE(group.datasetStream(), nullptr);
+        group.datasetStream()->flush();
+        EXPECT_TRUE(group.datasetStream()->empty());
+    }
+
+    auto dataset = H5Dopen(fileID, "stream.stream", H5P_DEFAULT);
+    auto dataspace = H5Dget_space(dataset);
+    hsize_t dims[2] = {0};
+    H5Sget_simple_extent_dims(dataspace, dims, NULL);
+    H5Sclose(dataspace);
+    EXPECT_EQ(dims[0], 8u);
+    EXPECT_EQ(dims[1], 1u);
+
+    std::vector<double> values(8);
+    EXPECT_GE(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()), 0);
+    EXPECT_EQ(values, (std::vector<double>{1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(readAttribute(dataset, "offset"), (std::vector<double>{0, 5, 6}));
+    EXPECT_EQ(readAttribute(dataset, "x0"), (std::vector<double>{0.5, 10, 10.25}));
+    EXPECT_EQ(readAttribute(dataset, "dx"), (std::vector<double>{0.25, 0.25, 1}));
+    H5Dclose(dataset);
+}
+
+
+static std::vector<double>
+readRows(hid_t fileID, const std::string& name, hsize_t* dims)
+{
+    auto dataset = H5Dopen(fileID, name.c_str(), H5P_DEFAULT);
+    auto dataspace = H5Dget_space(dataset);
+    H5Sget_simple_extent_dims(dataspace, dims, NULL);
+    H5Sclose(dataspace);
+    std::vector<double> values(dims[0] * dims[1]);
+    H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+    H5Dclose(dataset);
+    return values;
+}
+
+
+static bool
+sameValues(const std::vector<double>& values, const std::vector<double>& expected)
+{
+    if (values.size() != expected.size())
+        return false;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (std::isnan(expected[i]) ? !std::isnan(values[i]) : values[i] != expected[i])
+            return false;
+    }
+    return true;
+}
+
+
+TEST_F(DataManagerTest, SummaryLevels)
+{
+    auto fileID = this->createFile("summary.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    HDF5Storage storage{fileID};
+    auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    {
+        auto dataset = DataSet2D::create(storage, "summary", exa::StorageType::FLOAT64, nullptr, 4);
+        for (int i = 0; i < 18; ++i)
+            dataset->write(i, i == 5 ? nan : -i);
+        // widened partway through a row of the first level
+        dataset->write({18, 19}, {{-18, -19}, {100, 200}});
+        dataset->flush();
+        // the partial rows are only written once the dataset is closed
+        EXPECT_EQ(datasetRows(fileID, "summary.twodimen.summary4"), 5u);
+        EXPECT_EQ(datasetRows(fileID, "summary.twodimen.summary16"), 1u);
+        EXPECT_EQ(datasetRows(fileID, "summary.twodimen.summary64"), 0u);
+    }
+
+    hsize_t dims[2] = {0};
+    auto level = readRows(fileID, "summary.twodimen.summary4", dims);
+    EXPECT_EQ(dims[0], 5u);
+    EXPECT_EQ(dims[1], 6u);
+    // missing values are ignored
+    EXPECT_TRUE(sameValues(std::vector<double>(level.begin(), level.begin() + 12), {
+        0, 3, -3, 0, nan, nan,
+        4, 7, -7, -4, nan, nan,
+    }));
+    EXPECT_TRUE(sameValues(std::vector<double>(level.begin() + 24, level.end()), {16, 19, -19, -16, 100, 200}));
+
+    level = readRows(fileID, "summary.twodimen.summary16", dims);
+    EXPECT_TRUE(sameValues(level, {
+        0, 15, -15, 0, nan, nan,
+        16, 19, -19, -16, 100, 200,
+    }));
+    level = readRows(fileID, "summary.twodimen.summary64", dims);
+    EXPECT_TRUE(sameValues(level, {0, 19, -19, 0, 100, 200}));
+    // the highest level summarizes up to 2^32 rows per row
+    EXPECT_EQ(datasetRows(fileID, "summary.twodimen.summary4294967296"), 1u);
+    EXPECT_LE(H5Lexists(fileID, "summary.twodimen.summary17179869184", H5P_DEFAULT), 0);
+
+    auto dataset = H5Dopen(fileID, "summary.twodimen.summary16", H5P_DEFAULT);
+    EXPECT_EQ(readAttribute(dataset, "rows"), (std::vector<double>{16}));
+    H5Dclose(dataset);
+}
+
+
+TEST_F(DataManagerTest, WaterfallRows)
+{
+    auto fileID = this->createFile("waterfall.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    HDF5Storage storage{fileID};
+
+    {
+        DataSetGroup group{storage, "waterfall"};
+        EXPECT_EQ(group.datasetWaterfall(), nullptr);
+        group.openWaterfall(2).write({1, 2});
+        group.openWaterfall(2).write({3});
+        // widens the dataset
+        group.openWaterfall(2).write({4, 5, 6});
+        ASSERT_NE(group.datasetWaterfall(), nullptr);
+        group.datasetWaterfall()->flush();
+        EXPECT_TRUE(group.datasetWaterfall()->empty());
+    }
+
+    auto dataset = H5Dopen(fileID, "waterfall.waterfall", H5P_DEFAULT);
+    auto dataspace = H5Dget_space(dataset);
+    hsize_t dims[2] = {0};
+    H5Sget_simple_extent_dims(dataspace, dims, NULL);
+    H5Sclose(dataspace);
+    EXPECT_EQ(dims[0], 3u);
+    EXPECT_EQ(dims[1], 3u);
+
+    std::vector<double> values(9);
+    EXPECT_GE(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()), 0);
+    EXPECT_EQ(values[0], 1);
+    EXPECT_EQ(values[1], 2);
+    EXPECT_EQ(values[3], 3);
+    EXPECT_TRUE(std::isnan(values[2]) && std::isnan(values[4]) && std::isnan(values[5]));
+    EXPECT_EQ(std::vector<double>(values.begin() + 6, values.end()), (std::vector<double>{4, 5, 6}));
+    H5Dclose(dataset);
+}
+
+
+TEST_F(DataManagerTest, QueuedWrites)
+{
+    auto path = this->directory / "queue.hdf5";
+
+    DataManager dm;
+    bool openError = true;
+    QObject::connect(&dm, &DataManager::opened, [&](bool error, const QString&) { openError = error; });
+    exa::DatafileConfig config;
+    config.enable = true;
+    dm.configure(config);
+    dm.open(path, 3);
+    ASSERT_FALSE(openError);
+
+    // several producers pushing at once (the script thread is the only one in practice)
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t) {
+        producers.emplace_back([&dm, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                DataWrite data{DataWrite::TWODIMEN, 0};
+                data.x = t;
+                data.y = i;
+                dm.queue().push(std::move(data));
+            }
+        });
+    }
+    DataWrite cells{DataWrite::COLORMAP_VEC, 1};
+    cells.row = 0;
+    cells.ys = {1, 2, 3};
+    dm.queue().push(std::move(cells));
+    dm.drain();
+    for (auto& producer : producers)
+        producer.join();
+    // whatever wasn't drained yet is written before the file is closed
+    dm.close();
+
+    DataWrite dropped;
+    EXPECT_FALSE(dm.queue().pop(dropped));
+    auto fileID = this->openFile(path);
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    EXPECT_EQ(datasetRows(fileID, "dataset1.twodimen"), 4000u);
+    EXPECT_EQ(datasetRows(fileID, "dataset2.colormap"), 3u);
+}
+
+
+TEST_F(DataManagerTest, DataOnlyChannels)
+{
+    auto path = this->directory / "channels.hdf5";
+
+    DataManager dm;
+    exa::DatafileConfig config;
+    config.enable = true;
+    dm.configure(config);
+    dm.open(path, 2);
+
+    DataWrite hidden{DataWrite::TWODIMEN_VEC, 0, true};
+    hidden.xs = {0, 1, 2};
+    hidden.ys = {3, 4, 5};
+    dm.queue().push(std::move(hidden));
+    // fails to be created (the plot's datasets already exist), but still takes up channel ID 1
+    DataWrite taken{DataWrite::CHANNEL, 1, true};
+    taken.name = "dataset1";
+    dm.queue().push(std::move(taken));
+    DataWrite dropped{DataWrite::TWODIMEN, 1, true};
+    dropped.x = 1;
+    dropped.y = 2;
+    dm.queue().push(std::move(dropped));
+    DataWrite raw{DataWrite::CHANNEL, 2, true};
+    raw.name = "raw";
+    dm.queue().push(std::move(raw));
+    DataWrite samples{DataWrite::TWODIMEN_STREAM, 2, true};
+    samples.x = 0;
+    samples.y = 0.5;
+    samples.ys = std::vector<double>(100, 1.);
+    dm.queue().push(std::move(samples));
+    DataWrite point{DataWrite::TWODIMEN, 0};
+    point.x = 1;
+    point.y = 2;
+    dm.queue().push(std::move(point));
+    dm.close();
+
+    auto fileID = this->openFile(path);
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    EXPECT_EQ(datasetRows(fileID, "dataset1.twodimen"), 1u);
+    EXPECT_EQ(datasetRows(fileID, "dataset0.twodimen"), 3u);
+    EXPECT_EQ(datasetRows(fileID, "raw.stream"), 100u);
+    EXPECT_EQ(datasetRows(fileID, "raw.twodimen"), 0u);
+}
+
+
+TEST_F(DataManagerTest, RecordTables)
+{
+    auto path = this->directory / "tables.hdf5";
+
+    DataManager dm;
+    exa::DatafileConfig config;
+    config.enable = true;
+    config.flushRows = 3;
+    dm.configure(config);
+    dm.open(path, 1);
+
+    for (int i = 0; i < 5; ++i) {
+        dm.writeTable("log", {
+            {"time", std::vector<double>{0.5 * i}},
+            {"count", std::vector<std::int64_t>{i}},
+            {"ok", std::vector<std::uint8_t>{i % 2 == 0}},
+        });
+    }
+    dm.writeTable("log", {
+        {"time", std::vector<double>{10, 11}},
+        {"count", std::vector<std::int64_t>{-1, -2}},
+        {"ok", std::vector<std::uint8_t>{0, 1}},
+    });
+    dm.close();
+
+    auto fileID = this->openFile(path);
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    EXPECT_EQ(datasetRows(fileID, "log/time"), 7u);
+    EXPECT_EQ(datasetRows(fileID, "log/count"), 7u);
+    EXPECT_EQ(datasetRows(fileID, "log/ok"), 7u);
+
+    std::vector<std::int64_t> counts(7);
+    auto dataset = H5Dopen(fileID, "log/count", H5P_DEFAULT);
+    auto datatype = H5Dget_type(dataset);
+    EXPECT_EQ(H5Tget_size(datatype), 8u);
+    H5Tclose(datatype);
+    EXPECT_GE(H5Dread(dataset, H5T_NATIVE_INT64, H5S_ALL, H5S_ALL, H5P_DEFAULT, counts.data()), 0);
+    EXPECT_EQ(counts, (std::vector<std::int64_t>{0, 1, 2, 3, 4, -1, -2}));
+    H5Dclose(dataset);
+
+    std::vector<std::uint8_t> ok(7);
+    dataset = H5Dopen(fileID, "log/ok", H5P_DEFAULT);
+    EXPECT_GE(H5Dread(dataset, H5T_NATIVE_UINT8, H5S_ALL, H5S_ALL, H5P_DEFAULT, ok.data()), 0);
+    EXPECT_EQ(ok, (std::vector<std::uint8_t>{1, 0, 1, 0, 1, 0, 1}));
+    H5Dclose(dataset);
+}
+
+
+static std::string
+readRawHeader(const std::filesystem::path& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    std::string header(RawDataset::HEADER_SIZE, '\0');
+    file.read(header.data(), static_cast<std::streamsize>(header.size()));
+    return header;
+}
+
+
+template<typename T>
+static std::vector<T>
+readRawRows(const std::filesystem::path& path, std::size_t elements)
+{
+    std::ifstream file{path, std::ios::binary};
+    file.seekg(RawDataset::HEADER_SIZE);
+    std::vector<T> values(elements);
+    file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(elements * sizeof(T)));
+    return values;
+}
+
+
+TEST_F(DataManagerTest, RawStorage)
+{
+    auto path = this->directory / "raw";
+
+    DataManager dm;
+    bool openError = true;
+    QObject::connect(&dm, &DataManager::opened, [&](bool error, const QString&) { openError = error; });
+    exa::DatafileConfig config;
+    config.enable = true;
+    config.format = exa::StorageFormat::RAW;
+    config.plotDtypes = std::map<std::size_t, exa::StorageType>{{2, exa::StorageType::INT16}};
+    dm.configure(config);
+    dm.open(path, 3);
+    ASSERT_FALSE(openError);
+
+    DataWrite point{DataWrite::TWODIMEN, 0};
+    point.x = 0;
+    point.y = 1;
+    dm.queue().push(std::move(point));
+    // widens the dataset to three traces
+    DataWrite traces{DataWrite::TWODIMEN_MULTI, 0};
+    traces.xs = {1, 2};
+    traces.traces = {{2, 3}, {20, 30}, {200, 300}};
+    dm.queue().push(std::move(traces));
+    DataWrite samples{DataWrite::TWODIMEN_STREAM, 1};
+    samples.x = 0.5;
+    samples.y = 0.25;
+    samples.ys = {1, 2, 3};
+    dm.queue().push(std::move(samples));
+    dm.writeTable("log", {{"count", std::vector<std::int64_t>{4, 5}}});
+    dm.close();
+
+    auto header = readRawHeader(path / "dataset1.twodimen");
+    EXPECT_EQ(header.rfind("EXAPLOT RAW 1\n", 0), 0u);
+    EXPECT_NE(header.find("\"dtype\": \"<f8\""), std::string::npos);
+    EXPECT_NE(header.find("\"offset\": 4096"), std::string::npos);
+    EXPECT_EQ(std::stoull(header.substr(header.find("\"rows\":") + 7)), 3u);
+    EXPECT_EQ(std::stoull(header.substr(header.find("\"columns\":") + 10)), 4u);
+    EXPECT_EQ(header.back(), '\n');
+
+    // the row written before the dataset was widened reads NaN in the new columns
+    auto values = readRawRows<double>(path / "dataset1.twodimen", 12);
+    EXPECT_EQ(values[0], 0);
+    EXPECT_EQ(values[1], 1);
+    EXPECT_TRUE(std::isnan(values[2]) && std::isnan(values[3]));
+    EXPECT_EQ(std::vector<double>(values.begin() + 4, values.end()), (std::vector<double>{1, 2, 20, 200, 2, 3, 30, 300}));
+
+    header = readRawHeader(path / "dataset2.stream");
+    EXPECT_NE(header.find("\"dtype\": \"<i2\""), std::string::npos);
+    EXPECT_EQ(readRawRows<std::int16_t>(path / "dataset2.stream", 3), (std::vector<std::int16_t>{1, 2, 3}));
+    std::ifstream attributes{path / "dataset2.stream.json"};
+    std::string json{std::istreambuf_iterator<char>{attributes}, std::istreambuf_iterator<char>{}};
+    EXPECT_EQ(json, "{\"dx\": [0.25], \"offset\": [0], \"x0\": [0.5]}\n");
+
+    EXPECT_EQ(readRawRows<std::int64_t>(path / "log" / "count", 2), (std::vector<std::int64_t>{4, 5}));
+
+    // datasets of an earlier run are removed when the directory is reused
+    dm.open(path, 2);
+    dm.close();
+    EXPECT_TRUE(std::filesystem::exists(path / "dataset1.twodimen"));
+    EXPECT_FALSE(std::filesystem::exists(path / "dataset2.stream"));
+    EXPECT_FALSE(std::filesystem::exists(path / "dataset2.stream.json"));
+    EXPECT_FALSE(std::filesystem::exists(path / "log" / "count"));
+}
+
+
+static std::string
+readText(const std::filesystem::path& path)
+{
+    std::ifstream file{path};
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+
+TEST_F(DataManagerTest, SegmentRotation)
+{
+    auto path = this->directory / "segments.hdf5";
+
+    DataManager dm;
+    exa::DatafileConfig config;
+    config.enable = true;
+    config.flushRows = 1;
+    dm.configure(config);
+    dm.open(path, 2);
+
+    DataWrite raw{DataWrite::CHANNEL, 0, true};
+    raw.name = "raw";
+    dm.queue().push(std::move(raw));
+    for (int i = 0; i < 3; ++i) {
+        DataWrite point{DataWrite::TWODIMEN, 0};
+        point.x = i;
+        point.y = i;
+        dm.queue().push(std::move(point));
+    }
+    dm.writeTable("log", {{"count", std::vector<std::int64_t>{1}}});
+    // writes queued after the rotation go to the next segment
+    dm.queue().push(DataWrite{DataWrite::ROTATE});
+    DataWrite point{DataWrite::TWODIMEN, 0};
+    point.x = 3;
+    point.y = 3;
+    dm.queue().push(std::move(point));
+    DataWrite sample{DataWrite::TWODIMEN, 1, true};
+    sample.x = 1;
+    sample.y = 2;
+    dm.queue().push(std::move(sample));
+    dm.drain();
+
+    // the size limit is checked before each batch of writes
+    config.segmentBytes = 1;
+    dm.configure(config);
+    point = DataWrite{DataWrite::TWODIMEN, 0};
+    dm.queue().push(std::move(point));
+    dm.drain();
+    dm.close();
+
+    auto fileID = this->openFile(path);
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    EXPECT_EQ(datasetRows(fileID, "dataset1.twodimen"), 3u);
+    EXPECT_EQ(datasetRows(fileID, "raw.twodimen"), 0u);
+    EXPECT_EQ(datasetRows(fileID, "log/count"), 1u);
+
+    fileID = this->openFile(this->directory / "segments.0001.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    EXPECT_EQ(datasetRows(fileID, "dataset1.twodimen"), 1u);
+    EXPECT_EQ(datasetRows(fileID, "raw.twodimen"), 1u);
+    EXPECT_LT(H5Lexists(fileID, "log", H5P_DEFAULT), 1);
+
+    fileID = this->openFile(this->directory / "segments.0002.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    EXPECT_EQ(datasetRows(fileID, "dataset1.twodimen"), 1u);
+
+    auto json = readText(this->directory / "segments.hdf5.segments.json");
+    EXPECT_NE(json.find("\"path\": \"segments.hdf5\""), std::string::npos);
+    EXPECT_NE(json.find("\"path\": \"segments.0001.hdf5\""), std::string::npos);
+    EXPECT_NE(json.find("\"path\": \"segments.0002.hdf5\""), std::string::npos);
+    EXPECT_EQ(json.find("\"end\": null"), std::string::npos);
+    EXPECT_EQ(json.find("\"closed\": false"), std::string::npos);
+}
+
+
+TEST_F(DataManagerTest, CompressedChunks)
+{
+    auto fileID = this->createFile("compressed.hdf5");
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    HDF5Storage storage{fileID};
+
+    constexpr int ROWS = 10000;
+    ChunkCompressor compressor{6, 2};
+    ChunkCompressor pipeline{6, 0};
+    {
+        // blocks of 1000 rows don't line up with the chunks (4096 rows), so rows are written both
+        //   directly (compressed by the workers) and through the filter pipeline
+        DataSetGroup group{storage, "direct", exa::StorageType::FLOAT64, &compressor};
+        group.setFlushPolicy({.rows = 1000, .bytes = 0, .age = {}});
+        for (int i = 0; i < ROWS; ++i)
+            group.dataset2D()->write(i, std::sin(i * 0.01));
+        group.dataset2D()->write(std::vector<double>{ROWS}, std::vector<std::vector<double>>{{1}, {2}});
+        group.dataset2D()->flush();
+        EXPECT_TRUE(group.dataset2D()->empty());
+
+        DataSetGroup reference{storage, "pipeline", exa::StorageType::FLOAT64, &pipeline};
+        for (int i = 0; i < 4096; ++i)
+            reference.dataset2D()->write(i, std::sin(i * 0.01));
+    }
+
+    auto dataset = H5Dopen(fileID, "direct.twodimen", H5P_DEFAULT);
+    auto propertyList = H5Dget_create_plist(dataset);
+    EXPECT_EQ(H5Pget_nfilters(propertyList), 2);
+    H5Pclose(propertyList);
+    std::vector<double> rows(3 * (ROWS + 1));
+    EXPECT_GE(H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, rows.data()), 0);
+    H5Dclose(dataset);
+    for (int i = 0; i < ROWS; ++i) {
+        EXPECT_EQ(rows[3 * i], i);
+        EXPECT_EQ(rows[3 * i + 1], std::sin(i * 0.01));
+        EXPECT_TRUE(std::isnan(rows[3 * i + 2]));
+    }
+    EXPECT_EQ(rows[3 * ROWS], ROWS);
+    EXPECT_EQ(rows[3 * ROWS + 2], 2);
+
+    // the workers compress a chunk to the same bytes as HDF5's filter pipeline
+    std::vector<double> chunk(2 * 4096);
+    for (int i = 0; i < 4096; ++i) {
+        chunk[2 * i] = i;
+        chunk[2 * i + 1] = std::sin(i * 0.01);
+    }
+    auto compressed = ChunkCompressor::compressChunk(
+        reinterpret_cast<const std::uint8_t*>(chunk.data()), chunk.size() * sizeof(double), sizeof(double), 6);
+    dataset = H5Dopen(fileID, "pipeline.twodimen", H5P_DEFAULT);
+    hsize_t offset[] = {0, 0};
+    hsize_t size = 0;
+    EXPECT_GE(H5Dget_chunk_storage_size(dataset, offset, &size), 0);
+    std::vector<std::uint8_t> stored(size);
+    std::uint32_t filterMask = 0;
+    EXPECT_GE(H5Dread_chunk(dataset, H5P_DEFAULT, offset, &filterMask, stored.data()), 0);
+    H5Dclose(dataset);
+    EXPECT_EQ(filterMask, 0u);
+    EXPECT_EQ(stored, compressed);
+}
+
+
+/**
+ * @brief Writes 2D data through compressed datasets with 1, 2, 4 and 8 compression workers (and
+ * HDF5's filter pipeline, i.e. no workers, for reference). Disabled by default.
+ * 
+ */
+TEST_F(DataManagerBenchmark, DISABLED_CompressedWrites)
+{
+    constexpr int BLOCK = 4096;
+    constexpr int BLOCKS = 1024;
+    using clock = std::chrono::steady_clock;
+
+    std::vector<double> x(BLOCK);
+    std::vector<double> y(BLOCK);
+    auto path = this->directory / "compressed.hdf5";
+
+    for (std::size_t workers : {0, 1, 2, 4, 8}) {
+        auto fileID = this->createFile("compressed.hdf5");
+        ASSERT_NE(fileID, H5I_INVALID_HID);
+        HDF5Storage storage{fileID};
+
+        auto start = clock::now();
+        {
+            ChunkCompressor compressor{6, workers};
+            DataSetGroup group{storage, "benchmark", exa::StorageType::FLOAT64, &compressor};
+            for (int block = 0; block < BLOCKS; ++block) {
+                for (int i = 0; i < BLOCK; ++i) {
+                    x[i] = block * BLOCK + i;
+                    y[i] = std::sin(x[i] * 1e-3) + 1e-3 * ((i * 7919) % 1000);
+                }
+                group.dataset2D()->write(x, y);
+            }
+            group.dataset2D()->flush();
+        }
+        auto elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        H5Fflush(fileID, H5F_SCOPE_GLOBAL);
+
+        auto megabytes = 2.0 * sizeof(double) * BLOCK * BLOCKS / 1e6;
+        std::cout << workers << " workers: " << megabytes / elapsed << " MB/s ("
+                  << std::filesystem::file_size(path) / 1e6 << " MB file)\n";
+    }
+}
+
+
+TEST_F(DataManagerTest, JournalRecovery)
+{
+    auto journalPath = this->directory / "recover.hdf5.journal";
+    auto outputPath = this->directory / "recover.hdf5";
+
+    {
+        // a journal that's never closed cleanly (i.e. the run was interrupted)
+        DataJournal journal;
+        journal.open(journalPath, 3);
+        for (int i = 0; i < 5000; ++i)
+            journal.append2D(0, i, 2 * i);
+        for (int i = 0; i < 6; ++i)
+            journal.appendCM(1, i % 3, i / 3, i);
+        journal.append2D(7, 0, 0);  // no such plot
+        journal.append2D(1, 0, 1);
+        journal.appendTrace(1, 1, 2);
+        journal.appendTrace(1, 2, 3);
+    }
+    ASSERT_TRUE(std::filesystem::exists(journalPath));
+
+    ASSERT_EQ(DataJournal::recover(journalPath, outputPath), 5009u);
+    auto fileID = this->openFile(outputPath);
+    ASSERT_NE(fileID, H5I_INVALID_HID);
+    EXPECT_EQ(datasetRows(fileID, "dataset1.twodimen"), 5000u);
+    EXPECT_EQ(datasetRows(fileID, "dataset1.colormap"), 0u);
+    EXPECT_EQ(datasetRows(fileID, "dataset2.colormap"), 6u);
+    EXPECT_EQ(datasetRows(fileID, "dataset2.twodimen"), 1u);
+
+    std::vector<double> row(2);
+    auto dataset = H5Dopen(fileID, "dataset1.twodimen", H5P_DEFAULT);
+    auto dataspace = H5Dget_space(dataset);
+    hsize_t start[] = {4999, 0};
+    hsize_t count[] = {1, 2};
+    H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, start, NULL, count, NULL);
+    auto memspace = H5Screate_simple(2, count, NULL);
+    EXPECT_GE(H5Dread(dataset, H5T_NATIVE_DOUBLE, memspace, dataspace, H5P_DEFAULT, row.data()), 0);
+    EXPECT_EQ(row[0], 4999);
+    EXPECT_EQ(row[1], 9998);
+    H5Sclose(memspace);
+    H5Sclose(dataspace);
+    H5Dclose(dataset);
+}
+
+
+#if !defined(_WIN32)
+
+
+constexpr static std::size_t SWMR_BATCHES = 64;
+// one full write buffer per batch, so every batch reaches the file
+constexpr static std::size_t SWMR_BATCH_SIZE = 4096;
+
+
+/**
+ * @brief Reader process for the SWMR test. Tails the 2D dataset of plot 1 until all of the rows
+ * have been seen, checking that the dataset never shrinks and that every row read is complete.
+ * 
+ * @param path
+ * @param readyFD pipe to wait on until the writer has created the file
+ * @return int exit status (0 on success)
+ */
+static int
+swmrReader(const std::filesystem::path& path, int readyFD)
+{
+    char ready;
+    if (read(readyFD, &ready, 1) != 1)
+        return 2;
+
+    auto fileID = H5Fopen(path.string().c_str(), H5F_ACC_RDONLY | H5F_ACC_SWMR_READ, H5P_DEFAULT);
+    if (fileID == H5I_INVALID_HID)
+        return 3;
+    auto dataset = H5Dopen(fileID, "dataset1.twodimen", H5P_DEFAULT);
+    if (dataset == H5I_INVALID_HID) {
+        H5Fclose(fileID);
+        return 4;
+    }
+
+    int result = 0;
+    hsize_t seen = 0;
+    std::size_t idle = 0;
+    std::vector<double> buffer;
+    while (seen < SWMR_BATCHES * SWMR_BATCH_SIZE) {
+        hsize_t dims[2] = {0};
+        if (H5Drefresh(dataset) < 0) {
+            result = 5;
+            break;
+        }
+        auto dataspace = H5Dget_space(dataset);
+        H5Sget_simple_extent_dims(dataspace, dims, NULL);
+        if (dims[0] < seen || dims[1] != 2) {
+            H5Sclose(dataspace);
+            result = 6;
+            break;
+        }
+        if (dims[0] == seen) {
+            H5Sclose(dataspace);
+            if (++idle > 10000) {
+                result = 7;
+                break;
+            }
+            usleep(1000);
+            continue;
+        }
+        idle = 0;
+
+        hsize_t start[] = {seen, 0};
+        hsize_t count[] = {dims[0] - seen, 2};
+        buffer.resize(count[0] * 2);
+        H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, start, NULL, count, NULL);
+        auto memspace = H5Screate_simple(2, count, NULL);
+        auto status = H5Dread(dataset, H5T_NATIVE_DOUBLE, memspace, dataspace, H5P_DEFAULT, buffer.data());
+        H5Sclose(memspace);
+        H5Sclose(dataspace);
+        if (status < 0) {
+            result = 8;
+            break;
+        }
+        for (hsize_t i = 0; i < count[0]; ++i) {
+            auto row = static_cast<double>(seen + i);
+            if (buffer[2 * i] != row || buffer[2 * i + 1] != 2 * row)
+                result = 9;
+        }
+        if (result)
+            break;
+        seen = dims[0];
+    }
+
+    H5Dclose(dataset);
+    H5Fclose(fileID);
+    return result;
+}
+
+
+TEST_F(DataManagerTest, SWMRConcurrentReader)
+{
+    auto path = this->directory / "swmr.hdf5";
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    auto pid = fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        close(fds[1]);
+        _exit(swmrReader(path, fds[0]));
+    }
+    close(fds[0]);
+
+    DataManager dm;
+    bool openError = true;
+    QObject::connect(&dm, &DataManager::opened, [&](bool error, const QString&) { openError = error; });
+    exa::DatafileConfig config;
+    config.enable = true;
+    config.swmr = true;
+    dm.configure(config);
+    dm.open(path, 2);
+
+    // release the reader even if the file failed to open (it'll fail to open it as well)
+    char ready = 0;
+    EXPECT_EQ(write(fds[1], &ready, 1), 1);
+    close(fds[1]);
+
+    if (!openError) {
+        std::vector<double> x(SWMR_BATCH_SIZE);
+        std::vector<double> y(SWMR_BATCH_SIZE);
+        for (std::size_t batch = 0; batch < SWMR_BATCHES; ++batch) {
+            for (std::size_t i = 0; i < SWMR_BATCH_SIZE; ++i) {
+                x[i] = static_cast<double>(batch * SWMR_BATCH_SIZE + i);
+                y[i] = 2 * x[i];
+            }
+            dm.write2DVec(0, x, y);
+            usleep(2000);
+        }
+        dm.close();
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT_FALSE(openError);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+
+#endif
+
+
+}
+
+
+}
@@ -8,10 +8,17 @@
 
 #include "mainwindow.hpp"
 
+#include <algorithm>
+
 
 MainWindow::MainWindow()
     : QMainWindow{nullptr}
     , m_timer{this}
+    , m_plots{}
+    , m_renderer{Plot::RASTER}
+    , m_plotRenderers{}
+    , m_antialiasMaxPoints{Plot2D::ANTIALIAS_MAX_POINTS}
+    , m_memoryBudget{0}
     , m_programmaticClose{false}
 {
     this->m_ui.setupUi(this);
@@ -39,6 +46,20 @@ MainWindow::actionLoad()
 }
 
 
+QAction*
+MainWindow::actionOpenDatafile()
+{
+    return this->m_ui.actionOpenDatafile;
+}
+
+
+QAction*
+MainWindow::actionSeekDatafile()
+{
+    return this->m_ui.actionSeekDatafile;
+}
+
+
 QPushButton*
 MainWindow::buttonRun()
 {
@@ -81,8 +102,10 @@ MainWindow::setPlots(const std::vector<PlotEditor::PlotInfo>& plots)
         this->m_ui.gridLayout_plots->removeWidget(plot);
 
     if (this->m_plots.size() < plots.size()) {
-        for (auto i = this->m_plots.size(); i < plots.size(); ++i)
+        for (auto i = this->m_plots.size(); i < plots.size(); ++i) {
             this->m_plots.push_back(new QPlot{this->m_ui.widget_plotPanel});
+            this->applyRendering(i);
+        }
     } else if (this->m_plots.size() > plots.size()) {
         for (auto i = this->m_plots.size(); i > plots.size(); --i)
             delete this->m_plots[i - 1];
@@ -124,6 +147,7 @@ MainWindow::setPlots(const std::vector<PlotEditor::PlotInfo>& plots)
             plots[i].attributes.twoDimen.points.size
         });
         plot->plot2D()->setRescaleAxes(plots[i].attributes.twoDimen.autoRescaleAxes);
+        plot->plot2D()->setStorage(plots[i].attributes.twoDimen.storage);
         plot->plotColorMap()->setRangeX({
             plots[i].attributes.colorMap.xRange.min,
             plots[i].attributes.colorMap.xRange.max
@@ -146,12 +170,56 @@ MainWindow::setPlots(const std::vector<PlotEditor::PlotInfo>& plots)
         plot->plotColorMap()->setColorGradient(color);
         plot->plotColorMap()->setRescaleAxes(plots[i].attributes.colorMap.autoRescaleAxes);
         plot->plotColorMap()->setRescaleData(plots[i].attributes.colorMap.autoRescaleData);
+        plot->plotColorMap()->setWaterfall(plots[i].attributes.colorMap.waterfall);
     }
 
     emit this->plotsSet(plots);
 }
 
 
+/**
+ * @brief Sets how the plots are drawn (applied to the current plots and any added later).
+ * 
+ * @param renderer renderer of plots without one of their own
+ * @param plotRenderers renderers of individual plots (by plot index)
+ * @param antialiasMaxPoints 2D plot point count above which antialiasing is turned off
+ */
+void
+MainWindow::setRendering(
+    Plot::Renderer renderer,
+    const std::map<std::size_t, Plot::Renderer>& plotRenderers,
+    std::size_t antialiasMaxPoints)
+{
+    this->m_renderer = renderer;
+    this->m_plotRenderers = plotRenderers;
+    this->m_antialiasMaxPoints = antialiasMaxPoints;
+    for (std::size_t i = 0; i < this->m_plots.size(); ++i)
+        this->applyRendering(i);
+}
+
+
+/**
+ * @brief Sets the memory budget of the plots' data, beyond which old 2D plot data is moved to disk.
+ * 
+ * @param bytes 0 for no budget
+ */
+void
+MainWindow::setMemoryBudget(std::size_t bytes)
+{
+    this->m_memoryBudget = bytes;
+}
+
+
+void
+MainWindow::applyRendering(std::size_t plotIdx)
+{
+    auto plot = this->m_plots[plotIdx];
+    auto renderer = this->m_plotRenderers.find(plotIdx);
+    plot->setRenderer(renderer == this->m_plotRenderers.end() ? this->m_renderer : renderer->second);
+    plot->plot2D()->setAntialiasMaxPoints(this->m_antialiasMaxPoints);
+}
+
+
 /**
  * @brief Updates the script message box.
  * 
@@ -287,4 +355,36 @@ MainWindow::redraw()
 {
     for (const auto& plot : this->m_plots)
         plot->redraw();
+    this->enforceMemoryBudget();
+}
+
+
+/**
+ * @brief Spills data of the plots holding the most until their total is back under the budget. Once
+ * over budget, a quarter of the budget is freed at a time so that spills (each of which copies the
+ * data left in memory) come in batches rather than on every redraw.
+ * 
+ */
+void
+MainWindow::enforceMemoryBudget()
+{
+    if (this->m_memoryBudget == 0)
+        return;
+
+    std::vector<std::pair<std::size_t, QPlot*>> plots;
+    std::size_t usage = 0;
+    for (auto plot : this->m_plots) {
+        plots.push_back({plot->memoryUsage(), plot});
+        usage += plots.back().first;
+    }
+    if (usage <= this->m_memoryBudget)
+        return;
+
+    auto target = this->m_memoryBudget - this->m_memoryBudget / 4;
+    std::sort(plots.begin(), plots.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (const auto& plot : plots) {
+        if (usage <= target)
+            break;
+        usage -= std::min(usage, plot.second->spill(usage - target));
+    }
 }
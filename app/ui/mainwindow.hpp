@@ -15,6 +15,7 @@
 #include "ploteditor.hpp"
 #include "qplot.hpp"
 
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -28,11 +29,15 @@ public:
 
     bool close();
     QAction* actionLoad();
+    QAction* actionOpenDatafile();
+    QAction* actionSeekDatafile();
     QAction* actionAbout();
     QAction* actionPlotEditor();
     QPushButton* buttonRun();
     QPushButton* buttonStop();
     void setPlots(const std::vector<PlotEditor::PlotInfo>&);
+    void setRendering(Plot::Renderer, const std::map<std::size_t, Plot::Renderer>&, std::size_t);
+    void setMemoryBudget(std::size_t);
     void setMessage(const QString& = {}, bool = false);
     void initArgs(const std::vector<std::pair<std::string, std::string>>&);
     std::vector<std::string> scriptArgs() const;
@@ -53,8 +58,15 @@ private Q_SLOTS:
     void redraw();
 
 private:
+    void applyRendering(std::size_t);
+    void enforceMemoryBudget();
+
     Ui::MainWindow m_ui;
     QTimer m_timer;
     std::vector<QPlot*> m_plots;
+    Plot::Renderer m_renderer;
+    std::map<std::size_t, Plot::Renderer> m_plotRenderers;
+    std::size_t m_antialiasMaxPoints;
+    std::size_t m_memoryBudget;
     bool m_programmaticClose;
 };
@@ -22,18 +22,21 @@ init(
     file=RunParam("examples/never-gonna-give-you-up.mp3", "MP3 file"),
 )
 
-plot[1].title = "Spectrogram"
-plot[1].x_axis = "log(Hz)"
-plot[1].two_dimen.line.type = "impulse"
-plot[1].two_dimen.x_range = 1, 4.5
-plot[1].two_dimen.y_range = -150, 0
+plot[1].set(
+    title="Spectrogram",
+    x_axis="log(Hz)",
+    two_dimen__line__type="impulse",
+    two_dimen__x_range=(1, 4.5),
+    two_dimen__y_range=(-150, 0),
+)
 
 plot[2].color_map.show()
-plot[2].color_map.data_size = 10000, 1
-plot[2].color_map.x_range = 1, 4.35
-plot[2].color_map.z_range = -50, 0
-plot[2].color_map.color.min = "#C63C00"
-plot[2].color_map.color.max = "white"
+with plot[2].edit() as p:
+    p.color_map.data_size = 2000, 120
+    p.color_map.waterfall = True
+    p.color_map.x_range = 1, 4.35
+    p.color_map.z_range = -50, 0
+    p.color_map.color = "#C63C00", "white"
 
 plot[3].title = "Waveform"
 plot[3].two_dimen.autorescale_axes = True
@@ -81,7 +84,7 @@ def run(frame_rate: int, file: str):
         spectrogram_lg = 10 * numpy.log(numpy.abs(numpy.fft.rfft(windowed_frame))) - 50
         plot[1]()
         plot[1](bin_frequencies_lg, spectrogram_lg)
-        plot[2]([CubicSpline(bin_frequencies_lg, spectrogram_lg)(bin_frequencies_lg_interp)])
+        plot[2](CubicSpline(bin_frequencies_lg, spectrogram_lg)(bin_frequencies_lg_interp))
         frame_time_remaining = frame_interval_ns - (time.time_ns() - frame_time_start)
         if frame_time_remaining > 0:
             time.sleep(frame_time_remaining * 1e-9)
@@ -9,16 +9,48 @@
 #pragma once
 
 
+#include <cstddef>
 #include <filesystem>
+#include <map>
 #include <optional>
 
 
 namespace exa {
 
 
+enum class StorageType
+{
+    FLOAT64,
+    FLOAT32,
+    INT16,
+    INT32,
+    UINT16,
+};
+
+
+enum class StorageFormat
+{
+    HDF5,
+    RAW,    // memory-mapped files of fixed-width rows
+};
+
+
 struct DatafileConfig
 {
     std::optional<bool> enable;
+    std::optional<bool> swmr;
+    std::optional<bool> journal;
+    std::optional<StorageFormat> format;
+    std::optional<std::size_t> flushRows;
+    std::optional<std::size_t> flushBytes;
+    std::optional<double> flushAge;     // seconds
+    std::optional<StorageType> dtype;   // all plots
+    std::optional<std::map<std::size_t, StorageType>> plotDtypes;  // plot ID -> storage type
+    std::optional<int> compression;     // deflate level (0: none)
+    std::optional<std::size_t> compressionWorkers;
+    std::optional<std::size_t> segmentBytes;        // rotate to a new file past this size (0: never)
+    std::optional<double> segmentDuration;          // seconds (0: never)
+    std::optional<std::size_t> summary;             // factor of the min/max summary levels (0: none)
 };
 
 
@@ -0,0 +1,52 @@
+/*
+ * ExaPlot
+ * data file records
+ * 
+ * SPDX-License-Identifier: GPL-3.0
+ * Copyright (C) 2024 bytemarx
+ */
+
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+#include <vector>
+
+
+namespace exa {
+
+
+/**
+ * @brief Values of a record table column (the column's type is the index of the alternative).
+ * 
+ */
+typedef std::variant<
+    std::vector<double>,        // float
+    std::vector<std::int64_t>,  // int
+    std::vector<std::uint8_t>   // bool
+> ColumnValues;
+
+
+// column types (as indices of `ColumnValues`)
+struct ColumnType
+{
+    enum : std::size_t
+    {
+        FLOAT = 0,
+        INT = 1,
+        BOOL = 2,
+    };
+};
+
+
+struct RecordColumn
+{
+    std::string name;
+    ColumnValues values;
+};
+
+
+}
@@ -24,21 +24,32 @@
 #include <vector>
 
 #include "dataconfig.hpp"
+#include "datarecord.hpp"
 #include "plotproperty.hpp"
 
 
 #define EXA_MODULE     "_exaplot"
 #define EXA_RUNPARAM   "RunParam"
+#define EXA_PROPERTIES "_PlotProperties"
 #define EXA_INTERRUPT  "_Interrupt"
 
 #define EXA_INIT       "init"                  // init(plots = 1, **params)
 #define EXA_STOP       "stop"                  // stop()
 #define EXA_MSG        "msg"                   // msg(message, append = False)
 #define EXA_DATAFILE   "datafile"              // datafile(enable = True, filename = "data_%(time)d")
+#define EXA_ROTATE     "_rotate_datafile"      // _rotate_datafile()
 #define EXA_PLOT       "plot"                  // plot(data_set, *data)
+#define EXA_STREAM     "_stream"               // _stream(plot_id, y, x0 = 0.0, dx = 1.0, *, write = True)
 #define EXA_SET_PLOT   "_set_plot_property"    // _set_plot_property(plot_id, prop, value)
 #define EXA_GET_PLOT   "_get_plot_property"    // _get_plot_property(plot_id, prop)
 #define EXA_SHOW_PLOT  "_show_plot"            // _show_plot(plot_id, plot_type)
+#define EXA_BEGIN_EDIT "_begin_plot_edit"      // _begin_plot_edit(plot_id)
+#define EXA_END_EDIT   "_end_plot_edit"        // _end_plot_edit(plot_id)
+#define EXA_CHANNEL    "_channel"              // _channel(name)
+#define EXA_WRITE      "_write"                // _write(channel_id, *data)
+#define EXA_WRITE_STREAM "_write_stream"       // _write_stream(channel_id, y, x0 = 0.0, dx = 1.0)
+#define EXA_RECORD     "record"                // record(table, /, **columns)
+#define EXA_RECORD_MANY "record_many"          // record_many(table, /, **columns)
 
 #define EXA_SCRIPT_MODULE  "__exa__"
 #define EXA_SCRIPT_RUN     "run"           // run(**kwargs)
@@ -111,15 +122,27 @@ public:
     EXA_API virtual PyObject* stop() = 0;
     EXA_API virtual PyObject* msg(const std::string& message, bool append) = 0;
     EXA_API virtual PyObject* datafile(const DatafileConfig& config, PyObject* path, bool prompt) = 0;
+    EXA_API virtual PyObject* rotateDatafile() = 0;
     EXA_API virtual PyObject* plot2D(std::size_t plotID, double x, double y, bool write) = 0;
-    EXA_API virtual PyObject* plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write) = 0;
+    EXA_API virtual PyObject* plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write, bool sorted) = 0;
+    EXA_API virtual PyObject* plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y, bool write, bool sorted) = 0;
+    EXA_API virtual PyObject* plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx, bool write) = 0;
     EXA_API virtual PyObject* plotCM(std::size_t plotID, int x, int y, double value, bool write) = 0;
     EXA_API virtual PyObject* plotCMVec(std::size_t plotID, int y, const std::vector<double>& values, bool write) = 0;
     EXA_API virtual PyObject* plotCMFrame(std::size_t plotID, const std::vector<std::vector<double>>& frame, bool write) = 0;
+    EXA_API virtual PyObject* plotCMPush(std::size_t plotID, const std::vector<double>& values, bool write) = 0;
+    EXA_API virtual PyObject* channel(const std::string& name) = 0;
+    EXA_API virtual PyObject* write2D(std::size_t channelID, double x, double y) = 0;
+    EXA_API virtual PyObject* write2DVec(std::size_t channelID, const std::vector<double>& x, const std::vector<double>& y) = 0;
+    EXA_API virtual PyObject* write2DMulti(std::size_t channelID, const std::vector<double>& x, const std::vector<std::vector<double>>& y) = 0;
+    EXA_API virtual PyObject* write2DStream(std::size_t channelID, const std::vector<double>& y, double x0, double dx) = 0;
+    EXA_API virtual PyObject* record(const std::string& table, const std::vector<RecordColumn>& columns) = 0;
     EXA_API virtual PyObject* clear(std::size_t plotID) = 0;
     EXA_API virtual PyObject* setPlotProperty(std::size_t plotID, const PlotProperty& property, const PlotProperty::Value& value) = 0;
     EXA_API virtual PyObject* getPlotProperty(std::size_t plotID, const PlotProperty& property) = 0;
     EXA_API virtual PyObject* showPlot(std::size_t plotID, std::size_t plotType) = 0;
+    EXA_API virtual PyObject* beginPlotEdit(std::size_t plotID) = 0;
+    EXA_API virtual PyObject* endPlotEdit(std::size_t plotID) = 0;
     EXA_API virtual Py_ssize_t currentPlotType(std::size_t plotID) = 0;
 };
 
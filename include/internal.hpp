@@ -36,6 +36,7 @@ typedef struct _is {
 
 typedef struct {
     PyTypeObject* type_RunParam;
+    PyTypeObject* type_PlotProperties;
     PyObject* obj_InterruptException;
     exa::Interface* iface;
 } exa_state;
@@ -49,9 +50,42 @@ typedef struct {
 } PyRunParam;
 
 
+typedef enum {
+    PROPERTY_VALUE,     // a single property
+    PROPERTY_GROUP,     // properties set together as a tuple (e.g. `x_range`)
+    PROPERTY_TAB,       // a plot type's properties (e.g. `two_dimen`)
+    PROPERTY_PLOT,      // a plot's properties
+} PlotPropertyNodeType;
+
+
+typedef struct PlotPropertyNode {
+    const char* name;
+    const char* path;                       // full property name
+    PlotPropertyNodeType type;
+    exa::PlotProperty::Type property;       // PROPERTY_VALUE
+    const PlotPropertyNode* children;
+    std::size_t childCount;
+    const char* tupleType;                  // PROPERTY_GROUP: type description of its tuple
+    Py_ssize_t plotType;                    // PROPERTY_TAB: plot type to show
+} PlotPropertyNode;
+
+
+#define EXA_PROPERTY_CHILDREN_MAX 8
+
+
+typedef struct {
+    PyObject_HEAD
+    long plotID;
+    const PlotPropertyNode* node;
+    exa_state* mState;                              // module state of the defining module
+    PyObject* children[EXA_PROPERTY_CHILDREN_MAX];  // cached child property objects
+} PyPlotProperties;
+
+
 namespace exa {
 
 exa_state* getModuleStateFromObject(PyObject*);
+exa_state* getModuleStateFromType(PyTypeObject*);
 
 }
 
@@ -67,9 +101,18 @@ PyObject* exa_init(PyObject*, PyObject* const*, Py_ssize_t, PyObject*);
 PyObject* exa_stop(PyObject*, PyObject*);
 PyObject* exa_msg(PyObject*, PyObject*, PyObject*);
 PyObject* exa_datafile(PyObject*, PyObject*, PyObject*);
+PyObject* exa__rotate_datafile(PyObject*, PyObject*);
 PyObject* exa_plot(PyObject*, PyObject* const*, Py_ssize_t, PyObject*);
+PyObject* exa__stream(PyObject*, PyObject*, PyObject*);
 PyObject* exa__set_plot_property(PyObject*, PyObject*);
 PyObject* exa__get_plot_property(PyObject*, PyObject*);
 PyObject* exa__show_plot(PyObject*, PyObject*);
+PyObject* exa__begin_plot_edit(PyObject*, PyObject*);
+PyObject* exa__end_plot_edit(PyObject*, PyObject*);
+PyObject* exa__channel(PyObject*, PyObject*);
+PyObject* exa__write(PyObject*, PyObject* const*, Py_ssize_t);
+PyObject* exa__write_stream(PyObject*, PyObject*, PyObject*);
+PyObject* exa_record(PyObject*, PyObject*, PyObject*);
+PyObject* exa_record_many(PyObject*, PyObject*, PyObject*);
 
 }
@@ -8,8 +8,8 @@
 
 #pragma once
 
-#include <map>
 #include <string>
+#include <string_view>
 #include <variant>
 
 #include "external.hpp"
@@ -40,6 +40,7 @@ public:
         TWODIMEN_POINTS_COLOR,  // str
         TWODIMEN_POINTS_SIZE,   // float
         TWODIMEN_AUTORS_AXES,   // bool
+        TWODIMEN_STORAGE,       // str
         COLORMAP_XRANGE_MIN,    // float
         COLORMAP_XRANGE_MAX,    // float
         COLORMAP_YRANGE_MIN,    // float
@@ -52,19 +53,21 @@ public:
         COLORMAP_COLOR_MAX,     // str
         COLORMAP_AUTORS_AXES,   // bool
         COLORMAP_AUTORS_DATA,   // bool
+        COLORMAP_WATERFALL,     // bool
     };
 
     EXA_API static const char* toStr(Type);
 
-    EXA_API PlotProperty(const std::string&);
+    EXA_API PlotProperty(std::string_view);
+    EXA_API PlotProperty(Type);
 
     EXA_API constexpr operator Type() const noexcept { return this->m_property; }
     EXA_API constexpr bool operator==(Type t) const noexcept { return t == this->m_property; }
-    EXA_API const char* c_str() const noexcept { return this->m_str.c_str(); }
+    EXA_API const char* c_str() const noexcept { return this->m_str; }
 
 private:
     Type m_property;
-    std::string m_str;
+    const char* m_str;      // the property's (static) name
 };
 
 
@@ -1,7 +1,7 @@
 from numbers import Real
 from os import PathLike
 from pathlib import Path
-from typing import Callable, Generic, Sequence, TypeVar, overload
+from typing import Callable, ContextManager, Generic, Sequence, TypeVar, overload
 
 RunParamType = TypeVar('RunParamType', str, int, float)
 class RunParam(Generic[RunParamType]):
@@ -39,21 +39,83 @@ def init(plots: list[tuple[int, int, int, int]], /, **params: str | int | float
     :param plots: plot arrangement
     :type plots: list[tuple[int, int, int, int]]
     """
-def datafile(
-        *,
-        enable: bool = True,
-        path: PathLike | Callable[[], PathLike] = Path("data.hdf5"),
-        prompt: bool = False,
-    ) -> None:
-    """Configure data file settings.
+class _Datafile:
+    def __call__(
+            self,
+            *,
+            enable: bool = True,
+            path: PathLike | Callable[[], PathLike] = Path("data.hdf5"),
+            prompt: bool = False,
+            swmr: bool = False,
+            flush_rows: int = 4096,
+            flush_bytes: int = 0,
+            flush_age: float = 0,
+            journal: bool = False,
+            dtype: str | dict[int, str] = "float64",
+            compression: int = 0,
+            compression_workers: int = 4,
+            format: str = "hdf5",
+            segment_bytes: int = 0,
+            segment_duration: float = 0,
+            summary: int = 0,
+        ) -> None:
+        """Configure data file settings.
 
-    :param enable: enable or disable writing to a data file, defaults to True
-    :type enable: bool, optional
-    :param path: data file path, defaults to Path("data.hdf5")
-    :type path: PathLike | Callable[[], PathLike], optional
-    :param prompt: prompt before running, defaults to False
-    :type prompt: bool, optional
-    """
+        :param enable: enable or disable writing to a data file, defaults to True
+        :type enable: bool, optional
+        :param path: data file path, defaults to Path("data.hdf5")
+        :type path: PathLike | Callable[[], PathLike], optional
+        :param prompt: prompt before running, defaults to False
+        :type prompt: bool, optional
+        :param swmr: open the data file in single-writer/multiple-reader
+            mode so other processes can read it during a run, defaults to
+            False
+        :type swmr: bool, optional
+        :param flush_rows: maximum number of rows buffered per dataset
+            before they're written to the file, defaults to 4096
+        :type flush_rows: int, optional
+        :param flush_bytes: maximum number of bytes buffered per dataset
+            before they're written to the file (0 for no limit), defaults
+            to 0
+        :type flush_bytes: int, optional
+        :param flush_age: maximum time (in seconds) data may stay buffered
+            before it's flushed to the file (0 for no limit), defaults to 0
+        :type flush_age: float, optional
+        :param journal: also write the data to a crash-safe journal next to
+            the data file (see `exaplot-recover`), defaults to False
+        :type journal: bool, optional
+        :param dtype: storage type of the datasets ("float64", "float32",
+            "int16", "int32" or "uint16"), either for all plots or per plot
+            ID, defaults to "float64"
+        :type dtype: str | dict[int, str], optional
+        :param compression: deflate compression level of the datasets (1
+            through 9, or 0 for no compression), defaults to 0
+        :type compression: int, optional
+        :param compression_workers: number of threads compressing the
+            datasets' chunks (0 leaves compression to HDF5), defaults to
+            the number of cores less one (at most 4)
+        :type compression_workers: int, optional
+        :param format: data file format, either "hdf5" or "raw" (a
+            directory of memory-mapped files, one per dataset), defaults to
+            "hdf5"
+        :type format: str, optional
+        :param segment_bytes: size (in bytes) at which the data file is
+            rotated, i.e. continued in a new file (0 for no limit), defaults
+            to 0
+        :type segment_bytes: int, optional
+        :param segment_duration: time (in seconds) after which the data
+            file is rotated (0 for no limit), defaults to 0
+        :type segment_duration: float, optional
+        :param summary: factor of the min/max summary levels written
+            alongside the 2D datasets (0 for no summary), defaults to 0
+        :type summary: int, optional
+        """
+    def rotate(self) -> None:
+        """Rotate the data file: the data written from here on goes to a
+        new file (the next segment of the data file), while the current
+        one is closed in the background.
+        """
+datafile: _Datafile
 def stop() -> bool:
     """Check if a stop signal has been received.
 
@@ -163,6 +225,15 @@ class PlotProperties:
         def autorescale_axes(self) -> bool: ...
         @autorescale_axes.setter
         def autorescale_axes(self, value: bool) -> None:...
+        @property
+        def storage(self) -> str: ...
+        @storage.setter
+        def storage(self, value: str) -> None:
+            """How the plot stores its data: "full" (default), "compact" or "compact-float".
+
+            Compact storage keeps the data out of view in a compact form: evenly spaced x values
+            aren't stored, and with "compact-float", y values are stored in single precision.
+            """
     class ColorMap(_Tab):
         @property
         def z_range(self) -> PlotProperties.Range: ...
@@ -184,6 +255,13 @@ class PlotProperties:
         def autorescale_data(self) -> bool: ...
         @autorescale_data.setter
         def autorescale_data(self, value: bool) -> None:...
+        @property
+        def waterfall(self) -> bool: ...
+        @waterfall.setter
+        def waterfall(self, value: bool) -> None:
+            """Waterfall mode: `plot[n](values)` pushes a new row (the newest row at the top),
+            replacing the oldest row once all rows are filled.
+            """
 class Plot:
     @overload
     def __call__(self) -> None:
@@ -200,7 +278,7 @@ class Plot:
         :type write: bool, optional
         """
     @overload
-    def __call__(self, x: Sequence[Real], y: Sequence[Real], *, write: bool = True) -> None:
+    def __call__(self, x: Sequence[Real], y: Sequence[Real], *, write: bool = True, sorted: bool = False) -> None:
         """Plots multiple data points to the 2D plot.
 
         :param x: x-values
@@ -209,6 +287,32 @@ class Plot:
         :type y: Sequence[Real]
         :param write: write data to disk, defaults to True
         :type write: bool, optional
+        :param sorted: the x-values are non-decreasing (skips checking them), defaults to False
+        :type sorted: bool, optional
+        """
+    @overload
+    def __call__(self, x: Real, *y: Real, write: bool = True) -> None:
+        """Plots a data point to each of multiple traces of the 2D plot.
+
+        :param x: x-value (shared by the traces)
+        :type x: Real
+        :param y: y-value of each trace
+        :type y: Real
+        :param write: write data to disk, defaults to True
+        :type write: bool, optional
+        """
+    @overload
+    def __call__(self, x: Sequence[Real], *y: Sequence[Real], write: bool = True, sorted: bool = False) -> None:
+        """Plots multiple data points to each of multiple traces of the 2D plot.
+
+        :param x: x-values (shared by the traces)
+        :type x: Sequence[Real]
+        :param y: y-values of each trace (each the same length as x)
+        :type y: Sequence[Real]
+        :param write: write data to disk, defaults to True
+        :type write: bool, optional
+        :param sorted: the x-values are non-decreasing (skips checking them), defaults to False
+        :type sorted: bool, optional
         """
     @overload
     def __call__(self, col: int, row: int, value: Real, *, write: bool = True) -> None:
@@ -243,6 +347,43 @@ class Plot:
         :param write: write data to disk, defaults to True
         :type write: bool, optional
         """
+    @overload
+    def __call__(self, values: Sequence[Real], *, write: bool = True) -> None:
+        """Pushes a row of cell values to the color map (waterfall mode only).
+
+        :param values: row values
+        :type values: Sequence[Real]
+        :param write: write data to disk, defaults to True
+        :type write: bool, optional
+        """
+    def stream(self, y: Sequence[Real], x0: Real = 0.0, dx: Real = 1.0, *, write: bool = True) -> None:
+        """Plots uniformly sampled data points to the 2D plot: the x-value of y[i] is x0 + i * dx.
+        Only the y-values are written to disk; x0 and dx are stored alongside them.
+
+        :param y: y-values
+        :type y: Sequence[Real]
+        :param x0: x-value of the first point, defaults to 0.0
+        :type x0: Real, optional
+        :param dx: x-spacing between points (greater than zero), defaults to 1.0
+        :type dx: Real, optional
+        :param write: write data to disk, defaults to True
+        :type write: bool, optional
+        """
+    def edit(self) -> ContextManager[Plot]:
+        """Groups the property changes made within the context: they're
+        applied to the plot together when the (outermost) context exits.
+
+        ```
+        with plot[1].edit() as p:
+            p.title = "Plot"
+            p.two_dimen.x_range = 0, 10
+        ```
+        """
+    def set(self, **props) -> None:
+        """Sets several plot properties at once (see `edit`). Nested
+        properties are named with '__' (or '.') separators, e.g.
+        `plot[1].set(title="Plot", two_dimen__x_range=(0, 10))`.
+        """
     @property
     def title(self) -> str: ...
     @title.setter
@@ -263,4 +404,66 @@ class Plot:
     def two_dimen(self) -> PlotProperties.TwoDimen: ...
     @property
     def color_map(self) -> PlotProperties.ColorMap: ...
-plot: list[Plot]
+class Channel:
+    @overload
+    def __call__(self, x: Real, y: Real) -> None:
+        """Writes a data point to the channel.
+
+        :param x: x-value
+        :type x: Real
+        :param y: y-value
+        :type y: Real
+        """
+    @overload
+    def __call__(self, x: Sequence[Real], y: Sequence[Real]) -> None:
+        """Writes multiple data points to the channel.
+
+        :param x: x-values
+        :type x: Sequence[Real]
+        :param y: y-values
+        :type y: Sequence[Real]
+        """
+    @overload
+    def __call__(self, x: Real | Sequence[Real], *y: Real | Sequence[Real]) -> None:
+        """Writes data points to each of multiple traces of the channel (the forms of each y
+        argument must match that of x).
+
+        :param x: x-value(s)
+        :type x: Real | Sequence[Real]
+        """
+    def stream(self, y: Sequence[Real], x0: Real = 0.0, dx: Real = 1.0) -> None:
+        """Writes uniformly sampled data points to the channel: the x-value of y[i] is x0 + i * dx.
+
+        :param y: y-values
+        :type y: Sequence[Real]
+        :param x0: x-value of the first point, defaults to 0.0
+        :type x0: Real, optional
+        :param dx: x-spacing between points (greater than zero), defaults to 1.0
+        :type dx: Real, optional
+        """
+def channel(name: str) -> Channel:
+    """Gets a data-only channel: data written to a channel goes straight to the data file (its
+    datasets are named after the channel) and is never displayed. Channels are created on first
+    use within a run. `plot[0]` is the unnamed channel (the "dataset0" datasets).
+
+    :param name: channel name (letters, digits, '_' and '-'; not starting with "dataset")
+    :type name: str
+    :return: the channel
+    :rtype: Channel
+    """
+def record(table: str, /, **columns: bool | int | Real) -> None:
+    """Appends a row to a record table in the data file. Each keyword is a column (a "<table>/<column>"
+    dataset); a column's type (bool, int or float) and the table's set of columns are fixed by the
+    first row recorded to the table within a run. Ints may be recorded to float columns.
+
+    :param table: table name (letters, digits, '_' and '-'; not starting with "dataset")
+    :type table: str
+    """
+def record_many(table: str, /, **columns: Sequence[bool] | Sequence[int] | Sequence[Real]) -> None:
+    """Appends multiple rows to a record table in the data file (see `record`). All of the columns
+    must be the same length.
+
+    :param table: table name
+    :type table: str
+    """
+plot: list[Plot]  # plot[0] is a data-only channel (see `channel`)
@@ -9,9 +9,12 @@
 #include "internal.hpp"
 
 #include <cstdarg>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <iostream>
@@ -46,12 +49,24 @@ moduleMethods[] =
         METH_VARARGS | METH_KEYWORDS,
         NULL
     },
+    {
+        EXA_ROTATE,
+        (PyCFunction)exa__rotate_datafile,
+        METH_NOARGS,
+        NULL
+    },
     {
         EXA_PLOT,
         (PyCFunction)exa_plot,
         METH_FASTCALL | METH_KEYWORDS,
         NULL
     },
+    {
+        EXA_STREAM,
+        (PyCFunction)exa__stream,
+        METH_VARARGS | METH_KEYWORDS,
+        NULL
+    },
     {
         EXA_SET_PLOT,
         (PyCFunction)exa__set_plot_property,
@@ -70,6 +85,48 @@ moduleMethods[] =
         METH_VARARGS,
         NULL
     },
+    {
+        EXA_BEGIN_EDIT,
+        (PyCFunction)exa__begin_plot_edit,
+        METH_VARARGS,
+        NULL
+    },
+    {
+        EXA_END_EDIT,
+        (PyCFunction)exa__end_plot_edit,
+        METH_VARARGS,
+        NULL
+    },
+    {
+        EXA_CHANNEL,
+        (PyCFunction)exa__channel,
+        METH_VARARGS,
+        NULL
+    },
+    {
+        EXA_WRITE,
+        (PyCFunction)exa__write,
+        METH_FASTCALL,
+        NULL
+    },
+    {
+        EXA_WRITE_STREAM,
+        (PyCFunction)exa__write_stream,
+        METH_VARARGS | METH_KEYWORDS,
+        NULL
+    },
+    {
+        EXA_RECORD,
+        (PyCFunction)exa_record,
+        METH_VARARGS | METH_KEYWORDS,
+        NULL
+    },
+    {
+        EXA_RECORD_MANY,
+        (PyCFunction)exa_record_many,
+        METH_VARARGS | METH_KEYWORDS,
+        NULL
+    },
     {NULL, NULL}
 };
 
@@ -116,6 +173,25 @@ getModuleStateFromObject(PyObject* object)
 }
 
 
+/**
+ * @brief Module state of the module defining the given type or one of its bases (e.g. a Python
+ * subclass of a module type). Returns `NULL` (without an error set) if there is none.
+ * 
+ * @param type 
+ * @return exa_state* 
+ */
+exa_state*
+getModuleStateFromType(PyTypeObject* type)
+{
+    auto module = PyType_GetModuleByDef(type, &moduleDef);
+    if (module == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+    return static_cast<exa_state*>(PyModule_GetState(module));
+}
+
+
 PyMODINIT_FUNC
 PyInit__exaplot(void)
 {
@@ -254,7 +330,17 @@ isInterrupt(PyObject* object)
 }
 
 
-static std::map<std::string, PlotProperty::Type> propertyMap{
+typedef struct
+{
+    const char* name;
+    PlotProperty::Type property;
+} PropertyName;
+
+
+// indexed by property type
+static constexpr PropertyName
+propertyNames[] =
+{
     {"title", PlotProperty::TITLE},
     {"x_axis", PlotProperty::XAXIS},
     {"y_axis", PlotProperty::YAXIS},
@@ -272,6 +358,7 @@ static std::map<std::string, PlotProperty::Type> propertyMap{
     {"two_dimen.points.color", PlotProperty::TWODIMEN_POINTS_COLOR},
     {"two_dimen.points.size", PlotProperty::TWODIMEN_POINTS_SIZE},
     {"two_dimen.autorescale_axes", PlotProperty::TWODIMEN_AUTORS_AXES},
+    {"two_dimen.storage", PlotProperty::TWODIMEN_STORAGE},
     {"color_map.x_range.min", PlotProperty::COLORMAP_XRANGE_MIN},
     {"color_map.x_range.max", PlotProperty::COLORMAP_XRANGE_MAX},
     {"color_map.y_range.min", PlotProperty::COLORMAP_YRANGE_MIN},
@@ -284,21 +371,118 @@ static std::map<std::string, PlotProperty::Type> propertyMap{
     {"color_map.color.max", PlotProperty::COLORMAP_COLOR_MAX},
     {"color_map.autorescale_axes", PlotProperty::COLORMAP_AUTORS_AXES},
     {"color_map.autorescale_data", PlotProperty::COLORMAP_AUTORS_DATA},
+    {"color_map.waterfall", PlotProperty::COLORMAP_WATERFALL},
 };
 
+static constexpr std::size_t PROPERTY_COUNT = sizeof(propertyNames) / sizeof(propertyNames[0]);
+static constexpr std::size_t PROPERTY_SLOTS = 256;
+static_assert(PROPERTY_COUNT < PROPERTY_SLOTS);
+
+
+static constexpr bool
+propertyNamesOrdered()
+{
+    for (std::size_t i = 0; i < PROPERTY_COUNT; ++i)
+        if (static_cast<std::size_t>(propertyNames[i].property) != i) return false;
+    return true;
+}
+
+static_assert(propertyNamesOrdered(), "property names must be in the order of their types");
+
+
+/**
+ * @brief Hash slot of a property name: FNV-1a, mixed with the seed and reduced to the top bits of
+ * a Fibonacci hash.
+ * 
+ * @param name 
+ * @param seed 
+ * @return std::size_t 
+ */
+static constexpr std::size_t
+propertySlot(std::string_view name, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u;
+    for (auto c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return static_cast<std::uint32_t>((hash ^ seed) * 2654435769u) >> 24;
+}
+
+
+/**
+ * @brief Find the first seed for which the property names hash to distinct slots.
+ * 
+ * @return std::uint32_t 
+ */
+static constexpr std::uint32_t
+propertySeed()
+{
+    for (std::uint32_t seed = 0; seed < 1024; ++seed) {
+        bool used[PROPERTY_SLOTS] = {};
+        bool collision = false;
+        for (const auto& [name, property] : propertyNames) {
+            auto slot = propertySlot(name, seed);
+            if (used[slot]) {
+                collision = true;
+                break;
+            }
+            used[slot] = true;
+        }
+        if (!collision) return seed;
+    }
+    return std::numeric_limits<std::uint32_t>::max();
+}
+
+static constexpr auto PROPERTY_SEED = propertySeed();
+static_assert(PROPERTY_SEED != std::numeric_limits<std::uint32_t>::max(), "no perfect hash seed for the property names");
+
+
+typedef struct
+{
+    std::uint8_t slots[PROPERTY_SLOTS];     // property type + 1 (0: empty slot)
+} PropertyTable;
+
+
+static constexpr PropertyTable
+propertyTable()
+{
+    PropertyTable table{};
+    for (std::size_t i = 0; i < PROPERTY_COUNT; ++i)
+        table.slots[propertySlot(propertyNames[i].name, PROPERTY_SEED)] = static_cast<std::uint8_t>(i + 1);
+    return table;
+}
+
+static constexpr auto PROPERTY_TABLE = propertyTable();
+
 
 const char*
 PlotProperty::toStr(Type t)
 {
-    for (const auto& [key, value] : propertyMap)
-        if (value == t) return key.c_str();
-    throw std::out_of_range{"Plot property has no mapping"};
+    if (static_cast<std::size_t>(t) >= PROPERTY_COUNT)
+        throw std::out_of_range{"Plot property has no mapping"};
+    return propertyNames[t].name;
+}
+
+
+/**
+ * @brief Look up a property by name (throws `std::out_of_range` for unknown names).
+ * 
+ * @param property 
+ */
+PlotProperty::PlotProperty(std::string_view property)
+{
+    auto entry = PROPERTY_TABLE.slots[propertySlot(property, PROPERTY_SEED)];
+    if (entry == 0 || property != propertyNames[entry - 1].name)
+        throw std::out_of_range{"Unknown plot property"};
+    this->m_property = propertyNames[entry - 1].property;
+    this->m_str = propertyNames[entry - 1].name;
 }
 
 
-PlotProperty::PlotProperty(const std::string& property)
-    : m_property{propertyMap.at(property)}
-    , m_str{property}
+PlotProperty::PlotProperty(Type property)
+    : m_property{property}
+    , m_str{toStr(property)}
 {}
 
 
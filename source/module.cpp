@@ -8,9 +8,15 @@
 
 #include "internal.hpp"
 
+#include <cctype>
+#include <cmath>
+#include <cstddef>
 #include <cstring>
 #include <functional>
+#include <iterator>
 #include <limits>
+#include <string_view>
+#include <tuple>
 
 
 namespace exa {
@@ -34,6 +40,27 @@ PyRunParam_Check(PyObject* object)
 }
 
 
+/**
+ * @brief Convert the elements of a strided buffer of `T` (see `bufferToDoubles`).
+ * 
+ * @tparam T element type
+ * @param data 
+ * @param stride 
+ * @param length 
+ * @param values 
+ */
+template<typename T>
+static void
+convertBuffer(const char* data, Py_ssize_t stride, Py_ssize_t length, double* values)
+{
+    for (Py_ssize_t i = 0; i < length; ++i) {
+        T value;
+        std::memcpy(&value, data + i * stride, sizeof(T));
+        values[i] = static_cast<double>(value);
+    }
+}
+
+
 extern "C" {
 
 
@@ -62,6 +89,7 @@ module_traverse(PyObject* module, visitproc visit, void* arg)
 {
     auto mState = getModuleState(module);
     Py_VISIT(mState->type_RunParam);
+    Py_VISIT(mState->type_PlotProperties);
     Py_VISIT(mState->obj_InterruptException);
     return 0;
 }
@@ -72,6 +100,7 @@ module_clear(PyObject* module)
 {
     auto mState = getModuleState(module);
     Py_CLEAR(mState->type_RunParam);
+    Py_CLEAR(mState->type_PlotProperties);
     Py_CLEAR(mState->obj_InterruptException);
     return 0;
 }
@@ -286,39 +315,252 @@ datafile_keywords[] = {
     (char*)"enable",
     (char*)"path",
     (char*)"prompt",
+    (char*)"swmr",
+    (char*)"flush_rows",
+    (char*)"flush_bytes",
+    (char*)"flush_age",
+    (char*)"journal",
+    (char*)"dtype",
+    (char*)"compression",
+    (char*)"compression_workers",
+    (char*)"format",
+    (char*)"segment_bytes",
+    (char*)"segment_duration",
+    (char*)"summary",
     NULL
 };
 
 
+/**
+ * @brief Convert a storage type name ("float64", "float32", "int16", "int32" or "uint16").
+ * 
+ * @param pyBorrowed_name 
+ * @param type 
+ * @return int 0 on success, -1 with an exception set otherwise
+ */
+static int
+storageTypeFromName(PyObject* pyBorrowed_name, StorageType& type)
+{
+    static const std::pair<const char*, StorageType> names[] = {
+        {"float64", StorageType::FLOAT64},
+        {"float32", StorageType::FLOAT32},
+        {"int16", StorageType::INT16},
+        {"int32", StorageType::INT32},
+        {"uint16", StorageType::UINT16},
+    };
+
+    if (!PyUnicode_Check(pyBorrowed_name)) {
+        PyErr_SetString(PyExc_TypeError, EXA_DATAFILE "() 'dtype' values must be type 'str'");
+        return -1;
+    }
+    auto c_name = PyUnicode_AsUTF8(pyBorrowed_name);
+    if (c_name == NULL)
+        return -1;
+    for (const auto& [name, value] : names) {
+        if (std::strcmp(c_name, name) == 0) {
+            type = value;
+            return 0;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, EXA_DATAFILE "() invalid 'dtype': '%s'", c_name);
+    return -1;
+}
+
+
+/**
+ * @brief Convert a time limit (in seconds) of the data file settings. The data manager keeps the
+ * limits in milliseconds, so they must be finite and within range.
+ * 
+ * @param pyBorrowed_seconds 
+ * @param name keyword of the argument
+ * @param seconds 
+ * @return int 0 on success, -1 with an exception set otherwise
+ */
+static int
+durationFromObject(PyObject* pyBorrowed_seconds, const char* name, double& seconds)
+{
+    // (over 30,000 years, and well within the range of `std::chrono::milliseconds`)
+    constexpr double MAX_SECONDS = 1e12;
+
+    seconds = PyFloat_AsDouble(pyBorrowed_seconds);
+    if (PyErr_Occurred())
+        return -1;
+    if (!std::isfinite(seconds)) {
+        PyErr_Format(PyExc_ValueError, EXA_DATAFILE "() '%s' must be finite", name);
+        return -1;
+    }
+    if (seconds < 0) {
+        PyErr_Format(PyExc_ValueError, EXA_DATAFILE "() '%s' must not be negative", name);
+        return -1;
+    }
+    if (seconds > MAX_SECONDS) {
+        PyErr_Format(PyExc_ValueError, EXA_DATAFILE "() '%s' is too large", name);
+        return -1;
+    }
+    return 0;
+}
+
+
 PyObject*
 exa_datafile(PyObject* module, PyObject* args, PyObject* kwargs)
 {
     int c_enable = 1;
     PyObject* pyBorrowed_path = NULL;
     int c_prompt = 0;
+    int c_swmr = -1;
+    Py_ssize_t c_flushRows = PY_SSIZE_T_MIN;
+    Py_ssize_t c_flushBytes = PY_SSIZE_T_MIN;
+    PyObject* pyBorrowed_flushAge = NULL;
+    int c_journal = -1;
+    PyObject* pyBorrowed_dtype = NULL;
+    int c_compression = -1;
+    Py_ssize_t c_compressionWorkers = PY_SSIZE_T_MIN;
+    const char* c_format = NULL;
+    Py_ssize_t c_segmentBytes = PY_SSIZE_T_MIN;
+    PyObject* pyBorrowed_segmentDuration = NULL;
+    Py_ssize_t c_summary = PY_SSIZE_T_MIN;
     if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, "|$pOp:" EXA_DATAFILE, datafile_keywords,
+            args, kwargs, "|$pOppnnOpOinsnOn:" EXA_DATAFILE, datafile_keywords,
             &c_enable,
             &pyBorrowed_path,
-            &c_prompt
+            &c_prompt,
+            &c_swmr,
+            &c_flushRows,
+            &c_flushBytes,
+            &pyBorrowed_flushAge,
+            &c_journal,
+            &pyBorrowed_dtype,
+            &c_compression,
+            &c_compressionWorkers,
+            &c_format,
+            &c_segmentBytes,
+            &pyBorrowed_segmentDuration,
+            &c_summary
         )) return NULL;
 
     DatafileConfig config;
     if (c_enable != -1)
         config.enable = c_enable != 0;
+    if (c_swmr != -1)
+        config.swmr = c_swmr != 0;
+    if (c_flushRows != PY_SSIZE_T_MIN) {
+        if (c_flushRows < 1) {
+            PyErr_SetString(PyExc_ValueError, EXA_DATAFILE "() 'flush_rows' must be greater than zero");
+            return NULL;
+        }
+        config.flushRows = static_cast<std::size_t>(c_flushRows);
+    }
+    if (c_flushBytes != PY_SSIZE_T_MIN) {
+        if (c_flushBytes < 0) {
+            PyErr_SetString(PyExc_ValueError, EXA_DATAFILE "() 'flush_bytes' must not be negative");
+            return NULL;
+        }
+        config.flushBytes = static_cast<std::size_t>(c_flushBytes);
+    }
+    if (pyBorrowed_flushAge) {
+        double seconds;
+        if (durationFromObject(pyBorrowed_flushAge, "flush_age", seconds) < 0)
+            return NULL;
+        config.flushAge = seconds;
+    }
+    if (c_journal != -1)
+        config.journal = c_journal != 0;
+    if (c_compression != -1) {
+        if (c_compression < 0 || c_compression > 9) {
+            PyErr_SetString(PyExc_ValueError, EXA_DATAFILE "() 'compression' must be from 0 to 9");
+            return NULL;
+        }
+        config.compression = c_compression;
+    }
+    if (c_compressionWorkers != PY_SSIZE_T_MIN) {
+        if (c_compressionWorkers < 0) {
+            PyErr_SetString(PyExc_ValueError, EXA_DATAFILE "() 'compression_workers' must not be negative");
+            return NULL;
+        }
+        config.compressionWorkers = static_cast<std::size_t>(c_compressionWorkers);
+    }
+    if (c_segmentBytes != PY_SSIZE_T_MIN) {
+        if (c_segmentBytes < 0) {
+            PyErr_SetString(PyExc_ValueError, EXA_DATAFILE "() 'segment_bytes' must not be negative");
+            return NULL;
+        }
+        config.segmentBytes = static_cast<std::size_t>(c_segmentBytes);
+    }
+    if (pyBorrowed_segmentDuration) {
+        double seconds;
+        if (durationFromObject(pyBorrowed_segmentDuration, "segment_duration", seconds) < 0)
+            return NULL;
+        config.segmentDuration = seconds;
+    }
+    if (c_summary != PY_SSIZE_T_MIN) {
+        if (c_summary < 0 || c_summary == 1) {
+            PyErr_SetString(PyExc_ValueError, EXA_DATAFILE "() 'summary' must be 0 or at least 2");
+            return NULL;
+        }
+        config.summary = static_cast<std::size_t>(c_summary);
+    }
+    if (c_format) {
+        if (std::strcmp(c_format, "hdf5") == 0)
+            config.format = StorageFormat::HDF5;
+        else if (std::strcmp(c_format, "raw") == 0)
+            config.format = StorageFormat::RAW;
+        else {
+            PyErr_Format(PyExc_ValueError, EXA_DATAFILE "() invalid 'format': '%s'", c_format);
+            return NULL;
+        }
+    }
+    if (pyBorrowed_dtype && PyDict_Check(pyBorrowed_dtype)) {
+        // per-plot storage types
+        std::map<std::size_t, StorageType> plotDtypes;
+        PyObject* pyBorrowed_key;
+        PyObject* pyBorrowed_value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(pyBorrowed_dtype, &pos, &pyBorrowed_key, &pyBorrowed_value)) {
+            if (!PyLong_Check(pyBorrowed_key)) {
+                PyErr_SetString(PyExc_TypeError, EXA_DATAFILE "() 'dtype' keys must be type 'int'");
+                return NULL;
+            }
+            auto plotID = PyLong_AsSsize_t(pyBorrowed_key);
+            if (plotID < 1) {
+                if (!PyErr_Occurred())
+                    PyErr_SetString(PyExc_ValueError, EXA_DATAFILE "() 'dtype' plot IDs must be greater than zero");
+                return NULL;
+            }
+            StorageType type;
+            if (storageTypeFromName(pyBorrowed_value, type) < 0)
+                return NULL;
+            plotDtypes[static_cast<std::size_t>(plotID)] = type;
+        }
+        config.plotDtypes = std::move(plotDtypes);
+    } else if (pyBorrowed_dtype) {
+        StorageType type;
+        if (storageTypeFromName(pyBorrowed_dtype, type) < 0)
+            return NULL;
+        config.dtype = type;
+        config.plotDtypes = std::map<std::size_t, StorageType>{};
+    }
 
     auto state = getModuleState(module);
     return state->iface->datafile(config, pyBorrowed_path, c_prompt != 0);
 }
 
 
+PyObject*
+exa__rotate_datafile(PyObject* module, [[maybe_unused]] PyObject* args)
+{
+    auto state = getModuleState(module);
+    return state->iface->rotateDatafile();
+}
+
+
 static PyObject*
 plot2D(
     exa_state* state,
     std::size_t plotID,
     PyObject* const* args,
     Py_ssize_t nargs,
-    bool write)
+    bool write,
+    [[maybe_unused]] bool sorted)
 {
     if (nargs != 2) {
         PyErr_Format(PyExc_TypeError, EXA_PLOT "() takes 2 positional arguments but %zd were given", nargs);
@@ -332,43 +574,217 @@ plot2D(
 }
 
 
+// buffers of at least this many elements are converted with the GIL released
+constexpr static Py_ssize_t RELEASE_GIL_ELEMENTS = 1 << 15;
+
+
+/**
+ * @brief Convert a one-dimensional buffer of numbers in native format (e.g. a NumPy array or an
+ * `array.array`) without going through its elements as Python objects. Large buffers are converted
+ * with the GIL released, so that the script's other threads carry on in the meantime. Returns
+ * `false` (without an error set) if the object doesn't export such a buffer.
+ * 
+ * @param pyBorrowed_object 
+ * @param values 
+ * @return true 
+ * @return false 
+ */
+static bool
+bufferToDoubles(PyObject* pyBorrowed_object, std::vector<double>& values)
+{
+    typedef void (*Converter)(const char*, Py_ssize_t, Py_ssize_t, double*);
+    static const std::tuple<char, std::size_t, Converter> formats[] = {
+        {'d', sizeof(double), convertBuffer<double>},
+        {'f', sizeof(float), convertBuffer<float>},
+        {'b', sizeof(signed char), convertBuffer<signed char>},
+        {'B', sizeof(unsigned char), convertBuffer<unsigned char>},
+        {'h', sizeof(short), convertBuffer<short>},
+        {'H', sizeof(unsigned short), convertBuffer<unsigned short>},
+        {'i', sizeof(int), convertBuffer<int>},
+        {'I', sizeof(unsigned int), convertBuffer<unsigned int>},
+        {'l', sizeof(long), convertBuffer<long>},
+        {'L', sizeof(unsigned long), convertBuffer<unsigned long>},
+        {'q', sizeof(long long), convertBuffer<long long>},
+        {'Q', sizeof(unsigned long long), convertBuffer<unsigned long long>},
+    };
+
+    if (!PyObject_CheckBuffer(pyBorrowed_object))
+        return false;
+    Py_buffer view;
+    if (PyObject_GetBuffer(pyBorrowed_object, &view, PyBUF_RECORDS_RO) < 0) {
+        PyErr_Clear();
+        return false;
+    }
+
+    // anything other than native numbers (e.g. byte-swapped or structured) is left to the sequence
+    //   protocol
+    std::string_view format{view.format ? view.format : "B"};
+    if (!format.empty() && format.front() == '@')
+        format.remove_prefix(1);
+    Converter convert = nullptr;
+    if (view.ndim == 1 && format.size() == 1) {
+        for (const auto& [code, size, converter] : formats) {
+            if (format.front() == code && static_cast<std::size_t>(view.itemsize) == size)
+                convert = converter;
+        }
+    }
+    if (convert == nullptr) {
+        PyBuffer_Release(&view);
+        return false;
+    }
+
+    auto length = view.shape[0];
+    values.resize(static_cast<std::size_t>(length));
+    auto data = static_cast<const char*>(view.buf);
+    auto stride = view.strides[0];
+    if (length >= RELEASE_GIL_ELEMENTS) {
+        Py_BEGIN_ALLOW_THREADS
+        convert(data, stride, length, values.data());
+        Py_END_ALLOW_THREADS
+    } else {
+        convert(data, stride, length, values.data());
+    }
+    PyBuffer_Release(&view);
+    return true;
+}
+
+
+/**
+ * @brief Convert a sequence of real numbers (see `bufferToDoubles` for buffers of numbers). Returns
+ * `false` (with Python's error indicator set) on failure.
+ * 
+ * @param pyBorrowed_sequence 
+ * @param message error message if the object isn't a sequence
+ * @param values 
+ * @return true 
+ * @return false 
+ */
+static bool
+toDoubles(PyObject* pyBorrowed_sequence, const char* message, std::vector<double>& values)
+{
+    if (bufferToDoubles(pyBorrowed_sequence, values))
+        return true;
+
+    auto pyOwned_values = PySequence_Fast(pyBorrowed_sequence, message);
+    if (pyOwned_values == NULL)
+        return false;
+    auto n_values = PySequence_Fast_GET_SIZE(pyOwned_values);
+    values.resize(n_values);
+    for (decltype(n_values) i = 0; i < n_values; ++i) {
+        auto value = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(pyOwned_values, i));
+        if (PyErr_Occurred()) {
+            Py_DECREF(pyOwned_values);
+            return false;
+        }
+        values[i] = value;
+    }
+    Py_DECREF(pyOwned_values);
+    return true;
+}
+
+
 static PyObject*
 plot2DVec(
     exa_state* state,
     std::size_t plotID,
     PyObject* const* args,
     Py_ssize_t nargs,
-    bool write)
+    bool write,
+    bool sorted)
 {
     if (nargs != 2) {
         PyErr_Format(PyExc_TypeError, EXA_PLOT "() takes 2 positional arguments but %zd were given", nargs);
         return NULL;
     }
 
-    auto pyBorrowed_xData = PySequence_Fast(args[0], EXA_PLOT "() 'x' argument must be type 'Sequence'");
-    if (pyBorrowed_xData == NULL)
+    std::vector<double> xData;
+    std::vector<double> yData;
+    if (!toDoubles(args[0], EXA_PLOT "() 'x' argument must be type 'Sequence'", xData))
         return NULL;
-    auto pyBorrowed_yData = PySequence_Fast(args[1], EXA_PLOT "() 'y' argument must be type 'Sequence'");
-    if (pyBorrowed_yData == NULL)
+    if (!toDoubles(args[1], EXA_PLOT "() 'y' argument must be type 'Sequence'", yData))
         return NULL;
 
-    auto n_xData = PySequence_Fast_GET_SIZE(pyBorrowed_xData);
-    std::vector<double> xData(n_xData);
-    for (decltype(n_xData) i = 0; i < n_xData; ++i) {
-        auto x = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(pyBorrowed_xData, i));
-        if (PyErr_Occurred()) return NULL;
-        xData[i] = x;
+    return state->iface->plot2DVec(plotID, xData, yData, write, sorted);
+}
+
+
+/**
+ * @brief Convert multi-trace 2D data: `(x, y0, y1, ..., yN)`. The x-values (either a single value
+ * or a sequence) are shared by every trace; each y argument must match the form (and length) of x.
+ * Returns `false` (with Python's error indicator set) on failure.
+ * 
+ * @param args 
+ * @param nargs 
+ * @param xData 
+ * @param yData 
+ * @return true 
+ * @return false 
+ */
+static bool
+toMultiTrace(
+    PyObject* const* args,
+    Py_ssize_t nargs,
+    std::vector<double>& xData,
+    std::vector<std::vector<double>>& yData)
+{
+    auto n_traces = nargs - 1;
+    yData.resize(n_traces);
+
+    if (!PySequence_Check(args[0])) {
+        auto x = PyFloat_AsDouble(args[0]);
+        if (PyErr_Occurred()) return false;
+        xData.push_back(x);
+        for (decltype(n_traces) i = 0; i < n_traces; ++i) {
+            auto y = PyFloat_AsDouble(args[i + 1]);
+            if (PyErr_Occurred()) return false;
+            yData[i].push_back(y);
+        }
+        return true;
     }
 
-    auto n_yData = PySequence_Fast_GET_SIZE(pyBorrowed_yData);
-    std::vector<double> yData(n_yData);
-    for (decltype(n_yData) i = 0; i < n_yData; ++i) {
-        auto y = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(pyBorrowed_yData, i));
-        if (PyErr_Occurred()) return NULL;
-        yData[i] = y;
+    if (!toDoubles(args[0], EXA_PLOT "() 'x' argument must be type 'Sequence'", xData))
+        return false;
+
+    for (decltype(n_traces) i = 0; i < n_traces; ++i) {
+        if (!PySequence_Check(args[i + 1])) {
+            PyErr_Format(PyExc_TypeError, EXA_PLOT "() 'y%zd' argument must be type 'Sequence'", i);
+            return false;
+        }
+        if (!toDoubles(args[i + 1], EXA_PLOT "() 'y' argument must be type 'Sequence'", yData[i]))
+            return false;
+        if (yData[i].size() != xData.size()) {
+            PyErr_Format(PyExc_ValueError, EXA_PLOT "() 'y%zd' argument must be the same length as 'x'", i);
+            return false;
+        }
     }
+    return true;
+}
+
 
-    return state->iface->plot2DVec(plotID, xData, yData, write);
+/**
+ * @brief Multi-trace 2D plotting: `plot(x, y0, y1, ..., yN)` (see `toMultiTrace`).
+ * 
+ * @param state 
+ * @param plotID 
+ * @param args 
+ * @param nargs 
+ * @param write 
+ * @return PyObject* 
+ */
+static PyObject*
+plot2DMulti(
+    exa_state* state,
+    std::size_t plotID,
+    PyObject* const* args,
+    Py_ssize_t nargs,
+    bool write,
+    bool sorted)
+{
+    std::vector<double> xData;
+    std::vector<std::vector<double>> yData;
+    if (!toMultiTrace(args, nargs, xData, yData))
+        return NULL;
+    return state->iface->plot2DMulti(plotID, xData, yData, write, sorted);
 }
 
 
@@ -378,7 +794,8 @@ plotCM(
     std::size_t plotID,
     PyObject* const* args,
     Py_ssize_t nargs,
-    bool write)
+    bool write,
+    [[maybe_unused]] bool sorted)
 {
     if (nargs != 3) {
         PyErr_Format(PyExc_TypeError, EXA_PLOT "() takes 3 positional arguments but %zd were given", nargs);
@@ -400,7 +817,8 @@ plotCMVec(
     std::size_t plotID,
     PyObject* const* args,
     Py_ssize_t nargs,
-    bool write)
+    bool write,
+    [[maybe_unused]] bool sorted)
 {
     if (nargs != 2) {
         PyErr_Format(PyExc_TypeError, EXA_PLOT "() takes 2 positional arguments but %zd were given", nargs);
@@ -410,17 +828,10 @@ plotCMVec(
     auto y = PyLong_AsLong(args[0]);
     if (PyErr_Occurred()) return NULL;
 
-    auto pyBorrowed_values = PySequence_Fast(args[1], EXA_PLOT "() 'values' argument must be type 'Sequence'");
-    if (pyBorrowed_values == NULL)
+    // TODO: limit the number of values
+    std::vector<double> values;
+    if (!toDoubles(args[1], EXA_PLOT "() 'values' argument must be type 'Sequence'", values))
         return NULL;
-    auto n_values = PySequence_Fast_GET_SIZE(pyBorrowed_values);
-    // TODO: limit n_values
-    std::vector<double> values(n_values);
-    for (decltype(n_values) i = 0; i < n_values; ++i) {
-        auto value = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(pyBorrowed_values, i));
-        if (PyErr_Occurred()) return NULL;
-        values[i] = value;
-    }
 
     return state->iface->plotCMVec(plotID, y, values, write);
 }
@@ -432,7 +843,8 @@ plotCMFrame(
     std::size_t plotID,
     PyObject* const* args,
     [[maybe_unused]] Py_ssize_t nargs,
-    bool write)
+    bool write,
+    [[maybe_unused]] bool sorted)
 {
     auto pyBorrowed_frame = PySequence_Fast(args[0],
                                             EXA_PLOT "() 'frame' argument must be type 'Sequence[Sequence[Real]]'");
@@ -476,6 +888,103 @@ plotCMFrame(
 }
 
 
+/**
+ * @brief Waterfall color map row: `plot(values)` pushes a row of cell values (replacing the oldest
+ * row of the map).
+ * 
+ * @param state 
+ * @param plotID 
+ * @param args 
+ * @param nargs 
+ * @param write 
+ * @return PyObject* 
+ */
+static PyObject*
+plotCMPush(
+    exa_state* state,
+    std::size_t plotID,
+    PyObject* const* args,
+    [[maybe_unused]] Py_ssize_t nargs,
+    bool write,
+    [[maybe_unused]] bool sorted)
+{
+    std::vector<double> values;
+    if (!toDoubles(args[0], EXA_PLOT "() 'values' argument must be type 'Sequence'", values))
+        return NULL;
+
+    return state->iface->plotCMPush(plotID, values, write);
+}
+
+
+/**
+ * @brief Whether an object is a non-empty sequence of non-sequences (i.e. a single row of values
+ * rather than a frame).
+ * 
+ * @param object 
+ * @return bool 
+ */
+static bool
+isRow(PyObject* object)
+{
+    if (!PySequence_Check(object) || PySequence_Size(object) <= 0) {
+        PyErr_Clear();
+        return false;
+    }
+    auto pyOwned_item = PySequence_GetItem(object, 0);
+    if (pyOwned_item == NULL) {
+        PyErr_Clear();
+        return false;
+    }
+    auto row = !PySequence_Check(pyOwned_item);
+    Py_DECREF(pyOwned_item);
+    return row;
+}
+
+
+/**
+ * @brief Write 2D data to a data-only channel, in any of the forms of 2D plotting (a single point,
+ * sequences of points or multiple traces).
+ * 
+ * @param state 
+ * @param channelID 
+ * @param args 
+ * @param nargs 
+ * @return PyObject* 
+ */
+static PyObject*
+channelWrite(exa_state* state, std::size_t channelID, PyObject* const* args, Py_ssize_t nargs)
+{
+    if (nargs < 2) {
+        PyErr_Format(PyExc_TypeError, EXA_WRITE "() takes at least 2 data arguments but %zd were given", nargs);
+        return NULL;
+    }
+
+    if (nargs > 2) {
+        std::vector<double> xData;
+        std::vector<std::vector<double>> yData;
+        if (!toMultiTrace(args, nargs, xData, yData))
+            return NULL;
+        return state->iface->write2DMulti(channelID, xData, yData);
+    }
+
+    if (PySequence_Check(args[0])) {
+        std::vector<double> xData;
+        std::vector<double> yData;
+        if (!toDoubles(args[0], EXA_WRITE "() 'x' argument must be type 'Sequence'", xData))
+            return NULL;
+        if (!toDoubles(args[1], EXA_WRITE "() 'y' argument must be type 'Sequence'", yData))
+            return NULL;
+        return state->iface->write2DVec(channelID, xData, yData);
+    }
+
+    auto x = PyFloat_AsDouble(args[0]);
+    if (PyErr_Occurred()) return NULL;
+    auto y = PyFloat_AsDouble(args[1]);
+    if (PyErr_Occurred()) return NULL;
+    return state->iface->write2D(channelID, x, y);
+}
+
+
 /**
  * @brief Module `plot` function
  * 
@@ -506,6 +1015,7 @@ exa_plot(PyObject* module, PyObject* const* args, Py_ssize_t nargs, PyObject* kw
     }
 
     bool write = true;
+    bool sorted = false;
     if (kwnames != NULL) {
         auto nkwargs = PyTuple_GET_SIZE(kwnames);
         for (decltype(nkwargs) i = 0; i < nkwargs; ++i) {
@@ -520,6 +1030,12 @@ exa_plot(PyObject* module, PyObject* const* args, Py_ssize_t nargs, PyObject* kw
                     return NULL;
                 }
                 write = pyBorrowed_kwvalue == Py_True;
+            } else if (std::strcmp(kwname, "sorted") == 0) {
+                if (!PyBool_Check(pyBorrowed_kwvalue)) {
+                    PyErr_SetString(PyExc_TypeError, EXA_PLOT "() 'sorted' argument must be type 'bool'");
+                    return NULL;
+                }
+                sorted = pyBorrowed_kwvalue == Py_True;
             } else {
                 PyErr_Format(PyExc_TypeError, EXA_PLOT "() got an unexpected keyword argument '%s'", kwname);
                 return NULL;
@@ -527,30 +1043,148 @@ exa_plot(PyObject* module, PyObject* const* args, Py_ssize_t nargs, PyObject* kw
         }
     }
 
+    // the zeroth data set (AKA the "hidden plot") is the default data-only channel
+    if (plotID == 0) {
+        if (nargs == 1) {
+            Py_RETURN_NONE;
+        }
+        return channelWrite(state, 0, &args[1], nargs - 1);
+    }
+
     if (nargs == 1) {
         return state->iface->clear(plotID);
     }
     nargs -= 1;
 
-    // TODO: The zeroth data set (AKA the "hidden plot")
-    if (plotID == 0) {
-        Py_RETURN_NONE;
-    }
-
-    std::function<PyObject*(exa_state*, std::size_t, PyObject* const*, Py_ssize_t, bool)> plotFn;
+    std::function<PyObject*(exa_state*, std::size_t, PyObject* const*, Py_ssize_t, bool, bool)> plotFn;
     switch (state->iface->currentPlotType(plotID)) {
     case 0: // 2D
-        plotFn = PySequence_Check(args[1]) ? plot2DVec : plot2D;
+        plotFn = nargs > 2 ? plot2DMulti : PySequence_Check(args[1]) ? plot2DVec : plot2D;
         break;
     case 1: // color map
-        plotFn = nargs == 1 ? plotCMFrame : PySequence_Check(args[2]) ? plotCMVec : plotCM;
+        if (sorted) {
+            PyErr_SetString(PyExc_TypeError, EXA_PLOT "() 'sorted' argument is only supported by 2D plots");
+            return NULL;
+        }
+        plotFn = nargs == 1 ? (isRow(args[1]) ? plotCMPush : plotCMFrame) : PySequence_Check(args[2]) ? plotCMVec : plotCM;
         break;
     default:
         PyErr_Format(PyExc_SystemError, "invalid plot type: %zd", state->iface->currentPlotType(plotID));
     case -1:
         return NULL;
     }
-    return plotFn(state, plotID, &args[1], nargs, write);
+    return plotFn(state, plotID, &args[1], nargs, write, sorted);
+}
+
+
+/**
+ * @brief Convert a Python value to the value of a plot property (with the property's type and
+ * range checks). Returns `false` (with Python's error indicator set) on failure.
+ * 
+ * @param pyBorrowed_value 
+ * @param prop 
+ * @param value 
+ * @return true 
+ * @return false 
+ */
+static bool
+pyToPropertyValue(PyObject* pyBorrowed_value, const PlotProperty& prop, PlotProperty::Value& value)
+{
+    switch (prop) {
+
+    // 'str' types
+    case PlotProperty::TITLE:
+    case PlotProperty::XAXIS:
+    case PlotProperty::YAXIS:
+    case PlotProperty::TWODIMEN_LINE_TYPE:
+    case PlotProperty::TWODIMEN_LINE_COLOR:
+    case PlotProperty::TWODIMEN_LINE_STYLE:
+    case PlotProperty::TWODIMEN_POINTS_SHAPE:
+    case PlotProperty::TWODIMEN_POINTS_COLOR:
+    case PlotProperty::TWODIMEN_STORAGE:
+    case PlotProperty::COLORMAP_COLOR_MIN:
+    case PlotProperty::COLORMAP_COLOR_MAX:
+        if (!PyUnicode_Check(pyBorrowed_value)) {
+            PyErr_Format(PyExc_TypeError, "%s must be type 'str'", prop.c_str());
+            return false;
+        }
+        {
+            auto c_value = PyUnicode_AsUTF8(pyBorrowed_value);
+            if (c_value == NULL) return false;
+            value = std::string{c_value};
+        }
+        break;
+
+    // 'int' types
+    case PlotProperty::MINSIZE_W:
+    case PlotProperty::MINSIZE_H:
+    case PlotProperty::COLORMAP_DATASIZE_X:
+    case PlotProperty::COLORMAP_DATASIZE_Y:
+        if (!PyLong_Check(pyBorrowed_value)) {
+            PyErr_Format(PyExc_TypeError, "%s must be type 'int'", prop.c_str());
+            return false;
+        }
+        {
+            auto long_value = PyLong_AsLong(pyBorrowed_value);
+            if (long_value <= 0) {
+                if (!PyErr_Occurred())
+                    PyErr_Format(PyExc_ValueError, "%s must be greater than zero", prop.c_str());
+                return false;
+            }
+            if (long_value > std::numeric_limits<int>::max()) {
+                PyErr_Format(PyExc_OverflowError,
+                             "Value must not exceed %d", std::numeric_limits<int>::max());
+                return false;
+            }
+            value = static_cast<int>(long_value);
+        }
+        break;
+
+    // 'numbers.Real' types
+    case PlotProperty::TWODIMEN_XRANGE_MIN:
+    case PlotProperty::TWODIMEN_XRANGE_MAX:
+    case PlotProperty::TWODIMEN_YRANGE_MIN:
+    case PlotProperty::TWODIMEN_YRANGE_MAX:
+    case PlotProperty::TWODIMEN_POINTS_SIZE:
+    case PlotProperty::COLORMAP_XRANGE_MIN:
+    case PlotProperty::COLORMAP_XRANGE_MAX:
+    case PlotProperty::COLORMAP_YRANGE_MIN:
+    case PlotProperty::COLORMAP_YRANGE_MAX:
+    case PlotProperty::COLORMAP_ZRANGE_MIN:
+    case PlotProperty::COLORMAP_ZRANGE_MAX:
+        if (!PyFloat_Check(pyBorrowed_value) && !PyLong_Check(pyBorrowed_value)) {
+            PyErr_Format(PyExc_TypeError, "%s must be type 'numbers.Real'", prop.c_str());
+            return false;
+        }
+        {
+            auto double_value = PyFloat_AsDouble(pyBorrowed_value);
+            if (PyErr_Occurred())
+                return false;
+            if (prop == PlotProperty::TWODIMEN_POINTS_SIZE && double_value < 0.) {
+                PyErr_Format(PyExc_ValueError, "%s must be positive", prop.c_str());
+                return false;
+            }
+            value = double_value;
+        }
+        break;
+
+    // 'bool' types
+    case PlotProperty::TWODIMEN_AUTORS_AXES:
+    case PlotProperty::COLORMAP_AUTORS_AXES:
+    case PlotProperty::COLORMAP_AUTORS_DATA:
+    case PlotProperty::COLORMAP_WATERFALL:
+        if (!PyBool_Check(pyBorrowed_value)) {
+            PyErr_Format(PyExc_TypeError, "%s must be type 'bool'", prop.c_str());
+            return false;
+        }
+        value = pyBorrowed_value == Py_True;
+        break;
+
+    default:
+        PyErr_Format(PyExc_KeyError, "Invalid property '%s'", prop.c_str());
+        return false;
+    }
+    return true;
 }
 
 
@@ -583,100 +1217,8 @@ exa__set_plot_property(PyObject* module, PyObject* args)
     try {
         PlotProperty prop{c_prop};
         PlotProperty::Value value;
-
-        switch (prop) {
-
-        // 'str' types
-        case PlotProperty::TITLE:
-        case PlotProperty::XAXIS:
-        case PlotProperty::YAXIS:
-        case PlotProperty::TWODIMEN_LINE_TYPE:
-        case PlotProperty::TWODIMEN_LINE_COLOR:
-        case PlotProperty::TWODIMEN_LINE_STYLE:
-        case PlotProperty::TWODIMEN_POINTS_SHAPE:
-        case PlotProperty::TWODIMEN_POINTS_COLOR:
-        case PlotProperty::COLORMAP_COLOR_MIN:
-        case PlotProperty::COLORMAP_COLOR_MAX:
-            if (!PyUnicode_Check(pyBorrowed_value)) {
-                PyErr_Format(PyExc_TypeError, "%s must be type 'str'", c_prop);
-                return NULL;
-            }
-            {
-                auto c_value = PyUnicode_AsUTF8(pyBorrowed_value);
-                if (c_value == NULL) return NULL;
-                value = std::string{c_value};
-            }
-            break;
-
-        // 'int' types
-        case PlotProperty::MINSIZE_W:
-        case PlotProperty::MINSIZE_H:
-        case PlotProperty::COLORMAP_DATASIZE_X:
-        case PlotProperty::COLORMAP_DATASIZE_Y:
-            if (!PyLong_Check(pyBorrowed_value)) {
-                PyErr_Format(PyExc_TypeError, "%s must be type 'int'", c_prop);
-                return NULL;
-            }
-            {
-                auto long_value = PyLong_AsLong(pyBorrowed_value);
-                if (long_value <= 0) {
-                    if (!PyErr_Occurred())
-                        PyErr_Format(PyExc_ValueError, "%s must be greater than zero", c_prop);
-                    return NULL;
-                }
-                if (long_value > std::numeric_limits<int>::max()) {
-                    PyErr_Format(PyExc_OverflowError,
-                                 "Value must not exceed %d", std::numeric_limits<int>::max());
-                    return NULL;
-                }
-                value = static_cast<int>(long_value);
-            }
-            break;
-
-        // 'numbers.Real' types
-        case PlotProperty::TWODIMEN_XRANGE_MIN:
-        case PlotProperty::TWODIMEN_XRANGE_MAX:
-        case PlotProperty::TWODIMEN_YRANGE_MIN:
-        case PlotProperty::TWODIMEN_YRANGE_MAX:
-        case PlotProperty::TWODIMEN_POINTS_SIZE:
-        case PlotProperty::COLORMAP_XRANGE_MIN:
-        case PlotProperty::COLORMAP_XRANGE_MAX:
-        case PlotProperty::COLORMAP_YRANGE_MIN:
-        case PlotProperty::COLORMAP_YRANGE_MAX:
-        case PlotProperty::COLORMAP_ZRANGE_MIN:
-        case PlotProperty::COLORMAP_ZRANGE_MAX:
-            if (!PyFloat_Check(pyBorrowed_value) && !PyLong_Check(pyBorrowed_value)) {
-                PyErr_Format(PyExc_TypeError, "%s must be type 'numbers.Real'", c_prop);
-                return NULL;
-            }
-            {
-                auto double_value = PyFloat_AsDouble(pyBorrowed_value);
-                if (PyErr_Occurred())
-                    return NULL;
-                if (prop == PlotProperty::TWODIMEN_POINTS_SIZE && double_value < 0.) {
-                    PyErr_Format(PyExc_ValueError, "%s must be positive", c_prop);
-                    return NULL;
-                }
-                value = double_value;
-            }
-            break;
-
-        // 'bool' types
-        case PlotProperty::TWODIMEN_AUTORS_AXES:
-        case PlotProperty::COLORMAP_AUTORS_AXES:
-        case PlotProperty::COLORMAP_AUTORS_DATA:
-            if (!PyBool_Check(pyBorrowed_value)) {
-                PyErr_Format(PyExc_TypeError, "%s must be type 'bool'", c_prop);
-                return NULL;
-            }
-            value = pyBorrowed_value == Py_True;
-            break;
-
-        default:
-            PyErr_Format(PyExc_KeyError, "Invalid property '%s'", c_prop);
+        if (!pyToPropertyValue(pyBorrowed_value, prop, value))
             return NULL;
-        }
-
         return state->iface->setPlotProperty(plotID, prop, value);
     } catch (const std::out_of_range&)
     {
@@ -749,6 +1291,452 @@ exa__show_plot(PyObject* module, PyObject* args)
 }
 
 
+/**
+ * @brief Module `_begin_plot_edit` function. Property changes made to the plot until the matching
+ * `_end_plot_edit` call are accumulated and applied together (edits can be nested).
+ * 
+ * @param module 
+ * @param args 
+ * @return PyObject* 
+ */
+PyObject*
+exa__begin_plot_edit(PyObject* module, PyObject* args)
+{
+    exa_state* state = getModuleState(module);
+
+    long plotID = 0;
+
+    if (!PyArg_ParseTuple(args, "l", &plotID)) {
+        return NULL;
+    }
+    if (plotID <= 0) {
+        PyErr_SetString(PyExc_ValueError, "plot_id must be greater than zero");
+        return NULL;
+    }
+    return state->iface->beginPlotEdit(plotID);
+}
+
+
+/**
+ * @brief Module `_end_plot_edit` function
+ * 
+ * @param module 
+ * @param args 
+ * @return PyObject* 
+ */
+PyObject*
+exa__end_plot_edit(PyObject* module, PyObject* args)
+{
+    exa_state* state = getModuleState(module);
+
+    long plotID = 0;
+
+    if (!PyArg_ParseTuple(args, "l", &plotID)) {
+        return NULL;
+    }
+    if (plotID <= 0) {
+        PyErr_SetString(PyExc_ValueError, "plot_id must be greater than zero");
+        return NULL;
+    }
+    return state->iface->endPlotEdit(plotID);
+}
+
+
+static char*
+stream_keywords[] = {
+    (char*)"plot_id",
+    (char*)"y",
+    (char*)"x0",
+    (char*)"dx",
+    (char*)"write",
+    NULL
+};
+
+
+/**
+ * @brief Module `_stream` function: uniformly sampled 2D data (`x[i] = x0 + i * dx`), where only
+ * the y-values cross the module boundary.
+ * 
+ * @param module 
+ * @param args 
+ * @param kwargs 
+ * @return PyObject* 
+ */
+PyObject*
+exa__stream(PyObject* module, PyObject* args, PyObject* kwargs)
+{
+    exa_state* state = getModuleState(module);
+
+    long plotID = 0;
+    PyObject* pyBorrowed_yData = NULL;
+    double x0 = 0.0;
+    double dx = 1.0;
+    int c_write = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "lO|dd$p:" EXA_STREAM, stream_keywords,
+                                     &plotID, &pyBorrowed_yData, &x0, &dx, &c_write)) {
+        return NULL;
+    }
+    if (plotID <= 0) {
+        PyErr_SetString(PyExc_ValueError, "plot_id must be greater than zero");
+        return NULL;
+    }
+    if (!std::isfinite(x0)) {
+        PyErr_SetString(PyExc_ValueError, EXA_STREAM "() 'x0' argument must be finite");
+        return NULL;
+    }
+    if (!std::isfinite(dx) || dx <= 0.0) {
+        PyErr_SetString(PyExc_ValueError, EXA_STREAM "() 'dx' argument must be greater than zero");
+        return NULL;
+    }
+
+    switch (state->iface->currentPlotType(plotID)) {
+    case 0: // 2D
+        break;
+    case -1:
+        return NULL;
+    default:
+        PyErr_SetString(PyExc_TypeError, EXA_STREAM "() requires a 2D plot");
+        return NULL;
+    }
+
+    std::vector<double> yData;
+    if (!toDoubles(pyBorrowed_yData, EXA_STREAM "() 'y' argument must be type 'Sequence'", yData))
+        return NULL;
+
+    return state->iface->plot2DStream(static_cast<std::size_t>(plotID), yData, x0, dx, c_write != 0);
+}
+
+
+/**
+ * @brief Whether a name can be used as-is for the datasets (or groups) of the data file: letters,
+ * digits, '_' and '-' only.
+ * 
+ * @param name 
+ * @return true 
+ * @return false 
+ */
+static bool
+isDataName(std::string_view name)
+{
+    for (auto c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-')
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Module `_channel` function: get (creating it on first use) the ID of a named data-only
+ * channel. Data written to a channel goes to the data file only (there's no plot to display it).
+ * 
+ * @param module 
+ * @param args 
+ * @return PyObject* 
+ */
+PyObject*
+exa__channel(PyObject* module, PyObject* args)
+{
+    exa_state* state = getModuleState(module);
+
+    const char* name = NULL;
+    Py_ssize_t length = 0;
+
+    if (!PyArg_ParseTuple(args, "s#:" EXA_CHANNEL, &name, &length)) {
+        return NULL;
+    }
+    if (length == 0) {
+        PyErr_SetString(PyExc_ValueError, EXA_CHANNEL "() 'name' argument must not be empty");
+        return NULL;
+    }
+    std::string_view view{name, static_cast<std::size_t>(length)};
+    if (!isDataName(view)) {
+        PyErr_SetString(PyExc_ValueError,
+                        EXA_CHANNEL "() 'name' argument may only contain letters, digits, '_' and '-'");
+        return NULL;
+    }
+    if (view.substr(0, 7) == "dataset") {
+        PyErr_SetString(PyExc_ValueError, EXA_CHANNEL "() channel names starting with 'dataset' are reserved");
+        return NULL;
+    }
+    return state->iface->channel(std::string{view});
+}
+
+
+/**
+ * @brief Module `_write` function: write 2D data to a data-only channel (channel 0 being the
+ * "hidden plot", i.e. `plot(0, ...)`).
+ * 
+ * @param module 
+ * @param args 
+ * @param nargs 
+ * @return PyObject* 
+ */
+PyObject*
+exa__write(PyObject* module, PyObject* const* args, Py_ssize_t nargs)
+{
+    exa_state* state = getModuleState(module);
+
+    if (nargs == 0) {
+        PyErr_SetString(PyExc_TypeError, EXA_WRITE "() missing 1 required positional argument: 'channel_id'");
+        return NULL;
+    }
+    if (!PyLong_Check(args[0])) {
+        PyErr_SetString(PyExc_TypeError, EXA_WRITE "() 'channel_id' argument must be type 'int'");
+        return NULL;
+    }
+    auto channelID = PyLong_AsSize_t(args[0]);
+    if (channelID == (size_t)-1 && PyErr_Occurred()) {
+        return NULL;
+    }
+    return channelWrite(state, channelID, &args[1], nargs - 1);
+}
+
+
+static char*
+write_stream_keywords[] = {
+    (char*)"channel_id",
+    (char*)"y",
+    (char*)"x0",
+    (char*)"dx",
+    NULL
+};
+
+
+/**
+ * @brief Module `_write_stream` function: uniformly sampled 2D data (see `_stream`) written to a
+ * data-only channel.
+ * 
+ * @param module 
+ * @param args 
+ * @param kwargs 
+ * @return PyObject* 
+ */
+PyObject*
+exa__write_stream(PyObject* module, PyObject* args, PyObject* kwargs)
+{
+    exa_state* state = getModuleState(module);
+
+    long channelID = 0;
+    PyObject* pyBorrowed_yData = NULL;
+    double x0 = 0.0;
+    double dx = 1.0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "lO|dd:" EXA_WRITE_STREAM, write_stream_keywords,
+                                     &channelID, &pyBorrowed_yData, &x0, &dx)) {
+        return NULL;
+    }
+    if (channelID < 0) {
+        PyErr_SetString(PyExc_ValueError, "channel_id must not be negative");
+        return NULL;
+    }
+    if (!std::isfinite(x0)) {
+        PyErr_SetString(PyExc_ValueError, EXA_WRITE_STREAM "() 'x0' argument must be finite");
+        return NULL;
+    }
+    if (!std::isfinite(dx) || dx <= 0.0) {
+        PyErr_SetString(PyExc_ValueError, EXA_WRITE_STREAM "() 'dx' argument must be greater than zero");
+        return NULL;
+    }
+
+    std::vector<double> yData;
+    if (!toDoubles(pyBorrowed_yData, EXA_WRITE_STREAM "() 'y' argument must be type 'Sequence'", yData))
+        return NULL;
+    return state->iface->write2DStream(static_cast<std::size_t>(channelID), yData, x0, dx);
+}
+
+
+/**
+ * @brief Append a Python value to the values of a record column (of the column's type). Returns
+ * `false` (with Python's error indicator set) on failure.
+ * 
+ * @param function 
+ * @param column 
+ * @param pyBorrowed_value 
+ * @return true 
+ * @return false 
+ */
+static bool
+appendColumnValue(const char* function, RecordColumn& column, PyObject* pyBorrowed_value)
+{
+    switch (column.values.index()) {
+    case ColumnType::FLOAT: {
+        auto value = PyFloat_AsDouble(pyBorrowed_value);
+        if (value == -1.0 && PyErr_Occurred()) return false;
+        std::get<ColumnType::FLOAT>(column.values).push_back(value);
+        break;
+    }
+    case ColumnType::INT: {
+        auto value = PyLong_AsLongLong(pyBorrowed_value);
+        if (value == -1 && PyErr_Occurred()) return false;
+        std::get<ColumnType::INT>(column.values).push_back(value);
+        break;
+    }
+    case ColumnType::BOOL:
+        if (!PyBool_Check(pyBorrowed_value)) {
+            PyErr_Format(PyExc_TypeError, "%s() column '%s' values must be type 'bool'", function, column.name.c_str());
+            return false;
+        }
+        std::get<ColumnType::BOOL>(column.values).push_back(pyBorrowed_value == Py_True);
+        break;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Convert the columns of a record (keyword arguments) for `record` (one value per column)
+ * or `record_many` (a sequence of values per column, all of the same length). The type of each
+ * column is that of its values: 'bool', 'int' (if all of them are ints) or otherwise 'float'.
+ * Returns the number of rows, or -1 (with Python's error indicator set) on failure.
+ * 
+ * @param function 
+ * @param pyBorrowed_columns 
+ * @param many 
+ * @param columns 
+ * @return Py_ssize_t 
+ */
+static Py_ssize_t
+toRecordColumns(const char* function, PyObject* pyBorrowed_columns, bool many, std::vector<RecordColumn>& columns)
+{
+    if (pyBorrowed_columns == NULL || PyDict_GET_SIZE(pyBorrowed_columns) == 0) {
+        PyErr_Format(PyExc_TypeError, "%s() requires at least one column", function);
+        return -1;
+    }
+
+    Py_ssize_t rows = many ? -1 : 1;
+    Py_ssize_t pos = 0;
+    PyObject* pyBorrowed_key = NULL;
+    PyObject* pyBorrowed_value = NULL;
+    while (PyDict_Next(pyBorrowed_columns, &pos, &pyBorrowed_key, &pyBorrowed_value)) {
+        Py_ssize_t length = 0;
+        auto name = PyUnicode_AsUTF8AndSize(pyBorrowed_key, &length);
+        if (name == NULL) return -1;
+        std::string_view view{name, static_cast<std::size_t>(length)};
+        if (!isDataName(view)) {
+            PyErr_Format(PyExc_ValueError,
+                         "%s() column names may only contain letters, digits, '_' and '-' ('%s')", function, name);
+            return -1;
+        }
+        auto& column = columns.emplace_back(RecordColumn{std::string{view}, {}});
+
+        PyObject* pyOwned_values = NULL;
+        if (many) {
+            pyOwned_values = PySequence_Fast(pyBorrowed_value, EXA_RECORD_MANY "() column values must be type 'Sequence'");
+            if (pyOwned_values == NULL)
+                return -1;
+            auto n_values = PySequence_Fast_GET_SIZE(pyOwned_values);
+            if (rows == -1) {
+                rows = n_values;
+            } else if (n_values != rows) {
+                Py_DECREF(pyOwned_values);
+                PyErr_Format(PyExc_ValueError, "%s() columns must be the same length", function);
+                return -1;
+            }
+            if (n_values == 0) {
+                Py_DECREF(pyOwned_values);
+                continue;
+            }
+            pyBorrowed_value = PySequence_Fast_GET_ITEM(pyOwned_values, 0);
+        }
+
+        if (PyBool_Check(pyBorrowed_value))
+            column.values.emplace<ColumnType::BOOL>();
+        else if (PyLong_Check(pyBorrowed_value))
+            column.values.emplace<ColumnType::INT>();
+
+        if (!many) {
+            if (!appendColumnValue(function, column, pyBorrowed_value))
+                return -1;
+            continue;
+        }
+        auto n_values = PySequence_Fast_GET_SIZE(pyOwned_values);
+        // a sequence of ints mixed with other numbers is a float column
+        if (column.values.index() == ColumnType::INT) {
+            for (decltype(n_values) i = 1; i < n_values; ++i) {
+                auto pyBorrowed_item = PySequence_Fast_GET_ITEM(pyOwned_values, i);
+                if (!PyLong_Check(pyBorrowed_item) || PyBool_Check(pyBorrowed_item)) {
+                    column.values.emplace<ColumnType::FLOAT>();
+                    break;
+                }
+            }
+        }
+        for (decltype(n_values) i = 0; i < n_values; ++i) {
+            if (!appendColumnValue(function, column, PySequence_Fast_GET_ITEM(pyOwned_values, i))) {
+                Py_DECREF(pyOwned_values);
+                return -1;
+            }
+        }
+        Py_DECREF(pyOwned_values);
+    }
+    return rows;
+}
+
+
+static PyObject*
+record(PyObject* module, PyObject* args, PyObject* kwargs, bool many)
+{
+    exa_state* state = getModuleState(module);
+    auto function = many ? EXA_RECORD_MANY : EXA_RECORD;
+
+    const char* table = NULL;
+    Py_ssize_t length = 0;
+
+    if (!PyArg_ParseTuple(args, many ? "s#:" EXA_RECORD_MANY : "s#:" EXA_RECORD, &table, &length)) {
+        return NULL;
+    }
+    std::string_view view{table, static_cast<std::size_t>(length)};
+    if (view.empty() || !isDataName(view)) {
+        PyErr_Format(PyExc_ValueError,
+                     "%s() 'table' argument must be a non-empty name of letters, digits, '_' and '-'", function);
+        return NULL;
+    }
+
+    std::vector<RecordColumn> columns;
+    auto rows = toRecordColumns(function, kwargs, many, columns);
+    if (rows < 0)
+        return NULL;
+    if (rows == 0) {
+        Py_RETURN_NONE;
+    }
+    return state->iface->record(std::string{view}, columns);
+}
+
+
+/**
+ * @brief Module `record` function: append a row to a table of the data file, e.g.
+ * `record("log", time=t, temperature=21.5, ok=True)`. A table's columns (and their types) are set
+ * by its first record of the run.
+ * 
+ * @param module 
+ * @param args 
+ * @param kwargs 
+ * @return PyObject* 
+ */
+PyObject*
+exa_record(PyObject* module, PyObject* args, PyObject* kwargs)
+{
+    return record(module, args, kwargs, false);
+}
+
+
+/**
+ * @brief Module `record_many` function: append rows to a table of the data file (a sequence of
+ * values per column).
+ * 
+ * @param module 
+ * @param args 
+ * @param kwargs 
+ * @return PyObject* 
+ */
+PyObject*
+exa_record_many(PyObject* module, PyObject* args, PyObject* kwargs)
+{
+    return record(module, args, kwargs, true);
+}
+
+
 /**
  * RunParam implementation
  */
@@ -891,6 +1879,530 @@ PyRunParam_spec =
  */
 
 
+/**
+ * PlotProperties implementation
+ */
+
+
+static constexpr PlotPropertyNode
+minSizeProperties[] =
+{
+    {.name = "w", .path = "min_size.w", .type = PROPERTY_VALUE, .property = PlotProperty::MINSIZE_W},
+    {.name = "h", .path = "min_size.h", .type = PROPERTY_VALUE, .property = PlotProperty::MINSIZE_H},
+};
+
+
+static constexpr PlotPropertyNode
+twoDimenXRangeProperties[] =
+{
+    {.name = "min", .path = "two_dimen.x_range.min", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_XRANGE_MIN},
+    {.name = "max", .path = "two_dimen.x_range.max", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_XRANGE_MAX},
+};
+
+
+static constexpr PlotPropertyNode
+twoDimenYRangeProperties[] =
+{
+    {.name = "min", .path = "two_dimen.y_range.min", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_YRANGE_MIN},
+    {.name = "max", .path = "two_dimen.y_range.max", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_YRANGE_MAX},
+};
+
+
+static constexpr PlotPropertyNode
+twoDimenLineProperties[] =
+{
+    {.name = "type", .path = "two_dimen.line.type", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_LINE_TYPE},
+    {.name = "color", .path = "two_dimen.line.color", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_LINE_COLOR},
+    {.name = "style", .path = "two_dimen.line.style", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_LINE_STYLE},
+};
+
+
+static constexpr PlotPropertyNode
+twoDimenPointsProperties[] =
+{
+    {.name = "shape", .path = "two_dimen.points.shape", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_POINTS_SHAPE},
+    {.name = "color", .path = "two_dimen.points.color", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_POINTS_COLOR},
+    {.name = "size", .path = "two_dimen.points.size", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_POINTS_SIZE},
+};
+
+
+static constexpr PlotPropertyNode
+colorMapXRangeProperties[] =
+{
+    {.name = "min", .path = "color_map.x_range.min", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_XRANGE_MIN},
+    {.name = "max", .path = "color_map.x_range.max", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_XRANGE_MAX},
+};
+
+
+static constexpr PlotPropertyNode
+colorMapYRangeProperties[] =
+{
+    {.name = "min", .path = "color_map.y_range.min", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_YRANGE_MIN},
+    {.name = "max", .path = "color_map.y_range.max", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_YRANGE_MAX},
+};
+
+
+static constexpr PlotPropertyNode
+colorMapZRangeProperties[] =
+{
+    {.name = "min", .path = "color_map.z_range.min", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_ZRANGE_MIN},
+    {.name = "max", .path = "color_map.z_range.max", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_ZRANGE_MAX},
+};
+
+
+static constexpr PlotPropertyNode
+colorMapDataSizeProperties[] =
+{
+    {.name = "x", .path = "color_map.data_size.x", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_DATASIZE_X},
+    {.name = "y", .path = "color_map.data_size.y", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_DATASIZE_Y},
+};
+
+
+static constexpr PlotPropertyNode
+colorMapColorProperties[] =
+{
+    {.name = "min", .path = "color_map.color.min", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_COLOR_MIN},
+    {.name = "max", .path = "color_map.color.max", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_COLOR_MAX},
+};
+
+
+#define PROPERTY_GROUP_NODE(NAME, PATH, CHILDREN, TUPLE_TYPE) \
+{ \
+    .name = NAME, \
+    .path = PATH, \
+    .type = PROPERTY_GROUP, \
+    .property = PlotProperty::MINSIZE, \
+    .children = CHILDREN, \
+    .childCount = std::size(CHILDREN), \
+    .tupleType = TUPLE_TYPE, \
+}
+
+
+static constexpr PlotPropertyNode
+twoDimenProperties[] =
+{
+    PROPERTY_GROUP_NODE("x_range", "two_dimen.x_range", twoDimenXRangeProperties, "tuple[int, int]"),
+    PROPERTY_GROUP_NODE("y_range", "two_dimen.y_range", twoDimenYRangeProperties, "tuple[int, int]"),
+    PROPERTY_GROUP_NODE("line", "two_dimen.line", twoDimenLineProperties, "tuple[str, str, str]"),
+    PROPERTY_GROUP_NODE("points", "two_dimen.points", twoDimenPointsProperties, "tuple[str, str, float]"),
+    {.name = "autorescale_axes", .path = "two_dimen.autorescale_axes", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_AUTORS_AXES},
+    {.name = "storage", .path = "two_dimen.storage", .type = PROPERTY_VALUE, .property = PlotProperty::TWODIMEN_STORAGE},
+};
+
+
+static constexpr PlotPropertyNode
+colorMapProperties[] =
+{
+    PROPERTY_GROUP_NODE("x_range", "color_map.x_range", colorMapXRangeProperties, "tuple[int, int]"),
+    PROPERTY_GROUP_NODE("y_range", "color_map.y_range", colorMapYRangeProperties, "tuple[int, int]"),
+    PROPERTY_GROUP_NODE("z_range", "color_map.z_range", colorMapZRangeProperties, "tuple[int, int]"),
+    PROPERTY_GROUP_NODE("data_size", "color_map.data_size", colorMapDataSizeProperties, "tuple[int, int]"),
+    PROPERTY_GROUP_NODE("color", "color_map.color", colorMapColorProperties, "tuple[str, str]"),
+    {.name = "autorescale_axes", .path = "color_map.autorescale_axes", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_AUTORS_AXES},
+    {.name = "autorescale_data", .path = "color_map.autorescale_data", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_AUTORS_DATA},
+    {.name = "waterfall", .path = "color_map.waterfall", .type = PROPERTY_VALUE, .property = PlotProperty::COLORMAP_WATERFALL},
+};
+
+
+static constexpr PlotPropertyNode
+plotProperties[] =
+{
+    {.name = "title", .path = "title", .type = PROPERTY_VALUE, .property = PlotProperty::TITLE},
+    {.name = "x_axis", .path = "x_axis", .type = PROPERTY_VALUE, .property = PlotProperty::XAXIS},
+    {.name = "y_axis", .path = "y_axis", .type = PROPERTY_VALUE, .property = PlotProperty::YAXIS},
+    PROPERTY_GROUP_NODE("min_size", "min_size", minSizeProperties, "tuple[int, int]"),
+    {
+        .name = "two_dimen",
+        .path = "two_dimen",
+        .type = PROPERTY_TAB,
+        .property = PlotProperty::TITLE,
+        .children = twoDimenProperties,
+        .childCount = std::size(twoDimenProperties),
+        .tupleType = NULL,
+        .plotType = 0,
+    },
+    {
+        .name = "color_map",
+        .path = "color_map",
+        .type = PROPERTY_TAB,
+        .property = PlotProperty::TITLE,
+        .children = colorMapProperties,
+        .childCount = std::size(colorMapProperties),
+        .tupleType = NULL,
+        .plotType = 1,
+    },
+};
+
+
+#undef PROPERTY_GROUP_NODE
+
+
+static constexpr PlotPropertyNode
+plotPropertiesRoot =
+{
+    .name = "",
+    .path = "",
+    .type = PROPERTY_PLOT,
+    .property = PlotProperty::TITLE,
+    .children = plotProperties,
+    .childCount = std::size(plotProperties),
+};
+
+
+static_assert(std::size(plotProperties) <= EXA_PROPERTY_CHILDREN_MAX);
+static_assert(std::size(twoDimenProperties) <= EXA_PROPERTY_CHILDREN_MAX);
+static_assert(std::size(colorMapProperties) <= EXA_PROPERTY_CHILDREN_MAX);
+
+
+static char*
+PlotProperties_keywords[] =
+{
+    (char*)"plot_id",
+    NULL
+};
+
+
+/**
+ * @brief `_PlotProperties.__new__`: the properties of a plot
+ * 
+ * @param type 
+ * @param args 
+ * @param kwargs 
+ * @return PyObject* 
+ */
+static PyObject*
+PyPlotProperties_new(PyTypeObject* type, PyObject* args, PyObject* kwargs)
+{
+    long plotID = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l:" EXA_PROPERTIES, PlotProperties_keywords, &plotID)) {
+        return NULL;
+    }
+
+    // looked up once (the object keeps its type, and with it the module, alive)
+    auto mState = getModuleStateFromType(type);
+    if (mState == NULL) {
+        PyErr_SetString(PyExc_SystemError, "plot properties have no module state");
+        return NULL;
+    }
+
+    auto self = reinterpret_cast<PyPlotProperties*>(type->tp_alloc(type, 0));
+    if (self == NULL) return NULL;
+    self->plotID = plotID;
+    self->node = &plotPropertiesRoot;
+    self->mState = mState;
+    return reinterpret_cast<PyObject*>(self);
+}
+
+
+/**
+ * @brief Index of the child property with the given name, or -1 if there is none.
+ * 
+ * @param self 
+ * @param name 
+ * @return Py_ssize_t 
+ */
+static Py_ssize_t
+PyPlotProperties_childIndex(PyPlotProperties* self, PyObject* name)
+{
+    if (!PyUnicode_Check(name))
+        return -1;
+    Py_ssize_t size = 0;
+    auto c_name = PyUnicode_AsUTF8AndSize(name, &size);
+    if (c_name == NULL) {
+        PyErr_Clear();
+        return -1;
+    }
+
+    std::string_view view{c_name, static_cast<std::size_t>(size)};
+    for (std::size_t i = 0; i < self->node->childCount; ++i)
+        if (view == self->node->children[i].name)
+            return static_cast<Py_ssize_t>(i);
+    return -1;
+}
+
+
+static bool
+PyPlotProperties_checkPlotID(PyPlotProperties* self)
+{
+    if (self->plotID <= 0) {
+        PyErr_SetString(PyExc_ValueError, "plot_id must be greater than zero");
+        return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief The (cached) object of a child property group.
+ * 
+ * @param self 
+ * @param index 
+ * @return PyObject* 
+ */
+static PyObject*
+PyPlotProperties_child(PyPlotProperties* self, Py_ssize_t index)
+{
+    if (self->children[index] == NULL) {
+        auto type = self->mState->type_PlotProperties;
+        auto child = reinterpret_cast<PyPlotProperties*>(type->tp_alloc(type, 0));
+        if (child == NULL) return NULL;
+        child->plotID = self->plotID;
+        child->node = &self->node->children[index];
+        child->mState = self->mState;
+        self->children[index] = reinterpret_cast<PyObject*>(child);
+    }
+    return Py_NewRef(self->children[index]);
+}
+
+
+static PyObject*
+PyPlotProperties_getValue(exa_state* mState, long plotID, const PlotPropertyNode& node)
+{
+    return mState->iface->getPlotProperty(plotID, PlotProperty{node.property});
+}
+
+
+static int
+PyPlotProperties_setValue(exa_state* mState, long plotID, const PlotPropertyNode& node, PyObject* pyBorrowed_value)
+{
+    PlotProperty prop{node.property};
+    PlotProperty::Value value;
+    if (!pyToPropertyValue(pyBorrowed_value, prop, value))
+        return -1;
+
+    auto pyOwned_result = mState->iface->setPlotProperty(plotID, prop, value);
+    if (pyOwned_result == NULL)
+        return -1;
+    Py_DECREF(pyOwned_result);
+    return 0;
+}
+
+
+/**
+ * @brief Set the properties of a group from a tuple (as a single plot edit).
+ * 
+ * @param mState 
+ * @param plotID 
+ * @param node 
+ * @param pyBorrowed_value 
+ * @return int 
+ */
+static int
+PyPlotProperties_setGroup(exa_state* mState, long plotID, const PlotPropertyNode& node, PyObject* pyBorrowed_value)
+{
+    if (!PyTuple_Check(pyBorrowed_value)
+        || static_cast<std::size_t>(PyTuple_GET_SIZE(pyBorrowed_value)) != node.childCount) {
+        PyErr_Format(PyExc_TypeError, "%s value must be type '%s'", node.path, node.tupleType);
+        return -1;
+    }
+
+    auto pyOwned_result = mState->iface->beginPlotEdit(plotID);
+    if (pyOwned_result == NULL)
+        return -1;
+    Py_DECREF(pyOwned_result);
+
+    int status = 0;
+    for (std::size_t i = 0; i < node.childCount; ++i) {
+        status = PyPlotProperties_setValue(mState, plotID, node.children[i], PyTuple_GET_ITEM(pyBorrowed_value, i));
+        if (status < 0) break;
+    }
+
+    // the edit is ended regardless, keeping the first error
+    auto pyOwned_exception = status < 0 ? PyErr_GetRaisedException() : NULL;
+    pyOwned_result = mState->iface->endPlotEdit(plotID);
+    if (pyOwned_exception != NULL) {
+        if (pyOwned_result == NULL)
+            PyErr_Clear();
+        Py_XDECREF(pyOwned_result);
+        PyErr_SetRaisedException(pyOwned_exception);
+        return -1;
+    }
+    if (pyOwned_result == NULL)
+        return -1;
+    Py_DECREF(pyOwned_result);
+    return 0;
+}
+
+
+static PyObject*
+PyPlotProperties_getattro(PyPlotProperties* self, PyObject* name)
+{
+    auto index = PyPlotProperties_childIndex(self, name);
+    if (index < 0)
+        return PyObject_GenericGetAttr(reinterpret_cast<PyObject*>(self), name);
+
+    const auto& node = self->node->children[index];
+    if (node.type != PROPERTY_VALUE)
+        return PyPlotProperties_child(self, index);
+
+    if (!PyPlotProperties_checkPlotID(self))
+        return NULL;
+    return PyPlotProperties_getValue(self->mState, self->plotID, node);
+}
+
+
+static int
+PyPlotProperties_setattro(PyPlotProperties* self, PyObject* name, PyObject* value)
+{
+    auto index = PyPlotProperties_childIndex(self, name);
+    if (index < 0) {
+        if (PyUnicode_Check(name) && PyUnicode_GET_LENGTH(name) > 0 && PyUnicode_READ_CHAR(name, 0) != '_') {
+            if (self->node->path[0] == '\0')
+                PyErr_Format(PyExc_AttributeError, "unknown plot property '%U'", name);
+            else
+                PyErr_Format(PyExc_AttributeError, "unknown plot property '%s.%U'", self->node->path, name);
+            return -1;
+        }
+        return PyObject_GenericSetAttr(reinterpret_cast<PyObject*>(self), name, value);
+    }
+
+    const auto& node = self->node->children[index];
+    if (value == NULL) {
+        PyErr_Format(PyExc_AttributeError, "cannot delete plot property '%s'", node.path);
+        return -1;
+    }
+    if (!PyPlotProperties_checkPlotID(self))
+        return -1;
+
+    switch (node.type) {
+    case PROPERTY_VALUE: return PyPlotProperties_setValue(self->mState, self->plotID, node, value);
+    case PROPERTY_GROUP: return PyPlotProperties_setGroup(self->mState, self->plotID, node, value);
+    default:
+        PyErr_Format(PyExc_AttributeError, "plot property '%s' cannot be set", node.path);
+        return -1;
+    }
+}
+
+
+static PyObject*
+PyPlotProperties_repr(PyPlotProperties* self)
+{
+    const auto& node = *self->node;
+    if (node.type != PROPERTY_GROUP) {
+        if (node.path[0] == '\0')
+            return PyUnicode_FromFormat("<%s %ld>", Py_TYPE(self)->tp_name, self->plotID);
+        return PyUnicode_FromFormat("<%s '%s' of plot %ld>", Py_TYPE(self)->tp_name, node.path, self->plotID);
+    }
+
+    // a group is represented by the tuple of its values
+    if (!PyPlotProperties_checkPlotID(self))
+        return NULL;
+
+    auto pyOwned_values = PyTuple_New(static_cast<Py_ssize_t>(node.childCount));
+    if (pyOwned_values == NULL) return NULL;
+    for (std::size_t i = 0; i < node.childCount; ++i) {
+        auto pyOwned_value = PyPlotProperties_getValue(self->mState, self->plotID, node.children[i]);
+        if (pyOwned_value == NULL) {
+            Py_DECREF(pyOwned_values);
+            return NULL;
+        }
+        PyTuple_SET_ITEM(pyOwned_values, i, pyOwned_value);
+    }
+    auto pyOwned_repr = PyObject_Repr(pyOwned_values);
+    Py_DECREF(pyOwned_values);
+    return pyOwned_repr;
+}
+
+
+/**
+ * @brief `_PlotProperties.show`: show the plot type of a plot type's properties (e.g.
+ * `plot[1].color_map.show()`)
+ * 
+ * @param self 
+ * @param args 
+ * @return PyObject* 
+ */
+static PyObject*
+exa_PlotProperties_show(PyPlotProperties* self, PyObject* Py_UNUSED(args))
+{
+    if (self->node->type != PROPERTY_TAB) {
+        PyErr_SetString(PyExc_TypeError, "show() requires a plot type's properties (e.g. 'color_map')");
+        return NULL;
+    }
+    if (!PyPlotProperties_checkPlotID(self))
+        return NULL;
+    return self->mState->iface->showPlot(self->plotID, static_cast<std::size_t>(self->node->plotType));
+}
+
+
+static int
+PyPlotProperties_clear(PyPlotProperties* self)
+{
+    for (auto& child : self->children)
+        Py_CLEAR(child);
+    return 0;
+}
+
+
+static void
+PyPlotProperties_dealloc(PyPlotProperties* self)
+{
+    PyObject_GC_UnTrack(self);
+    PyPlotProperties_clear(self);
+    auto tp = Py_TYPE(self);
+    tp->tp_free(self);
+    Py_DECREF(tp);
+}
+
+
+static int
+PyPlotProperties_traverse(PyPlotProperties* self, visitproc visit, void* arg)
+{
+    for (auto child : self->children)
+        Py_VISIT(child);
+    Py_VISIT(Py_TYPE(self));
+    return 0;
+}
+
+
+static PyMethodDef
+PyPlotProperties_methods[] =
+{
+    {"show", (PyCFunction)exa_PlotProperties_show, METH_NOARGS, NULL},
+    {NULL, NULL}
+};
+
+
+static PyMemberDef
+PyPlotProperties_members[] =
+{
+    {"_n", Py_T_LONG, offsetof(PyPlotProperties, plotID), Py_READONLY, NULL},
+    {NULL}
+};
+
+
+static PyType_Slot
+PyPlotProperties_slots[] =
+{
+    {Py_tp_new, (void*)PyPlotProperties_new},
+    {Py_tp_getattro, (void*)PyPlotProperties_getattro},
+    {Py_tp_setattro, (void*)PyPlotProperties_setattro},
+    {Py_tp_repr, (void*)PyPlotProperties_repr},
+    {Py_tp_methods, (void*)PyPlotProperties_methods},
+    {Py_tp_members, (void*)PyPlotProperties_members},
+    {Py_tp_dealloc, (void*)PyPlotProperties_dealloc},
+    {Py_tp_traverse, (void*)PyPlotProperties_traverse},
+    {Py_tp_clear, (void*)PyPlotProperties_clear},
+    {0, NULL}
+};
+
+
+static PyType_Spec
+PyPlotProperties_spec =
+{
+    .name = EXA_MODULE "." EXA_PROPERTIES,
+    .basicsize = sizeof(PyPlotProperties),
+    .flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_IMMUTABLETYPE,
+    .slots = PyPlotProperties_slots,
+};
+
+
+/**
+ * PlotProperties implementation end
+ */
+
+
 int
 moduleSlot_initTypes(PyObject* module)
 {
@@ -903,6 +2415,13 @@ moduleSlot_initTypes(PyObject* module)
 
     if (PyModule_AddType(module, mState->type_RunParam)) return -1;
 
+    mState->type_PlotProperties = reinterpret_cast<PyTypeObject*>(
+        PyType_FromModuleAndSpec(module, &PyPlotProperties_spec, NULL)
+    );
+    if (mState->type_PlotProperties == NULL) return -1;
+
+    if (PyModule_AddType(module, mState->type_PlotProperties)) return -1;
+
     return 0;
 }
 
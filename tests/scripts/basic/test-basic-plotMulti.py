@@ -0,0 +1,5 @@
+import exaplot
+
+
+exaplot.plot[2](0, 1, 2)
+exaplot.plot[2]([0, 1, 2], [1, 2, 3], [4, 5, 6])
@@ -1,4 +1,11 @@
+import ctypes
 import exaplot
+from array import array
 
 
 exaplot.plot[2]([0, 1, 2, 3], [1, 2, 3.3, 4.4])
+exaplot.plot[2](array("i", [0, 1, 2, 3]), array("d", [1, 2, 3.3, 4.4]))
+# strided, and not in native format ("<d"), which is read as a sequence
+exaplot.plot[2](memoryview(array("d", [0, -1, 1, -1, 2, -1, 3, -1]))[::2], (ctypes.c_double * 4)(1, 2, 3.3, 4.4))
+# converted with the GIL released
+exaplot.plot[2](array("d", range(1 << 15)), array("q", range(0, -2 << 15, -2)))
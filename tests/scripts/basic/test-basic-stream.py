@@ -0,0 +1,4 @@
+import exaplot
+
+
+exaplot.plot[2].stream([1, 2, 3], 0.5, 0.25)
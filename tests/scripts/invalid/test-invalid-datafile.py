@@ -15,3 +15,78 @@ try:
     datafile(path="/")
 except TypeError as e:
     assert(str(e) == "'path' argument must be type 'PathLike' or 'Callable'")
+
+try:
+    datafile(dtype="float16")
+except ValueError as e:
+    assert(str(e) == "datafile() invalid 'dtype': 'float16'")
+
+try:
+    datafile(dtype={0: "int16"})
+except ValueError as e:
+    assert(str(e) == "datafile() 'dtype' plot IDs must be greater than zero")
+
+try:
+    datafile(dtype={1: 16})
+except TypeError as e:
+    assert(str(e) == "datafile() 'dtype' values must be type 'str'")
+
+try:
+    datafile(compression=10)
+except ValueError as e:
+    assert(str(e) == "datafile() 'compression' must be from 0 to 9")
+
+try:
+    datafile(compression_workers=-1)
+except ValueError as e:
+    assert(str(e) == "datafile() 'compression_workers' must not be negative")
+
+try:
+    datafile(format="csv")
+except ValueError as e:
+    assert(str(e) == "datafile() invalid 'format': 'csv'")
+
+try:
+    datafile(segment_bytes=-1)
+except ValueError as e:
+    assert(str(e) == "datafile() 'segment_bytes' must not be negative")
+
+try:
+    datafile(segment_duration=-1)
+except ValueError as e:
+    assert(str(e) == "datafile() 'segment_duration' must not be negative")
+
+try:
+    datafile(summary=1)
+except ValueError as e:
+    assert(str(e) == "datafile() 'summary' must be 0 or at least 2")
+
+try:
+    datafile(flush_age=float("inf"))
+except ValueError as e:
+    assert(str(e) == "datafile() 'flush_age' must be finite")
+
+try:
+    datafile(flush_age=float("nan"))
+except ValueError as e:
+    assert(str(e) == "datafile() 'flush_age' must be finite")
+
+try:
+    datafile(flush_age=1e300)
+except ValueError as e:
+    assert(str(e) == "datafile() 'flush_age' is too large")
+
+try:
+    datafile(segment_duration=float("inf"))
+except ValueError as e:
+    assert(str(e) == "datafile() 'segment_duration' must be finite")
+
+try:
+    datafile(segment_duration=float("nan"))
+except ValueError as e:
+    assert(str(e) == "datafile() 'segment_duration' must be finite")
+
+try:
+    datafile(segment_duration=1e300)
+except ValueError as e:
+    assert(str(e) == "datafile() 'segment_duration' is too large")
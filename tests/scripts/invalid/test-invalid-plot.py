@@ -1,4 +1,4 @@
-from exaplot import _plot, plot
+from exaplot import _plot, channel, plot, record, record_many
 
 
 try:
@@ -21,6 +21,11 @@ try:
 except TypeError as e:
     assert(str(e) == "plot() 'write' argument must be type 'bool'")
 
+try:
+    _plot(1, sorted=None)
+except TypeError as e:
+    assert(str(e) == "plot() 'sorted' argument must be type 'bool'")
+
 try:
     _plot(1, "")
 except TypeError as e:
@@ -32,9 +37,9 @@ except TypeError as e:
     assert(str(e) == "plot() takes 2 positional arguments but 1 were given")
 
 try:
-    plot[1](0, 0, 0)
+    plot[1](0, 0, [0])
 except TypeError as e:
-    assert(str(e) == "plot() takes 2 positional arguments but 3 were given")
+    assert(str(e) == "must be real number, not list")
 
 try:
     _plot(1, 1, "")
@@ -52,9 +57,14 @@ except TypeError as e:
     assert(str(e) == "plot() takes 2 positional arguments but 1 were given")
 
 try:
-    plot[1]([0], [0], [0])
+    plot[1]([0], [0], 0)
 except TypeError as e:
-    assert(str(e) == "plot() takes 2 positional arguments but 3 were given")
+    assert(str(e) == "plot() 'y1' argument must be type 'Sequence'")
+
+try:
+    plot[1]([0], [0], [0, 1])
+except ValueError as e:
+    assert(str(e) == "plot() 'y1' argument must be the same length as 'x'")
 
 try:
     plot[1]([0], 0)
@@ -65,3 +75,88 @@ try:
     plot[1]([0], [""])
 except TypeError as e:
     assert(str(e) == "must be real number, not str")
+
+try:
+    plot[1].stream(0)
+except TypeError as e:
+    assert(str(e) == "_stream() 'y' argument must be type 'Sequence'")
+
+try:
+    plot[1].stream([0], 0, 0)
+except ValueError as e:
+    assert(str(e) == "_stream() 'dx' argument must be greater than zero")
+
+try:
+    plot[1].stream([""])
+except TypeError as e:
+    assert(str(e) == "must be real number, not str")
+
+try:
+    plot[0].set(title="")
+except AttributeError as e:
+    assert(str(e) == "'Channel' object has no attribute 'set'")
+
+try:
+    plot[0](1)
+except TypeError as e:
+    assert(str(e) == "_write() takes at least 2 data arguments but 1 were given")
+
+try:
+    plot[0].stream([0], 0, -1)
+except ValueError as e:
+    assert(str(e) == "_write_stream() 'dx' argument must be greater than zero")
+
+try:
+    channel("")
+except ValueError as e:
+    assert(str(e) == "_channel() 'name' argument must not be empty")
+
+try:
+    channel("raw/0")
+except ValueError as e:
+    assert(str(e) == "_channel() 'name' argument may only contain letters, digits, '_' and '-'")
+
+try:
+    channel("dataset1")
+except ValueError as e:
+    assert(str(e) == "_channel() channel names starting with 'dataset' are reserved")
+
+try:
+    plot[1].set(two_dimen__z_range=(0, 1))
+except AttributeError as e:
+    assert(str(e) == "unknown plot property 'two_dimen.z_range'")
+
+try:
+    plot[1].two_dimen.x_range = 1
+except TypeError as e:
+    assert(str(e) == "two_dimen.x_range value must be type 'tuple[int, int]'")
+
+try:
+    plot[1].title = 1
+except TypeError as e:
+    assert(str(e) == "title must be type 'str'")
+
+try:
+    plot[1].two_dimen = None
+except AttributeError as e:
+    assert(str(e) == "plot property 'two_dimen' cannot be set")
+
+try:
+    record("")
+except ValueError as e:
+    assert(str(e) == "record() 'table' argument must be a non-empty name of letters, digits, '_' and '-'")
+
+try:
+    record("log")
+except TypeError as e:
+    assert(str(e) == "record() requires at least one column")
+
+try:
+    record_many("log", ok=[True, 1])
+except TypeError as e:
+    assert(str(e) == "record_many() column 'ok' values must be type 'bool'")
+
+try:
+    record_many("log", a=[1], b=[1, 2])
+except ValueError as e:
+    assert(str(e) == "record_many() columns must be the same length")
@@ -20,6 +20,8 @@ public:
     void datafile(const exa::DatafileConfig& config, PyObject* path, bool prompt) override;
     void plot2D(std::size_t plotID, double x, double y, bool write) override;
     void plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y) override;
+    void plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y) override;
+    void plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx) override;
     void clear(std::size_t plotID) override;
 protected:
     BasicTest() { this->scriptsDir = this->scriptsDir / "basic"; }
@@ -102,6 +104,7 @@ void
 BasicTest::datafile(const exa::DatafileConfig& config, PyObject* path, bool prompt)
 {
     ASSERT_TRUE(config.enable && *config.enable);
+    ASSERT_FALSE(config.swmr);
     ASSERT_FALSE(prompt);
     ASSERT_EQ(path, nullptr);
 }
@@ -124,7 +127,8 @@ BasicTest::plot2D(std::size_t plotID, double x, double y, bool write)
 }
 
 
-// plotVec(2, [0, 1, 2, 3], [1, 2, 3.3, 4.4])
+// plotVec(2, [0, 1, 2, 3], [1, 2, 3.3, 4.4]) (as lists and as buffers)
+// plotVec(2, [0, 1, ..., 32767], [0, -2, ..., -65534]) (as buffers)
 
 TEST_F(BasicTest, TestPlotVec)
 {
@@ -135,6 +139,14 @@ void
 BasicTest::plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y)
 {
     ASSERT_EQ(plotID, 2);
+    if (x.size() == 1 << 15) {
+        ASSERT_EQ(y.size(), x.size());
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            ASSERT_EQ(x[i], i);
+            ASSERT_EQ(y[i], -2. * i);
+        }
+        return;
+    }
     std::vector<double> expected_x{0, 1, 2, 3};
     ASSERT_EQ(x, expected_x);
     std::vector<double> expected_y{1, 2, 3.3, 4.4};
@@ -142,6 +154,49 @@ BasicTest::plot2DVec(std::size_t plotID, const std::vector<double>& x, const std
 }
 
 
+// plot(2, 0, 1, 2) / plot(2, [0, 1, 2], [1, 2, 3], [4, 5, 6])
+
+TEST_F(BasicTest, TestPlotMulti)
+{
+    this->run("test-basic-plotMulti.py");
+}
+
+void
+BasicTest::plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y)
+{
+    ASSERT_EQ(plotID, 2);
+    if (x.size() == 1) {
+        std::vector<double> expected_x{0};
+        ASSERT_EQ(x, expected_x);
+        std::vector<std::vector<double>> expected_y{{1}, {2}};
+        ASSERT_EQ(y, expected_y);
+    } else {
+        std::vector<double> expected_x{0, 1, 2};
+        ASSERT_EQ(x, expected_x);
+        std::vector<std::vector<double>> expected_y{{1, 2, 3}, {4, 5, 6}};
+        ASSERT_EQ(y, expected_y);
+    }
+}
+
+
+// plot[2].stream([1, 2, 3], 0.5, 0.25)
+
+TEST_F(BasicTest, TestStream)
+{
+    this->run("test-basic-stream.py");
+}
+
+void
+BasicTest::plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx)
+{
+    ASSERT_EQ(plotID, 2);
+    std::vector<double> expected_y{1, 2, 3};
+    ASSERT_EQ(y, expected_y);
+    ASSERT_EQ(x0, 0.5);
+    ASSERT_EQ(dx, 0.25);
+}
+
+
 // plot(3)
 
 TEST_F(BasicTest, TestClear)
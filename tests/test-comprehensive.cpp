@@ -20,6 +20,8 @@ public:
     void datafile(const exa::DatafileConfig& config, PyObject* path, bool prompt) override {}
     void plot2D(std::size_t plotID, double x, double y, bool write) override;
     void plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y) override {};
+    void plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y) override {};
+    void plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx) override {};
     void clear(std::size_t plotID) override {};
 protected:
     ComprehensiveTest() { this->scriptsDir = this->scriptsDir / "comprehensive"; }
@@ -20,6 +20,8 @@ public:
     void datafile(const exa::DatafileConfig& config, PyObject* path, bool prompt) override;
     void plot2D(std::size_t, double, double, bool) override;
     void plot2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&) override;
+    void plot2DMulti(std::size_t, const std::vector<double>&, const std::vector<std::vector<double>>&) override;
+    void plot2DStream(std::size_t, const std::vector<double>&, double, double) override;
     void clear(std::size_t) override;
 protected:
     InvalidTest() { this->scriptsDir = this->scriptsDir / "invalid"; }
@@ -93,6 +95,25 @@ InvalidTest::plot2DVec(
     ASSERT_FALSE(true);
 }
 
+void
+InvalidTest::plot2DMulti(
+    [[maybe_unused]] std::size_t plotID,
+    [[maybe_unused]] const std::vector<double>& x,
+    [[maybe_unused]] const std::vector<std::vector<double>>& y)
+{
+    ASSERT_FALSE(true);
+}
+
+void
+InvalidTest::plot2DStream(
+    [[maybe_unused]] std::size_t plotID,
+    [[maybe_unused]] const std::vector<double>& y,
+    [[maybe_unused]] double x0,
+    [[maybe_unused]] double dx)
+{
+    ASSERT_FALSE(true);
+}
+
 void
 InvalidTest::clear([[maybe_unused]] std::size_t plotID)
 {
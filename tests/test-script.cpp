@@ -23,15 +23,27 @@ protected:
         PyObject* stop() override { Py_RETURN_NONE; }
         PyObject* msg(const std::string&, bool) override { Py_RETURN_NONE; }
         PyObject* datafile(const exa::DatafileConfig&, PyObject*, bool) override { Py_RETURN_NONE; }
+        PyObject* rotateDatafile() override { Py_RETURN_NONE; }
         PyObject* plot2D(std::size_t, double, double, bool) override { Py_RETURN_NONE; }
-        PyObject* plot2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
+        PyObject* plot2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&, bool, bool) override { Py_RETURN_NONE; }
+        PyObject* plot2DMulti(std::size_t, const std::vector<double>&, const std::vector<std::vector<double>>&, bool, bool) override { Py_RETURN_NONE; }
+        PyObject* plot2DStream(std::size_t, const std::vector<double>&, double, double, bool) override { Py_RETURN_NONE; }
         PyObject* plotCM(std::size_t, int, int, double, bool) override { Py_RETURN_NONE; }
         PyObject* plotCMVec(std::size_t, int, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
         PyObject* plotCMFrame(std::size_t, const std::vector<std::vector<double>>&, bool) override { Py_RETURN_NONE; }
+        PyObject* plotCMPush(std::size_t, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
+        PyObject* channel(const std::string&) override { return PyLong_FromLong(1); }
+        PyObject* write2D(std::size_t, double, double) override { Py_RETURN_NONE; }
+        PyObject* write2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&) override { Py_RETURN_NONE; }
+        PyObject* write2DMulti(std::size_t, const std::vector<double>&, const std::vector<std::vector<double>>&) override { Py_RETURN_NONE; }
+        PyObject* write2DStream(std::size_t, const std::vector<double>&, double, double) override { Py_RETURN_NONE; }
+        PyObject* record(const std::string&, const std::vector<exa::RecordColumn>&) override { Py_RETURN_NONE; }
         PyObject* clear(std::size_t) override { Py_RETURN_NONE; }
         PyObject* setPlotProperty(std::size_t, const exa::PlotProperty&, const exa::PlotProperty::Value& value) override { Py_RETURN_NONE; }
         PyObject* getPlotProperty(std::size_t, const exa::PlotProperty&) override { Py_RETURN_NONE; }
         PyObject* showPlot(std::size_t, std::size_t) override { Py_RETURN_NONE; }
+        PyObject* beginPlotEdit(std::size_t) override { Py_RETURN_NONE; }
+        PyObject* endPlotEdit(std::size_t) override { Py_RETURN_NONE; }
         Py_ssize_t currentPlotType(std::size_t) override { return 0; }
 
     private:
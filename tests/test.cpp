@@ -101,13 +101,29 @@ ModuleTest::Interface::plot2D(std::size_t plotID, double x, double y, bool write
 
 
 PyObject*
-ModuleTest::Interface::plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write)
+ModuleTest::Interface::plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y, bool write, bool sorted)
 {
     this->m_tester->plot2DVec(plotID, x, y);
     Py_RETURN_NONE;
 }
 
 
+PyObject*
+ModuleTest::Interface::plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y, bool write, bool sorted)
+{
+    this->m_tester->plot2DMulti(plotID, x, y);
+    Py_RETURN_NONE;
+}
+
+
+PyObject*
+ModuleTest::Interface::plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx, bool write)
+{
+    this->m_tester->plot2DStream(plotID, y, x0, dx);
+    Py_RETURN_NONE;
+}
+
+
 PyObject*
 ModuleTest::Interface::clear(std::size_t plotID)
 {
@@ -126,15 +142,27 @@ protected:
         PyObject* stop() override { Py_RETURN_NONE; }
         PyObject* msg(const std::string&, bool) override { Py_RETURN_NONE; }
         PyObject* datafile(const exa::DatafileConfig&, PyObject*, bool) override { Py_RETURN_NONE; }
+        PyObject* rotateDatafile() override { Py_RETURN_NONE; }
         PyObject* plot2D(std::size_t, double, double, bool) override { Py_RETURN_NONE; }
-        PyObject* plot2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
+        PyObject* plot2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&, bool, bool) override { Py_RETURN_NONE; }
+        PyObject* plot2DMulti(std::size_t, const std::vector<double>&, const std::vector<std::vector<double>>&, bool, bool) override { Py_RETURN_NONE; }
+        PyObject* plot2DStream(std::size_t, const std::vector<double>&, double, double, bool) override { Py_RETURN_NONE; }
         PyObject* plotCM(std::size_t, int, int, double, bool) override { Py_RETURN_NONE; }
         PyObject* plotCMVec(std::size_t, int, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
         PyObject* plotCMFrame(std::size_t, const std::vector<std::vector<double>>&, bool) override { Py_RETURN_NONE; }
+        PyObject* plotCMPush(std::size_t, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
+        PyObject* channel(const std::string&) override { return PyLong_FromLong(1); }
+        PyObject* write2D(std::size_t, double, double) override { Py_RETURN_NONE; }
+        PyObject* write2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&) override { Py_RETURN_NONE; }
+        PyObject* write2DMulti(std::size_t, const std::vector<double>&, const std::vector<std::vector<double>>&) override { Py_RETURN_NONE; }
+        PyObject* write2DStream(std::size_t, const std::vector<double>&, double, double) override { Py_RETURN_NONE; }
+        PyObject* record(const std::string&, const std::vector<exa::RecordColumn>&) override { Py_RETURN_NONE; }
         PyObject* clear(std::size_t) override { Py_RETURN_NONE; }
         PyObject* setPlotProperty(std::size_t, const exa::PlotProperty&, const exa::PlotProperty::Value&) override { Py_RETURN_NONE; }
         PyObject* getPlotProperty(std::size_t, const exa::PlotProperty&) override { Py_RETURN_NONE; }
         PyObject* showPlot(std::size_t, std::size_t) override { Py_RETURN_NONE; }
+        PyObject* beginPlotEdit(std::size_t) override { Py_RETURN_NONE; }
+        PyObject* endPlotEdit(std::size_t) override { Py_RETURN_NONE; }
         Py_ssize_t currentPlotType(std::size_t) override { return 0; }
 
     private:
@@ -25,6 +25,8 @@ public:
     virtual void datafile(const exa::DatafileConfig& config, PyObject* path, bool prompt) = 0;
     virtual void plot2D(std::size_t plotID, double x, double y, bool write) = 0;
     virtual void plot2DVec(std::size_t plotID, const std::vector<double>& x, const std::vector<double>& y) = 0;
+    virtual void plot2DMulti(std::size_t plotID, const std::vector<double>& x, const std::vector<std::vector<double>>& y) = 0;
+    virtual void plot2DStream(std::size_t plotID, const std::vector<double>& y, double x0, double dx) = 0;
     virtual void clear(std::size_t plotID) = 0;
 
 private:
@@ -36,15 +38,27 @@ private:
         PyObject* stop() override { Py_RETURN_NONE; }
         PyObject* msg(const std::string&, bool) override;
         PyObject* datafile(const exa::DatafileConfig&, PyObject*, bool) override;
+        PyObject* rotateDatafile() override { Py_RETURN_NONE; }
         PyObject* plot2D(std::size_t, double, double, bool) override;
-        PyObject* plot2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&, bool) override;
+        PyObject* plot2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&, bool, bool) override;
+        PyObject* plot2DMulti(std::size_t, const std::vector<double>&, const std::vector<std::vector<double>>&, bool, bool) override;
+        PyObject* plot2DStream(std::size_t, const std::vector<double>&, double, double, bool) override;
         PyObject* plotCM(std::size_t, int, int, double, bool) override { Py_RETURN_NONE; }
         PyObject* plotCMVec(std::size_t, int, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
         PyObject* plotCMFrame(std::size_t, const std::vector<std::vector<double>>&, bool) override { Py_RETURN_NONE; }
+        PyObject* plotCMPush(std::size_t, const std::vector<double>&, bool) override { Py_RETURN_NONE; }
+        PyObject* channel(const std::string&) override { return PyLong_FromLong(1); }
+        PyObject* write2D(std::size_t, double, double) override { Py_RETURN_NONE; }
+        PyObject* write2DVec(std::size_t, const std::vector<double>&, const std::vector<double>&) override { Py_RETURN_NONE; }
+        PyObject* write2DMulti(std::size_t, const std::vector<double>&, const std::vector<std::vector<double>>&) override { Py_RETURN_NONE; }
+        PyObject* write2DStream(std::size_t, const std::vector<double>&, double, double) override { Py_RETURN_NONE; }
+        PyObject* record(const std::string&, const std::vector<exa::RecordColumn>&) override { Py_RETURN_NONE; }
         PyObject* clear(std::size_t) override;
         PyObject* setPlotProperty(std::size_t, const exa::PlotProperty&, const exa::PlotProperty::Value&) override { Py_RETURN_NONE; }
         PyObject* getPlotProperty(std::size_t, const exa::PlotProperty&) override { Py_RETURN_NONE; }
         PyObject* showPlot(std::size_t, std::size_t) override { Py_RETURN_NONE; }
+        PyObject* beginPlotEdit(std::size_t) override { Py_RETURN_NONE; }
+        PyObject* endPlotEdit(std::size_t) override { Py_RETURN_NONE; }
         Py_ssize_t currentPlotType(std::size_t) override { return 0; }
 
     private: